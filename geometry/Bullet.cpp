@@ -1,32 +1,38 @@
 #include "geometry/Bullet.h"
 #include "util/VisibleRect.h"
 #include "resource/Resources.h"
+#include "geometry/CollisionFilter.h"
 
 USING_NS_CC;
 
 #define BULLET_TAG 0x1000
+#define BULLET_RADIUS 12.0f
+#define BULLET_POOL_CAPACITY 64	// bullets flying at once
+#define DUSTY_POOL_CAPACITY 16	// dusties fading at once
 
 BulletManager::BulletManager() 
-:_velocity(Vec2(1000.0f, 0))
-, m_bulletCache(nullptr)
+:_activeCount(0)
+, _nextDusty(0)
+, _velocity(Vec2(1000.0f, 0))
+, _contactQueue(nullptr)
+, _contactSubscriber(0)
 {
 }
 
 BulletManager::~BulletManager()
 {
-	if (m_bulletCache)
+	// pooled sprites are children of batch nodes, only actions are owned here
+	for (auto action = _dustyActions.begin(); action != _dustyActions.end(); action++)
 	{
-		m_bulletCache->release();
-		m_bulletCache = nullptr;
+		(*action)->release();
 	}
+	_dustyActions.clear();
 }
 
 bool BulletManager::init()
 {
 	if (!Layer::init())return false;
 	_winSize = VisibleRect::size();
-	m_bulletCache = Array::create();
-	m_bulletCache->retain();
 
 	// create batch node for bullet and dusty sprites which appear many times
 	m_spriteBatchNode = CCSpriteBatchNode::create(RES_IMAGE(bullet.png));
@@ -35,6 +41,45 @@ bool BulletManager::init()
 	m_dustyBatchNode = CCSpriteBatchNode::create(RES_IMAGE(fire.png));
 	m_dustyBatchNode->setPosition(Vec2::ZERO);
 	this->addChild(m_dustyBatchNode);
+
+	// create bullet pool, bullets & their bodies are hidden and disabled until spawned,
+	// a disabled body is not in physics space, so it's never solved or hit
+	_bullets.reserve(BULLET_POOL_CAPACITY);
+	_xs.assign(BULLET_POOL_CAPACITY, 0);
+	_ys.assign(BULLET_POOL_CAPACITY, 0);
+	_vxs.assign(BULLET_POOL_CAPACITY, 0);
+	_vys.assign(BULLET_POOL_CAPACITY, 0);
+	for (int i = 0; i < BULLET_POOL_CAPACITY; i++)
+	{
+		Sprite* bullet = Sprite::createWithTexture(m_spriteBatchNode->getTexture());
+		bullet->setScale(0.4f);
+		bullet->setVisible(false);
+		PhysicsBody* physicsBody = PhysicsBody::createCircle(BULLET_RADIUS);
+		physicsBody->setMass(INFINITY);
+		physicsBody->setEnabled(false);
+		bullet->setPhysicsBody(physicsBody);
+		bullet->setTag(BULLET_TAG);
+		m_spriteBatchNode->addChild(bullet);
+		_bullets.push_back(bullet);
+	}
+
+	// create dusty pool, each dusty owns its fade action, which hides it when done
+	_dusties.reserve(DUSTY_POOL_CAPACITY);
+	_dustyActions.reserve(DUSTY_POOL_CAPACITY);
+	for (int i = 0; i < DUSTY_POOL_CAPACITY; i++)
+	{
+		Sprite* dusty = Sprite::createWithTexture(m_dustyBatchNode->getTexture());
+		dusty->setScale(0.4f);
+		dusty->setVisible(false);
+		m_dustyBatchNode->addChild(dusty);
+		_dusties.push_back(dusty);
+		auto actionFadeIn = FadeIn::create(0.2f);
+		auto actionFadeOut = FadeOut::create(0.4f);
+		auto actionDone = CallFuncN::create([](Node* node){ node->setVisible(false); });
+		Sequence* sequence = Sequence::create(actionFadeIn, actionFadeOut, actionDone, NULL);
+		sequence->retain();
+		_dustyActions.push_back(sequence);
+	}
 	schedule(schedule_selector(BulletManager::updateBulletMoving));
 
 	return true;
@@ -44,83 +89,169 @@ void BulletManager::onEnter()
 {
 	Layer::onEnter();
 
-	auto contactListener = EventListenerPhysicsContact::create();
-	contactListener->onContactBegin = CC_CALLBACK_1(BulletManager::onContactBegin, this);
-	_eventDispatcher->addEventListenerWithSceneGraphPriority(contactListener, this);
+	// only contacts of bullet layer are queued for bullets
+	if (_contactQueue)
+	{
+		auto filter = CollisionFilter::getInstance();
+		_contactSubscriber = _contactQueue->subscribe(CONTACT_EVENT_BEGIN, filter->getCategory(filter->getLayer(COLLISION_LAYER_BULLET)),
+			CC_CALLBACK_1(BulletManager::onContactBegin, this));
+	}
+}
+
+void BulletManager::onExit()
+{
+	if (_contactQueue && _contactSubscriber)_contactQueue->unsubscribe(_contactSubscriber);
+	_contactSubscriber = 0;
+
+	Layer::onExit();
 }
 
-bool BulletManager::onContactBegin(const PhysicsContact& contact)
+void BulletManager::onContactBegin(const ContactEvent& event)
 {
-	auto a = contact.getShapeA()->getBody()->getNode();
-	auto b = contact.getShapeB()->getBody()->getNode();
-	// if a is a bullet, spawn dusty and remove it
-	if (BULLET_TAG == a->getTag())
+	// if a is an active bullet of this manager, spawn dusty and deactivate it,
+	// a bullet hitting two sprites in one step is deactivated by the first contact
+	int index = findBullet(event.nodeA);
+	if (index >= 0)
 	{
-		spawnBulletDusty(a->getPosition());
-		a->removeFromParent();
-		m_bulletCache->removeObject(a);
+		spawnBulletDusty(Vec2(_xs[index], _ys[index]));
+		deactivateBullet(index);
 	}
-	// if b is a bullet, spawn dusty and remove it
-	if (BULLET_TAG == b->getTag())
+	// if b is an active bullet of this manager, spawn dusty and deactivate it
+	index = findBullet(event.nodeB);
+	if (index >= 0)
 	{
-		spawnBulletDusty(b->getPosition());
-		b->removeFromParent();
-		m_bulletCache->removeObject(b);
+		spawnBulletDusty(Vec2(_xs[index], _ys[index]));
+		deactivateBullet(index);
 	}
-	return true;
+}
+
+int BulletManager::findBullet(Node* node) const
+{
+	if (!node || BULLET_TAG != node->getTag())return -1;
+	// pool is small, a scan of active bullets is cheaper than keeping an index on each sprite
+	for (int i = 0; i < _activeCount; i++)
+	{
+		if (_bullets[i] == node)return i;
+	}
+	return -1;
+}
+
+void BulletManager::deactivateBullet(int index)
+{
+	Sprite* bullet = _bullets[index];
+	bullet->setVisible(false);
+	bullet->getPhysicsBody()->setEnabled(false);
+
+	// swap with last active bullet, order of bullets doesn't matter
+	int last = --_activeCount;
+	_bullets[index] = _bullets[last];
+	_bullets[last] = bullet;
+	_xs[index] = _xs[last];
+	_ys[index] = _ys[last];
+	_vxs[index] = _vxs[last];
+	_vys[index] = _vys[last];
 }
 
 void BulletManager::updateBulletMoving(float delta)
 {
 	Layer::update(delta);
-	for (int i = 0; i < m_bulletCache->count(); ++i) 
+	auto scene = this->getScene();
+	auto physicsWorld = scene ? scene->getPhysicsWorld() : nullptr;
+	// a deactivated bullet is replaced by the last one, so index only advances past a kept bullet
+	int i = 0;
+	while (i < _activeCount)
 	{
-		Sprite* bullet = (Sprite*)m_bulletCache->objectAtIndex(i);
-		Vec2 newLoc = bullet->getPosition() + _velocity * delta;
-		bullet->setPosition(newLoc);
+		Vec2 oldLoc(_xs[i], _ys[i]);
+		Vec2 newLoc(_xs[i] + _vxs[i] * delta, _ys[i] + _vys[i] * delta);
 
-		// remove bullet sprite when sprite is out of visible bounder
+		// bullet is moved, not simulated, a frame may carry it across a thin sprite,
+		// so the path to its front edge is swept, and it hits the nearest sprite on it
+		Vec2 hit;
+		if (physicsWorld && sweepBullet(physicsWorld, oldLoc, newLoc, hit))
+		{
+			spawnBulletDusty(hit);
+			deactivateBullet(i);
+			continue;
+		}
+
+		// deactivate bullet when it is out of visible bounder
 		if (newLoc.x >= _winSize.width
 			|| newLoc.x <= 0
 			|| newLoc.y >= _winSize.height
 			|| newLoc.y <= 0)
 		{
-			m_bulletCache->removeObjectAtIndex(i);
-			m_spriteBatchNode->removeChild(bullet, true);
+			deactivateBullet(i);
+			continue;
 		}
+		_xs[i] = newLoc.x;
+		_ys[i] = newLoc.y;
+		_bullets[i]->setPosition(newLoc);
+		i++;
 	}
 }
 
+bool BulletManager::sweepBullet(PhysicsWorld* physicsWorld, Vec2 from, Vec2 to, Vec2& hit)
+{
+	Vec2 direction = to - from;
+	if (direction.isZero())return false;
+	direction.normalize();
+	auto filter = CollisionFilter::getInstance();
+	unsigned int mask = filter->getMask(filter->getLayer(COLLISION_LAYER_BULLET));
+
+	// bullets are in batch node space, physics world is in scene space
+	Vec2 start = m_spriteBatchNode->convertToWorldSpace(from);
+	Vec2 end = m_spriteBatchNode->convertToWorldSpace(to + direction * BULLET_RADIUS);
+	float nearest = 2.0f;
+	physicsWorld->rayCast([&](PhysicsWorld& world, const PhysicsRayCastInfo& info, void* data)
+	{
+		// other bullets & layers bullets don't collide with are passed through, hits are not ordered,
+		// a sprite the bullet starts in is left to contact events
+		auto node = info.shape->getBody()->getNode();
+		if ((node && BULLET_TAG == node->getTag()) || !(info.shape->getCategoryBitmask() & mask) || info.fraction <= 0)return true;
+		if (info.fraction < nearest)
+		{
+			nearest = info.fraction;
+			hit = m_spriteBatchNode->convertToNodeSpace(info.contact);
+		}
+		return true;
+	}, start, end, nullptr);
+	return nearest <= 1.0f;
+}
+
 void BulletManager::spawnNewBullet(Vec2 spawnLocation)
 {
-	// spawn a bullet sprite
-	// and initialize properties
-	Sprite* newBullet = Sprite::createWithTexture(m_spriteBatchNode->getTexture());
-	newBullet->setScale(0.4f);
-	newBullet->setPosition(spawnLocation);
-#define BULLET_RADIUS 12.0f
-	PhysicsBody* physicsBody = PhysicsBody::createCircle(BULLET_RADIUS);
-	physicsBody->setMass(INFINITY);
-	// can notify onContact event when hit other sprites
-	physicsBody->setContactTestBitmask(0xFFFFFFFF);
-	newBullet->setPhysicsBody(physicsBody);
-	newBullet->setTag(BULLET_TAG);
-	m_spriteBatchNode->addChild(newBullet);
-	m_bulletCache->addObject(newBullet);
+	// take the first free bullet of pool, drop the shot if there is none
+	if (_activeCount >= (int)_bullets.size())return;
+	int index = _activeCount++;
+	_xs[index] = spawnLocation.x;
+	_ys[index] = spawnLocation.y;
+	_vxs[index] = _velocity.x;
+	_vys[index] = _velocity.y;
+
+	// show bullet and put its body back to physics space
+	Sprite* bullet = _bullets[index];
+	bullet->setPosition(spawnLocation);
+	bullet->setVisible(true);
+	PhysicsBody* physicsBody = bullet->getPhysicsBody();
+	physicsBody->setVelocity(Vec2::ZERO);
+	// can notify onContact event when hit other sprites,
+	// filter is applied on every spawn, layers may have changed since pool was created
+	auto filter = CollisionFilter::getInstance();
+	filter->apply(physicsBody, filter->getLayer(COLLISION_LAYER_BULLET));
+	physicsBody->setEnabled(true);
 }
 
 void BulletManager::spawnBulletDusty(Vec2 spawnLocation)
 {
-	// spawn a dusty sprite
-	// and initialize properties
-	Sprite* newDusty = Sprite::createWithTexture(m_dustyBatchNode->getTexture());
-	newDusty->setScale(0.4f);
-	newDusty->setPosition(spawnLocation);
-	m_dustyBatchNode->addChild(newDusty);
+	// take dusties in turn, the oldest one is restarted if it's still fading
+	if (_dusties.empty())return;
+	int index = _nextDusty;
+	_nextDusty = (_nextDusty + 1) % (int)_dusties.size();
+	Sprite* dusty = _dusties[index];
+	dusty->stopAllActions();
+	dusty->setPosition(spawnLocation);
+	dusty->setOpacity(255);
+	dusty->setVisible(true);
 	// play fade in & out animation
-	auto actionFadeIn = FadeIn::create(0.2f);
-	auto actionFadeOut = FadeOut::create(0.4f);
-	auto actionDone = CallFuncN::create([&](Node* node){node->removeFromParent(); });
-	Sequence* sequence = Sequence::create(actionFadeIn, actionFadeOut, actionDone, NULL);
-	newDusty->runAction(sequence);
+	dusty->runAction(_dustyActions[index]);
 }
\ No newline at end of file
@@ -2,10 +2,15 @@
 #define __BULLET_H__
 
 #include "cocos2d.h"
+#include "geometry/ContactEventQueue.h"
+#include <vector>
 
 /**
  * Bullet Manager
  * Spawn bullets, update bullets location in this layer
+ * Bullets come from a fixed pool, sprites & bodies are created once in init and recycled,
+ * so firing allocates nothing. Active bullets are packed at the front of the pool,
+ * locations & velocities are kept in parallel arrays, a removed bullet is swapped with the last one.
  * @see cocos2d::Layer
  */
 class BulletManager :public cocos2d::Layer
@@ -29,23 +34,39 @@ public:
 	 */
 	virtual void onEnter();
 
+	/**
+	 * Call when BulletManager exits the 'stage', override
+	 * @see cocos2d::Layer::onExit
+	 */
+	virtual void onExit();
+
+	/**
+	 * Set contact event queue of physics world, bullets hit nothing without it
+	 * Queue must outlive the 'stage' of BulletManager
+	 * @param contactQueue	contact event queue, drained once per physics step
+	 * @see ContactEventQueue
+	 */
+	void setContactQueue(ContactEventQueue* contactQueue)
+	{
+		this->_contactQueue = contactQueue;
+	}
+
 	/**
 	 * Event on Physics Contact Begin
-	 * Call when bullet hit other sprite
-	 * @param contact contact structure
-	 * @see cocos2d::PhysicsContact
-	 * @return true if called successful, false otherwise
+	 * Call when bullet hit other sprite, after physics step
+	 * @param event contact event of a bullet
+	 * @see ContactEventQueue
 	 */
-	bool onContactBegin(const cocos2d::PhysicsContact& contact);
+	void onContactBegin(const ContactEvent& event);
 
 	/**
-	 * Spawn new bullet
+	 * Spawn new bullet, the shot is dropped if every bullet of pool is flying
 	 * @param spawnLocation location to spawn a new bullet
 	 */
 	void spawnNewBullet(cocos2d::Vec2 spawnLocation);
 
 	/**
-	 * Spawn bullet dusty when bullet hit other sprite
+	 * Spawn bullet dusty when bullet hit other sprite, the oldest dusty is reused
 	 * @param spawnLocation location to spawn dusty
 	 */
 	void spawnBulletDusty(cocos2d::Vec2 spawnLocation);
@@ -57,17 +78,51 @@ public:
 	 */
 	void updateBulletMoving(float delta);
 
+	/**
+	 * Sweep a moving bullet against physics world, so a fast bullet can't skip a thin sprite between frames
+	 * @param physicsWorld	physics world of scene
+	 * @param from			bullet location before moving, in bullet space
+	 * @param to			bullet location after moving, in bullet space
+	 * @param hit			OUTPUT, nearest hit location, in bullet space
+	 * @return				true if bullet hits a sprite bullets collide with
+	 */
+	bool sweepBullet(cocos2d::PhysicsWorld* physicsWorld, cocos2d::Vec2 from, cocos2d::Vec2 to, cocos2d::Vec2& hit);
+
 	/**
 	 * Static factory function to create BulletManager
 	 * return BulletManager instance
 	 */
 	CREATE_FUNC(BulletManager);
 private:
-	cocos2d::Array*				m_bulletCache;		// Cache to store bullets
-	cocos2d::SpriteBatchNode*	m_spriteBatchNode;	// Batch node to generate renderable bullet sprite
-	cocos2d::SpriteBatchNode*	m_dustyBatchNode;	// Batch node to generate renderable dusty
-	cocos2d::Vec2				_velocity;			// Bullet moving velocity
-	cocos2d::Size				_winSize;			// Bullet layer size
+
+	/**
+	 * Get index of an active bullet
+	 * @param node	node of a contact
+	 * @return		index in active bullets, -1 if node is not an active bullet of this manager
+	 */
+	int findBullet(cocos2d::Node* node) const;
+
+	/**
+	 * Hide bullet & disable its body, last active bullet is swapped into its place
+	 * @param index	index in active bullets
+	 */
+	void deactivateBullet(int index);
+
+	std::vector<cocos2d::Sprite*>	_bullets;			// bullet pool, active bullets first
+	std::vector<float>				_xs;				// x of bullets, in bullet space
+	std::vector<float>				_ys;				// y of bullets, in bullet space
+	std::vector<float>				_vxs;				// x velocity of bullets
+	std::vector<float>				_vys;				// y velocity of bullets
+	int								_activeCount;		// the number of active bullets
+	std::vector<cocos2d::Sprite*>	_dusties;			// dusty pool
+	std::vector<cocos2d::Action*>	_dustyActions;		// fade action of each dusty, retained
+	int								_nextDusty;			// next dusty to spawn
+	cocos2d::SpriteBatchNode*		m_spriteBatchNode;	// Batch node to generate renderable bullet sprite
+	cocos2d::SpriteBatchNode*		m_dustyBatchNode;	// Batch node to generate renderable dusty
+	cocos2d::Vec2					_velocity;			// Bullet moving velocity
+	cocos2d::Size					_winSize;			// Bullet layer size
+	ContactEventQueue*				_contactQueue;		// contact events of physics world
+	int								_contactSubscriber;	// subscriber id in contact queue, 0 if not subscribed
 };
 
 #endif	/* __BULLET_H__ */
\ No newline at end of file
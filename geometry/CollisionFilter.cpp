@@ -0,0 +1,156 @@
+#include "CollisionFilter.h"
+#include "chipmunk/chipmunk.h"
+
+USING_NS_CC;
+using namespace std;
+
+namespace
+{
+	// cocos2d keeps chipmunk shapes of PhysicsShape protected, a derived class can name them
+	struct PhysicsShapeAccess : public PhysicsShape
+	{
+		static vector<cpShape*> PhysicsShape::* shapes()
+		{
+			return &PhysicsShapeAccess::_cpShapes;
+		}
+	};
+
+	// get chipmunk shapes of every shape of a body
+	vector<cpShape*> GetChipmunkShapes(PhysicsBody* body)
+	{
+		vector<cpShape*> result;
+		auto& shapes = body->getShapes();
+		for (auto s = shapes.begin(); s != shapes.end(); s++)
+		{
+			auto& cpShapes = (*s)->*PhysicsShapeAccess::shapes();
+			result.insert(result.end(), cpShapes.begin(), cpShapes.end());
+		}
+		return result;
+	}
+}
+
+CollisionFilter* CollisionFilter::getInstance()
+{
+	static CollisionFilter instance;
+	return &instance;
+}
+
+CollisionFilter::CollisionFilter()
+:_contactCategories(0)
+{
+	reset();
+}
+
+void CollisionFilter::reset()
+{
+	_names.clear();
+	_masks.clear();
+	addLayer(COLLISION_LAYER_BODY);
+	addLayer(COLLISION_LAYER_BULLET);
+	// bullets are the only built-in contact subscribers
+	_contactCategories = getCategory(getLayer(COLLISION_LAYER_BULLET));
+}
+
+int CollisionFilter::addLayer(const string& name)
+{
+	int layer = getLayer(name);
+	if (layer >= 0)return layer;
+	if ((int)_names.size() >= MAX_COLLISION_LAYERS)
+	{
+		cocos2d::log("ERROR: too many collision layers, '%s' is not added", name.c_str());
+		return -1;
+	}
+	layer = (int)_names.size();
+	_names.push_back(name);
+	_masks.push_back(0xFFFFFFFF);
+	return layer;
+}
+
+int CollisionFilter::getLayer(const string& name) const
+{
+	for (int i = 0; i < (int)_names.size(); i++)
+	{
+		if (_names[i] == name)return i;
+	}
+	return -1;
+}
+
+void CollisionFilter::setCollision(int a, int b, bool collide)
+{
+	if (collide)
+	{
+		_masks[a] |= getCategory(b);
+		_masks[b] |= getCategory(a);
+	}
+	else
+	{
+		_masks[a] &= ~getCategory(b);
+		_masks[b] &= ~getCategory(a);
+	}
+}
+
+void CollisionFilter::apply(PhysicsBody* body, int layer, int group) const
+{
+	// cocos2d checks bitmasks after narrowphase, they are kept the same as chipmunk filter
+	body->setCategoryBitmask(getCategory(layer));
+	body->setCollisionBitmask(getMask(layer));
+	body->setContactTestBitmask(getContactMask(layer));
+	// a negative cocos2d group never collides, and it resets chipmunk filter, so it's set first
+	body->setGroup(-group);
+	auto shapes = GetChipmunkShapes(body);
+	for (auto c = shapes.begin(); c != shapes.end(); c++)
+	{
+		cpShapeSetFilter(*c, cpShapeFilterNew(group ? (cpGroup)group : CP_NO_GROUP, getCategory(layer), getMask(layer)));
+	}
+}
+
+void CollisionFilter::applyGroup(PhysicsBody* body, int group) const
+{
+	// setting cocos2d group resets chipmunk filter to all categories, layer is read before
+	auto shapes = GetChipmunkShapes(body);
+	vector<cpShapeFilter> filters;
+	for (auto c = shapes.begin(); c != shapes.end(); c++)filters.push_back(cpShapeGetFilter(*c));
+	body->setGroup(-group);
+	for (size_t i = 0; i < shapes.size(); i++)
+	{
+		cpShapeSetFilter(shapes[i], cpShapeFilterNew(group ? (cpGroup)group : CP_NO_GROUP, filters[i].categories, filters[i].mask));
+	}
+}
+
+CollisionGroups::CollisionGroups(int count)
+:_parents(count)
+, _sizes(count, 1)
+{
+	for (int i = 0; i < count; i++)_parents[i] = i;
+}
+
+int CollisionGroups::find(int element)
+{
+	int root = element;
+	while (_parents[root] != root)root = _parents[root];
+	// path compression
+	while (_parents[element] != root)
+	{
+		int next = _parents[element];
+		_parents[element] = root;
+		element = next;
+	}
+	return root;
+}
+
+void CollisionGroups::unite(int a, int b)
+{
+	a = find(a);
+	b = find(b);
+	if (a == b)return;
+	// smaller set is attached to larger one
+	if (_sizes[a] < _sizes[b])swap(a, b);
+	_parents[b] = a;
+	_sizes[a] += _sizes[b];
+}
+
+int CollisionGroups::getGroup(int element)
+{
+	int root = find(element);
+	return _sizes[root] > 1 ? root + 1 : 0;
+}
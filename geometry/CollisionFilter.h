@@ -0,0 +1,173 @@
+#ifndef __COLLISION_FILTER_H__
+#define __COLLISION_FILTER_H__
+
+#include "cocos2d.h"
+#include <string>
+#include <vector>
+
+#define MAX_COLLISION_LAYERS 32		// one category bit per layer
+
+// built-in layers
+#define COLLISION_LAYER_BODY	"body"		// recognized physics bodies
+#define COLLISION_LAYER_BULLET	"bullet"	// bullets of weapons
+
+/**
+ * Collision Filter
+ * Named collision layers mapped onto chipmunk shape filters, each layer owns a category bit
+ * and pair rules decide which layers collide, all layers collide with each other by default.
+ * Shapes of the same group never collide, groups are used by jointed composites.
+ * Chipmunk rejects filtered pairs in broadphase before any narrowphase test, and the number
+ * of bodies is not limited, since bits are per layer instead of per body.
+ */
+class CollisionFilter
+{
+public:
+
+	/**
+	 * Get shared collision filter, used by physics body factories
+	 */
+	static CollisionFilter* getInstance();
+
+	// Constructor, only built-in layers are added
+	CollisionFilter();
+
+	/**
+	 * Remove all layers and rules but built-in layers
+	 */
+	void reset();
+
+	/**
+	 * Add a named layer, it collides with every layer
+	 * @param name	layer name
+	 * @return		layer index, index of existing layer with the same name, -1 if there are too many layers
+	 */
+	int addLayer(const std::string& name);
+
+	/**
+	 * Get layer index by name
+	 * @param name	layer name
+	 * @return		layer index, -1 if not found
+	 */
+	int getLayer(const std::string& name) const;
+
+	/**
+	 * Set pair rule, rule of (a, b) is the same as (b, a)
+	 * @param a			layer index
+	 * @param b			layer index
+	 * @param collide	true if shapes of both layers collide
+	 */
+	void setCollision(int a, int b, bool collide);
+
+	/**
+	 * Check pair rule
+	 * @param a	layer index
+	 * @param b	layer index
+	 */
+	bool canCollide(int a, int b) const
+	{
+		return (_masks[a] & getCategory(b)) != 0;
+	}
+
+	/**
+	 * Get category bit of layer
+	 * @param layer	layer index
+	 */
+	unsigned int getCategory(int layer) const
+	{
+		return 1u << layer;
+	}
+
+	/**
+	 * Get categories a layer collides with
+	 * @param layer	layer index
+	 */
+	unsigned int getMask(int layer) const
+	{
+		return _masks[layer];
+	}
+
+	/**
+	 * Add categories whose contacts are reported, e.g. categories of contact queue subscribers
+	 * Only bodies a filter is applied to afterwards get the new categories
+	 * @param categories	category bits
+	 */
+	void addContactCategories(unsigned int categories)
+	{
+		_contactCategories |= categories;
+	}
+
+	/**
+	 * Get categories a layer reports contacts with, cocos2d sends a contact only if both
+	 * shapes report each other, so pairs of unreported layers raise no events at all
+	 * @param layer	layer index
+	 */
+	unsigned int getContactMask(int layer) const
+	{
+		return (_contactCategories & getCategory(layer)) ? _masks[layer] : _masks[layer] & _contactCategories;
+	}
+
+	/**
+	 * Apply layer and group to every shape of a body, shapes must be added before
+	 * Both chipmunk shape filter and cocos2d bitmasks are set, contact events are sent for colliding pairs
+	 * with a reported category only
+	 * @param body	physics body
+	 * @param layer	layer index
+	 * @param group	group id, 0 for no group
+	 */
+	void apply(cocos2d::PhysicsBody* body, int layer, int group = 0) const;
+
+	/**
+	 * Apply group to every shape of a body, layer is kept
+	 * @param body	physics body
+	 * @param group	group id, 0 for no group
+	 */
+	void applyGroup(cocos2d::PhysicsBody* body, int group) const;
+
+private:
+	std::vector<std::string>	_names;		// layer names, by layer index
+	std::vector<unsigned int>	_masks;		// categories each layer collides with, by layer index
+	unsigned int				_contactCategories;	// categories whose contacts are reported
+};
+
+/**
+ * Collision Groups
+ * Disjoint sets of elements by union-find, with path compression and union by size,
+ * elements connected by joints end up in the same set.
+ */
+class CollisionGroups
+{
+public:
+
+	/**
+	 * Constructor
+	 * @param count	the number of elements, each in its own set
+	 */
+	CollisionGroups(int count);
+
+	/**
+	 * Find set of an element
+	 * @param element	element index
+	 * @return			root element of set
+	 */
+	int find(int element);
+
+	/**
+	 * Merge sets of two elements
+	 * @param a	element index
+	 * @param b	element index
+	 */
+	void unite(int a, int b);
+
+	/**
+	 * Get group id of an element
+	 * @param element	element index
+	 * @return			root element + 1, 0 if element is alone in its set
+	 */
+	int getGroup(int element);
+
+private:
+	std::vector<int>	_parents;	// parent element, root is parent of itself
+	std::vector<int>	_sizes;		// set size, valid on root
+};
+
+#endif	/* __COLLISION_FILTER_H__ */
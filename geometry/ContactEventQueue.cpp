@@ -0,0 +1,143 @@
+#include "ContactEventQueue.h"
+#include "geometry/CollisionFilter.h"
+#include <algorithm>
+
+USING_NS_CC;
+using namespace std;
+
+ContactEventQueue::ContactEventQueue()
+:_listener(nullptr)
+, _types(0)
+, _categories(0)
+, _nextId(1)
+, _draining(false)
+{
+}
+
+ContactEventQueue::~ContactEventQueue()
+{
+	clear();
+}
+
+void ContactEventQueue::listen(Node* target)
+{
+	// collisions are filtered by shape filters, listener never rejects a contact
+	_listener = EventListenerPhysicsContact::create();
+	_listener->onContactBegin = [this](PhysicsContact& contact)
+	{
+		push(CONTACT_EVENT_BEGIN, contact);
+		return true;
+	};
+	installCallbacks();
+	target->getEventDispatcher()->addEventListenerWithSceneGraphPriority(_listener, target);
+}
+
+void ContactEventQueue::installCallbacks()
+{
+	// presolve runs on every step of every reported contact, it's left out unless subscribed
+	if (!_listener)return;
+	if ((_types & CONTACT_EVENT_PRESOLVE) && !_listener->onContactPreSolve)
+	{
+		_listener->onContactPreSolve = [this](PhysicsContact& contact, PhysicsContactPreSolve& solve)
+		{
+			push(CONTACT_EVENT_PRESOLVE, contact);
+			return true;
+		};
+	}
+	if ((_types & CONTACT_EVENT_SEPARATE) && !_listener->onContactSeparate)
+	{
+		_listener->onContactSeparate = [this](PhysicsContact& contact)
+		{
+			push(CONTACT_EVENT_SEPARATE, contact);
+		};
+	}
+}
+
+int ContactEventQueue::subscribe(int types, unsigned int categories, const ContactEventCallback& callback)
+{
+	Subscriber s = { _nextId++, types, categories, callback };
+	// subscribers are not moved while their callbacks run
+	if (_draining)_added.push_back(s);
+	else _subscribers.push_back(s);
+	_types |= types;
+	_categories |= categories;
+	CollisionFilter::getInstance()->addContactCategories(categories);
+	installCallbacks();
+	return s.id;
+}
+
+void ContactEventQueue::unsubscribe(int id)
+{
+	_types = 0;
+	_categories = 0;
+	for (auto s = _subscribers.begin(); s != _subscribers.end(); s++)
+	{
+		if (s->id == id)s->id = 0;
+		if (s->id == 0)continue;
+		_types |= s->types;
+		_categories |= s->categories;
+	}
+	for (auto s = _added.begin(); s != _added.end(); s++)
+	{
+		if (s->id == id)s->id = 0;
+		if (s->id == 0)continue;
+		_types |= s->types;
+		_categories |= s->categories;
+	}
+	// removed subscribers are erased after draining, callbacks may be running
+	if (!_draining)_subscribers.erase(remove_if(_subscribers.begin(), _subscribers.end(), [](const Subscriber& s){ return s.id == 0; }), _subscribers.end());
+}
+
+void ContactEventQueue::push(int type, const PhysicsContact& contact)
+{
+	if (!(_types & type))return;
+	auto shapeA = contact.getShapeA();
+	auto shapeB = contact.getShapeB();
+	unsigned int categoryA = shapeA->getCategoryBitmask();
+	unsigned int categoryB = shapeB->getCategoryBitmask();
+	if (!((categoryA | categoryB) & _categories))return;
+
+	ContactEvent e;
+	e.type = type;
+	e.nodeA = shapeA->getBody()->getNode();
+	e.nodeB = shapeB->getBody()->getNode();
+	e.categoryA = categoryA;
+	e.categoryB = categoryB;
+	auto data = contact.getContactData();
+	e.point = type != CONTACT_EVENT_SEPARATE && data && data->count > 0 ? data->points[0] : Vec2::ZERO;
+	// nodes stay alive until drained
+	CC_SAFE_RETAIN(e.nodeA);
+	CC_SAFE_RETAIN(e.nodeB);
+	_events.push_back(e);
+}
+
+void ContactEventQueue::drain()
+{
+	if (_draining)return;
+	_draining = true;
+	for (auto e = _events.begin(); e != _events.end(); e++)
+	{
+		unsigned int categories = e->categoryA | e->categoryB;
+		for (auto s = _subscribers.begin(); s != _subscribers.end(); s++)
+		{
+			if (s->id && (s->types & e->type) && (s->categories & categories))s->callback(*e);
+		}
+	}
+	_draining = false;
+	clear();
+
+	// subscribers added by callbacks get events of the next step
+	_subscribers.insert(_subscribers.end(), _added.begin(), _added.end());
+	_added.clear();
+	_subscribers.erase(remove_if(_subscribers.begin(), _subscribers.end(), [](const Subscriber& s){ return s.id == 0; }), _subscribers.end());
+}
+
+void ContactEventQueue::clear()
+{
+	for (auto e = _events.begin(); e != _events.end(); e++)
+	{
+		CC_SAFE_RELEASE(e->nodeA);
+		CC_SAFE_RELEASE(e->nodeB);
+	}
+	_events.clear();
+}
@@ -0,0 +1,116 @@
+#ifndef __CONTACT_EVENT_QUEUE_H__
+#define __CONTACT_EVENT_QUEUE_H__
+
+#include "cocos2d.h"
+#include <functional>
+#include <vector>
+
+// contact event types, combined as a subscriber type mask
+#define CONTACT_EVENT_BEGIN		1	// shapes start touching
+#define CONTACT_EVENT_PRESOLVE	2	// shapes keep touching, every step
+#define CONTACT_EVENT_SEPARATE	4	// shapes stop touching
+
+/**
+ * Contact Event, a contact of one physics step
+ * Nodes are retained while queued, a node removed by an earlier subscriber has no parent,
+ * node is nullptr if its body was already taken off the node
+ */
+struct ContactEvent
+{
+	int					type;		// CONTACT_EVENT_*
+	cocos2d::Node*		nodeA;		// node of body A, may be nullptr
+	cocos2d::Node*		nodeB;		// node of body B, may be nullptr
+	unsigned int		categoryA;	// category bitmask of shape A
+	unsigned int		categoryB;	// category bitmask of shape B
+	cocos2d::Vec2		point;		// first contact point, zero if separated
+};
+
+typedef std::function<void(const ContactEvent&)> ContactEventCallback;
+
+/**
+ * Contact Event Queue
+ * A single contact listener accumulates events of a physics step into a flat array,
+ * only types & categories some subscriber wants are kept. Owner drains the queue once after
+ * every step, each event is passed only to subscribers whose masks match it, so cost is
+ * linear in relevant contacts instead of contacts x listeners. Callbacks run outside of
+ * physics step, so they are free to remove nodes and bodies.
+ * Categories of subscribers are reported by collision filter, and only callbacks of subscribed
+ * types are installed, so contacts nobody wants aren't dispatched at all.
+ */
+class ContactEventQueue
+{
+public:
+
+	// Constructor
+	ContactEventQueue();
+
+	// Destructor, queued nodes are released
+	~ContactEventQueue();
+
+	/**
+	 * Listen to contacts of physics world, the only contact listener needed
+	 * Begin events are always listened to, a contact listener needs at least one callback
+	 * @param target	node the listener is bound to, by scene graph priority
+	 */
+	void listen(cocos2d::Node* target);
+
+	/**
+	 * Add subscriber, categories are reported by collision filter from now on
+	 * @param types			event types, CONTACT_EVENT_* combined
+	 * @param categories	events with either shape in one of these categories are passed
+	 * @param callback		called once for each matching event when queue is drained
+	 * @return				subscriber id
+	 */
+	int subscribe(int types, unsigned int categories, const ContactEventCallback& callback);
+
+	/**
+	 * Remove subscriber, it's safe to call from a callback
+	 * @param id	subscriber id
+	 */
+	void unsubscribe(int id);
+
+	/**
+	 * Pass queued events to subscribers in a single pass, and clear queue
+	 */
+	void drain();
+
+	/**
+	 * Drop queued events without passing them, e.g. world is restored from a snapshot
+	 */
+	void clear();
+
+	/**
+	 * Get the number of queued events
+	 */
+	int size() const
+	{
+		return (int)_events.size();
+	}
+
+private:
+
+	// queue a contact if some subscriber wants it
+	void push(int type, const cocos2d::PhysicsContact& contact);
+
+	// install listener callbacks of subscribed types
+	void installCallbacks();
+
+	struct Subscriber
+	{
+		int						id;			// subscriber id, 0 if removed
+		int						types;		// event types
+		unsigned int			categories;	// categories of either shape
+		ContactEventCallback	callback;	// event callback
+	};
+
+	std::vector<ContactEvent>		_events;		// events of current step
+	std::vector<Subscriber>			_subscribers;	// subscribers, by subscribing order
+	std::vector<Subscriber>			_added;			// subscribers added while draining
+	cocos2d::EventListenerPhysicsContact*	_listener;	// contact listener, owned by event dispatcher, nullptr before listen
+	int								_types;			// types of all subscribers
+	unsigned int					_categories;	// categories of all subscribers
+	int								_nextId;		// id of next subscriber
+	bool							_draining;		// true while passing events
+};
+
+#endif	/* __CONTACT_EVENT_QUEUE_H__ */
@@ -0,0 +1,154 @@
+#include "GeometricDecomposition.h"
+
+using namespace std;
+
+// cross product of (b - a) and (c - b), positive if a, b, c turn anti-clockwise
+inline float Turn(const float* xy, int a, int b, int c)
+{
+	float abx = xy[b * 2] - xy[a * 2], aby = xy[b * 2 + 1] - xy[a * 2 + 1];
+	float bcx = xy[c * 2] - xy[b * 2], bcy = xy[c * 2 + 1] - xy[b * 2 + 1];
+	return abx*bcy - bcx*aby;
+}
+
+// cross product of (b - a) and (p - a), positive if p is left of a->b
+inline float Side(const float* xy, int a, int b, int p)
+{
+	float abx = xy[b * 2] - xy[a * 2], aby = xy[b * 2 + 1] - xy[a * 2 + 1];
+	float apx = xy[p * 2] - xy[a * 2], apy = xy[p * 2 + 1] - xy[a * 2 + 1];
+	return abx*apy - apx*aby;
+}
+
+inline bool SamePoint(const float* xy, int a, int b)
+{
+	return xy[a * 2] == xy[b * 2] && xy[a * 2 + 1] == xy[b * 2 + 1];
+}
+
+// check if point p is inside or on the border of anti-clockwise triangle a, b, c
+inline bool InTriangle(const float* xy, int p, int a, int b, int c)
+{
+	return Side(xy, a, b, p) >= 0 && Side(xy, b, c, p) >= 0 && Side(xy, c, a, p) >= 0;
+}
+
+bool TriangulatePolygonXY(const float* xy, int count, vector<int>& triangles)
+{
+	triangles.clear();
+	if (count < 3) return false;
+
+	// remaining polygon, as indices
+	vector<int> remain(count);
+	for (int i = 0; i < count; i++)remain[i] = i;
+
+	while (remain.size() > 3)
+	{
+		int n = remain.size();
+		bool clipped = false;
+		for (int i = 0; i < n; i++)
+		{
+			int ip = remain[(i + n - 1) % n], ic = remain[i], in = remain[(i + 1) % n];
+
+			// an ear must be a convex corner
+			if (Turn(xy, ip, ic, in) <= 0)continue;
+
+			// and no other point may lie inside the ear
+			bool isEar = true;
+			for (int j = 0; j < n && isEar; j++)
+			{
+				int k = remain[j];
+				if (k == ip || k == ic || k == in)continue;
+				if (SamePoint(xy, k, ip) || SamePoint(xy, k, ic) || SamePoint(xy, k, in))continue;
+				isEar = !InTriangle(xy, k, ip, ic, in);
+			}
+			if (!isEar)continue;
+
+			// clip ear
+			triangles.push_back(ip);
+			triangles.push_back(ic);
+			triangles.push_back(in);
+			remain.erase(remain.begin() + i);
+			clipped = true;
+			break;
+		}
+		if (!clipped)return false;
+	}
+	triangles.push_back(remain[0]);
+	triangles.push_back(remain[1]);
+	triangles.push_back(remain[2]);
+	return true;
+}
+
+// check if anti-clockwise piece is convex, collinear points are allowed
+static bool IsConvexPiece(const float* xy, const vector<int>& piece)
+{
+	for (int i = 0, n = piece.size(); i < n; i++)
+	{
+		if (Turn(xy, piece[i], piece[(i + 1) % n], piece[(i + 2) % n]) < 0)return false;
+	}
+	return true;
+}
+
+// merge piece b into piece a if they share edge a[i]->a[i+1], return true if merged
+static bool MergePieces(const float* xy, vector<int>& a, const vector<int>& b, int maxVertices)
+{
+	int na = a.size(), nb = b.size();
+	if (na + nb - 2 > maxVertices)return false;
+	for (int i = 0; i < na; i++)
+	{
+		int u = a[i], v = a[(i + 1) % na];
+		for (int j = 0; j < nb; j++)
+		{
+			// shared diagonal runs v->u in piece b
+			if (b[j] != v || b[(j + 1) % nb] != u)continue;
+
+			// walk a from v around to u, then b from u around to v, excluding u and v
+			vector<int> merged;
+			for (int k = 0; k < na; k++)merged.push_back(a[(i + 1 + k) % na]);
+			for (int k = 2; k < nb; k++)merged.push_back(b[(j + k) % nb]);
+			if (!IsConvexPiece(xy, merged))return false;
+			a = merged;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool ConvexDecompositionXY(const float* xy, int count, vector<int>& pieceIndices, vector<int>& pieceOffsets, int maxVertices)
+{
+	pieceIndices.clear();
+	pieceOffsets.assign(1, 0);
+	vector<int> triangles;
+	if (!TriangulatePolygonXY(xy, count, triangles))return false;
+
+	// each triangle is a piece at the beginning
+	vector<vector<int> > pieces;
+	for (int i = 0; i < (int)triangles.size(); i += 3)
+	{
+		vector<int> piece(triangles.begin() + i, triangles.begin() + i + 3);
+		pieces.push_back(piece);
+	}
+
+	// remove diagonals while merged pieces keep convex
+	bool merged;
+	do{
+		merged = false;
+		for (int i = 0; i < (int)pieces.size(); i++)
+		{
+			for (int j = i + 1; j < (int)pieces.size(); j++)
+			{
+				if (MergePieces(xy, pieces[i], pieces[j], maxVertices))
+				{
+					pieces.erase(pieces.begin() + j);
+					merged = true;
+					j = i;
+				}
+			}
+		}
+	} while (merged);
+
+	// output pieces by clockwise
+	for (auto p = pieces.begin(); p != pieces.end(); p++)
+	{
+		pieceIndices.insert(pieceIndices.end(), p->rbegin(), p->rend());
+		pieceOffsets.push_back((int)pieceIndices.size());
+	}
+	return true;
+}
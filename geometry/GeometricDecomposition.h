@@ -0,0 +1,30 @@
+#ifndef __GEOMETRIC_DECOMPOSITION_H__
+#define __GEOMETRIC_DECOMPOSITION_H__
+
+#include <vector>
+
+/**
+ * Triangulate a simple polygon stored as interleaved coordinates, by ear clipping
+ * Concave polygon is supported, self-intersecting polygon is not
+ * @param xy		coordinates x0,y0,x1,y1..., in anti-clockwise order
+ * @param count		the number of points
+ * @param triangles	OUTPUT, 3 point indices per triangle, in anti-clockwise order
+ * @return true if polygon is triangulated, false if no ear is found (self-intersecting polygon)
+ */
+bool TriangulatePolygonXY(const float* xy, int count, std::vector<int>& triangles);
+
+/**
+ * Approximate Convex Decomposition of a polygon stored as interleaved coordinates, Hertel-Mehlhorn algorithm
+ * Triangulate polygon, then remove diagonals greedily
+ * as long as the two pieces sharing it still merge to a convex piece
+ * The result is at most 4 times the optimal number of convex pieces
+ * @param xy			coordinates x0,y0,x1,y1..., in anti-clockwise order
+ * @param count			the number of points
+ * @param pieceIndices	OUTPUT, point indices of pieces, piece by piece, each in clockwise order
+ * @param pieceOffsets	OUTPUT, piece i is [pieceOffsets[i], pieceOffsets[i + 1]) in pieceIndices
+ * @param maxVertices	max number of points per convex piece
+ * @return true if polygon is decomposed, false if polygon can not be triangulated
+ */
+bool ConvexDecompositionXY(const float* xy, int count, std::vector<int>& pieceIndices, std::vector<int>& pieceOffsets, int maxVertices = 8);
+
+#endif	/* __GEOMETRIC_DECOMPOSITION_H__ */
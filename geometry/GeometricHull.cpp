@@ -0,0 +1,170 @@
+#include "GeometricHull.h"
+#include "GeometricPredicates.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+
+// map float to unsigned integer with the same order, so that points are sorted by integer keys
+inline uint32_t OrderedFloatBits(float f)
+{
+	uint32_t u;
+	memcpy(&u, &f, sizeof(u));
+	return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+}
+
+// minimum number of points to prefilter before computing convex hull
+#define HULL_FILTER_THRESHOLD 256
+// maximum number of points sorted by insertion sort, stroke-sized point sets are mostly in order
+#define HULL_INSERTION_SORT_THRESHOLD 64
+
+// hull vertex candidate, sorted by x then y
+struct HullPoint
+{
+	uint64_t key;
+	float x, y;
+	int idx;
+	void set(float px, float py, int i)
+	{
+		x = px; y = py; idx = i;
+		key = ((uint64_t)OrderedFloatBits(px + 0.0f) << 32) | OrderedFloatBits(py + 0.0f);
+	}
+	bool operator<(const HullPoint& o) const { return key < o.key; }
+};
+
+// Andrew's monotone chain, pts are filtered and sorted in place, hull is the scratch buffer of count + 1 elements
+// output hull indices are clockwise, starting at the leftmost-lowest point
+static int MonotoneChain(HullPoint* pts, int count, int* hull)
+{
+	if (count <= 0)return 0;
+
+	// Akl-Toussaint heuristic: points strictly inside the quadrilateral of
+	// the extreme points can never be on the hull, drop them before sorting,
+	// only paid off for large point sets
+	if (count > HULL_FILTER_THRESHOLD)
+	{
+		int e[4] = { 0, 0, 0, 0 };	// left, top, right, bottom
+		for (int i = 1; i < count; i++)
+		{
+			if (pts[i].x < pts[e[0]].x)e[0] = i;
+			if (pts[i].y > pts[e[1]].y)e[1] = i;
+			if (pts[i].x > pts[e[2]].x)e[2] = i;
+			if (pts[i].y < pts[e[3]].y)e[3] = i;
+		}
+		HullPoint q[4] = { pts[e[0]], pts[e[1]], pts[e[2]], pts[e[3]] };
+		int m = 0;
+		for (int i = 0; i < count; i++)
+		{
+			const HullPoint& p = pts[i];
+			bool inside = true;
+			for (int j = 0; j < 4 && inside; j++)
+			{
+				const HullPoint& a = q[j];
+				const HullPoint& b = q[(j + 1) % 4];
+				// quadrilateral is clockwise, inside points are strictly on the right side
+				inside = Orient2D(a.x, a.y, b.x, b.y, p.x, p.y) < 0;
+			}
+			if (!inside)pts[m++] = p;
+		}
+		count = m;
+	}
+	if (count <= HULL_INSERTION_SORT_THRESHOLD)
+	{
+		// a stroke drawn from right to left is sorted backwards
+		if (count > 1 && pts[count - 1].key < pts[0].key)reverse(pts, pts + count);
+		for (int i = 1; i < count; i++)
+		{
+			HullPoint p = pts[i];
+			int j = i;
+			for (; j > 0 && p.key < pts[j - 1].key; j--)pts[j] = pts[j - 1];
+			pts[j] = p;
+		}
+	}
+	else sort(pts, pts + count);
+
+	// points turning anti-clockwise or collinear are popped, the chains turn clockwise only
+	#define HULL_TURN(a, b, c) Orient2D(pts[a].x, pts[a].y, pts[b].x, pts[b].y, pts[c].x, pts[c].y)
+	int k = 0;
+	// upper chain, from leftmost to rightmost
+	for (int i = 0; i < count; i++)
+	{
+		while (k >= 2 && HULL_TURN(hull[k - 2], hull[k - 1], i) >= 0)k--;
+		hull[k++] = i;
+	}
+	// lower chain, from rightmost back to leftmost
+	int upper = k + 1;
+	for (int i = count - 2; i >= 0; i--)
+	{
+		while (k >= upper && HULL_TURN(hull[k - 2], hull[k - 1], i) >= 0)k--;
+		hull[k++] = i;
+	}
+	#undef HULL_TURN
+
+	// the leftmost point is added twice, once per chain
+	if (k > 1)k--;
+	// all points are the same
+	if (k == 2 && pts[hull[0]].x == pts[hull[1]].x && pts[hull[0]].y == pts[hull[1]].y)k = 1;
+
+	// map back to input indices
+	for (int i = 0; i < k; i++)hull[i] = pts[hull[i]].idx;
+	return k;
+}
+
+// scratch buffers for hull computing, grown on demand and reused per thread
+struct HullScratch
+{
+	vector<HullPoint> pts;
+	vector<int> hull;
+	void reserve(int count)
+	{
+		if ((int)pts.size() < count)pts.resize(count);
+		if ((int)hull.size() < count + 1)hull.resize(count + 1);
+	}
+};
+static thread_local HullScratch hullScratch;
+
+int ConvexHullSoA(const float* xs, const float* ys, int count, int* hullIndices)
+{
+	if (count <= 0)return 0;
+	hullScratch.reserve(count);
+	HullPoint* pts = hullScratch.pts.data();
+	for (int i = 0; i < count; i++)pts[i].set(xs[i], ys[i], i);
+	// chain needs count + 1 elements, caller's buffer has count
+	int* hull = hullScratch.hull.data();
+	int k = MonotoneChain(pts, count, hull);
+	memcpy(hullIndices, hull, sizeof(int) * k);
+	return k;
+}
+
+int ConvexHullXY(const float* xy, int count, int* hullIndices)
+{
+	if (count <= 0)return 0;
+	hullScratch.reserve(count);
+	HullPoint* pts = hullScratch.pts.data();
+	for (int i = 0; i < count; i++)pts[i].set(xy[2 * i], xy[2 * i + 1], i);
+	int* hull = hullScratch.hull.data();
+	int k = MonotoneChain(pts, count, hull);
+	memcpy(hullIndices, hull, sizeof(int) * k);
+	return k;
+}
+
+void ConvexHullBatch(const float* xs, const float* ys, const int* offsets, int numPolygons, vector<int>& hullIndices, vector<int>& hullOffsets)
+{
+	hullIndices.clear();
+	hullOffsets.assign(1, 0);
+	if (numPolygons <= 0)return;
+	hullIndices.reserve(offsets[numPolygons] - offsets[0]);
+
+	for (int i = 0; i < numPolygons; i++)
+	{
+		int begin = offsets[i], count = offsets[i + 1] - begin;
+		hullScratch.reserve(count);
+		HullPoint* pts = hullScratch.pts.data();
+		int* hull = hullScratch.hull.data();
+		for (int j = 0; j < count; j++)pts[j].set(xs[begin + j], ys[begin + j], begin + j);
+		int k = MonotoneChain(pts, count, hull);
+		hullIndices.insert(hullIndices.end(), hull, hull + k);
+		hullOffsets.push_back(hullIndices.size());
+	}
+}
@@ -0,0 +1,41 @@
+#ifndef __GEOMETRIC_HULL_H__
+#define __GEOMETRIC_HULL_H__
+
+#include <vector>
+
+/**
+ * Calculate Convex Hull of points stored as separated coordinate arrays (SoA)
+ * Andrew's monotone chain with exact orientation tests,
+ * collinear and duplicated points are not included in the hull
+ * @param xs			x coordinates
+ * @param ys			y coordinates
+ * @param count			the number of points
+ * @param hullIndices	OUTPUT, indices of hull points, sorted by clockwise, at least count elements
+ * @return the number of hull points
+ */
+int ConvexHullSoA(const float* xs, const float* ys, int count, int* hullIndices);
+
+/**
+ * Calculate Convex Hull of points stored as interleaved coordinates, such as an array of Vec2
+ * @param xy			coordinates x0,y0,x1,y1...
+ * @param count			the number of points
+ * @param hullIndices	OUTPUT, indices of hull points, sorted by clockwise, at least count elements
+ * @see ConvexHullSoA
+ * @return the number of hull points
+ */
+int ConvexHullXY(const float* xy, int count, int* hullIndices);
+
+/**
+ * Calculate Convex Hulls of many polygons in a batch
+ * Polygon i is made of the points [offsets[i], offsets[i + 1]) in the SoA buffers
+ * @param xs			x coordinates of all polygons
+ * @param ys			y coordinates of all polygons
+ * @param offsets		point offsets of polygons, numPolygons + 1 elements
+ * @param numPolygons	the number of polygons
+ * @param hullIndices	OUTPUT, indices of hull points into xs/ys, hull by hull
+ * @param hullOffsets	OUTPUT, hull i is [hullOffsets[i], hullOffsets[i + 1]) in hullIndices
+ * @see ConvexHullSoA
+ */
+void ConvexHullBatch(const float* xs, const float* ys, const int* offsets, int numPolygons, std::vector<int>& hullIndices, std::vector<int>& hullOffsets);
+
+#endif	/* __GEOMETRIC_HULL_H__ */
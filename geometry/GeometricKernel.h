@@ -0,0 +1,493 @@
+#ifndef __GEOMETRIC_KERNEL_H__
+#define __GEOMETRIC_KERNEL_H__
+
+/**
+ * Geometric Kernel
+ * Batched geometry over SoA (structure of arrays) float buffers, points are stored as
+ * separated x & y arrays so that several points are processed by one SIMD instruction.
+ * This header has no dependency on cocos2d, see GeometricKernelAdapter.h for cocos2d::Vec2 adapters.
+ * The instruction set is chosen at compile time: AVX2 (8 lanes), SSE2 (4 lanes),
+ * NEON on AArch64 (4 lanes), or plain scalar code for any other target.
+ * Define GEOMETRIC_KERNEL_NO_SIMD to force the scalar code.
+ */
+
+#include <cmath>
+#include <cfloat>
+
+#if defined(GEOMETRIC_KERNEL_NO_SIMD)
+// scalar code only
+#elif defined(__AVX2__)
+#define GEOMETRIC_KERNEL_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GEOMETRIC_KERNEL_SSE
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define GEOMETRIC_KERNEL_NEON
+#include <arm_neon.h>
+#endif
+
+namespace GeometricKernel
+{
+
+namespace simd
+{
+
+#if defined(GEOMETRIC_KERNEL_AVX2)
+
+typedef __m256 Float;
+enum { WIDTH = 8 };
+
+inline Float Load(const float* p) { return _mm256_loadu_ps(p); }
+inline void Store(float* p, Float a) { _mm256_storeu_ps(p, a); }
+inline Float Set(float f) { return _mm256_set1_ps(f); }
+inline Float Iota() { return _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7); }
+inline Float Add(Float a, Float b) { return _mm256_add_ps(a, b); }
+inline Float Sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+inline Float Mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+inline Float Div(Float a, Float b) { return _mm256_div_ps(a, b); }
+inline Float Min(Float a, Float b) { return _mm256_min_ps(a, b); }
+inline Float Max(Float a, Float b) { return _mm256_max_ps(a, b); }
+inline Float Sqrt(Float a) { return _mm256_sqrt_ps(a); }
+inline Float Abs(Float a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+// comparisons return lane masks, all bits set if true
+inline Float Less(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+inline Float Greater(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+inline Float And(Float a, Float b) { return _mm256_and_ps(a, b); }
+inline Float Xor(Float a, Float b) { return _mm256_xor_ps(a, b); }
+inline Float Select(Float mask, Float a, Float b) { return _mm256_blendv_ps(b, a, mask); }
+
+#elif defined(GEOMETRIC_KERNEL_SSE)
+
+typedef __m128 Float;
+enum { WIDTH = 4 };
+
+inline Float Load(const float* p) { return _mm_loadu_ps(p); }
+inline void Store(float* p, Float a) { _mm_storeu_ps(p, a); }
+inline Float Set(float f) { return _mm_set1_ps(f); }
+inline Float Iota() { return _mm_setr_ps(0, 1, 2, 3); }
+inline Float Add(Float a, Float b) { return _mm_add_ps(a, b); }
+inline Float Sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+inline Float Mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+inline Float Div(Float a, Float b) { return _mm_div_ps(a, b); }
+inline Float Min(Float a, Float b) { return _mm_min_ps(a, b); }
+inline Float Max(Float a, Float b) { return _mm_max_ps(a, b); }
+inline Float Sqrt(Float a) { return _mm_sqrt_ps(a); }
+inline Float Abs(Float a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+inline Float Less(Float a, Float b) { return _mm_cmplt_ps(a, b); }
+inline Float Greater(Float a, Float b) { return _mm_cmpgt_ps(a, b); }
+inline Float And(Float a, Float b) { return _mm_and_ps(a, b); }
+inline Float Xor(Float a, Float b) { return _mm_xor_ps(a, b); }
+inline Float Select(Float mask, Float a, Float b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+
+#elif defined(GEOMETRIC_KERNEL_NEON)
+
+typedef float32x4_t Float;
+enum { WIDTH = 4 };
+
+inline Float Load(const float* p) { return vld1q_f32(p); }
+inline void Store(float* p, Float a) { vst1q_f32(p, a); }
+inline Float Set(float f) { return vdupq_n_f32(f); }
+inline Float Iota() { static const float i[4] = { 0, 1, 2, 3 }; return vld1q_f32(i); }
+inline Float Add(Float a, Float b) { return vaddq_f32(a, b); }
+inline Float Sub(Float a, Float b) { return vsubq_f32(a, b); }
+inline Float Mul(Float a, Float b) { return vmulq_f32(a, b); }
+inline Float Div(Float a, Float b) { return vdivq_f32(a, b); }
+inline Float Min(Float a, Float b) { return vminq_f32(a, b); }
+inline Float Max(Float a, Float b) { return vmaxq_f32(a, b); }
+inline Float Sqrt(Float a) { return vsqrtq_f32(a); }
+inline Float Abs(Float a) { return vabsq_f32(a); }
+inline Float Less(Float a, Float b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+inline Float Greater(Float a, Float b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+inline Float And(Float a, Float b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+inline Float Xor(Float a, Float b) { return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+inline Float Select(Float mask, Float a, Float b) { return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+
+#else
+
+// no SIMD instruction set, one lane only
+#define GEOMETRIC_KERNEL_SCALAR
+enum { WIDTH = 1 };
+
+#endif
+
+#ifndef GEOMETRIC_KERNEL_SCALAR
+// horizontal reductions, only used once per batch
+inline float ReduceAdd(Float a) { float l[WIDTH]; Store(l, a); float r = l[0]; for (int i = 1; i < WIDTH; i++)r += l[i]; return r; }
+inline float ReduceMin(Float a) { float l[WIDTH]; Store(l, a); float r = l[0]; for (int i = 1; i < WIDTH; i++)r = l[i] < r ? l[i] : r; return r; }
+inline float ReduceMax(Float a) { float l[WIDTH]; Store(l, a); float r = l[0]; for (int i = 1; i < WIDTH; i++)r = l[i] > r ? l[i] : r; return r; }
+#endif
+
+}	// namespace simd
+
+/**
+ * Perpendicular distances from points to the line through begin & end
+ * If begin & end are the same point, distances to begin are returned
+ * @param xs, ys	points
+ * @param count		the number of points
+ * @param bx, by	the first point in the line
+ * @param ex, ey	the last point in the line
+ * @param out		OUTPUT, count distances
+ */
+inline void PerpendicularDistances(const float* xs, const float* ys, int count, float bx, float by, float ex, float ey, float* out)
+{
+	float dx = ex - bx, dy = ey - by;
+	float len = std::sqrt(dx*dx + dy*dy);
+	int i = 0;
+	if (len == 0)
+	{
+#ifndef GEOMETRIC_KERNEL_SCALAR
+		simd::Float vbx = simd::Set(bx), vby = simd::Set(by);
+		for (; i + simd::WIDTH <= count; i += simd::WIDTH)
+		{
+			simd::Float px = simd::Sub(simd::Load(xs + i), vbx), py = simd::Sub(simd::Load(ys + i), vby);
+			simd::Store(out + i, simd::Sqrt(simd::Add(simd::Mul(px, px), simd::Mul(py, py))));
+		}
+#endif
+		for (; i < count; i++)out[i] = std::sqrt((xs[i] - bx)*(xs[i] - bx) + (ys[i] - by)*(ys[i] - by));
+		return;
+	}
+
+	// |cross(end - begin, p - begin)| / |end - begin|
+	float inv = 1 / len;
+#ifndef GEOMETRIC_KERNEL_SCALAR
+	simd::Float vbx = simd::Set(bx), vby = simd::Set(by), vdx = simd::Set(dx), vdy = simd::Set(dy), vinv = simd::Set(inv);
+	for (; i + simd::WIDTH <= count; i += simd::WIDTH)
+	{
+		simd::Float px = simd::Sub(simd::Load(xs + i), vbx), py = simd::Sub(simd::Load(ys + i), vby);
+		simd::Float c = simd::Sub(simd::Mul(vdx, py), simd::Mul(vdy, px));
+		simd::Store(out + i, simd::Mul(simd::Abs(c), vinv));
+	}
+#endif
+	for (; i < count; i++)out[i] = std::fabs(dx*(ys[i] - by) - dy*(xs[i] - bx)) * inv;
+}
+
+/**
+ * Find the point with max perpendicular distance to the line through begin & end
+ * @param xs, ys	points
+ * @param count		the number of points
+ * @param bx, by	the first point in the line
+ * @param ex, ey	the last point in the line
+ * @param dmax		OUTPUT, the max distance, 0 if there are no points
+ * @see PerpendicularDistances
+ * @return index of the first point with max distance, -1 if there are no points
+ */
+inline int MaxPerpendicularDistance(const float* xs, const float* ys, int count, float bx, float by, float ex, float ey, float* dmax)
+{
+	float dx = ex - bx, dy = ey - by;
+	float len = std::sqrt(dx*dx + dy*dy);
+	// a degenerated line, measure distance to begin instead
+	bool point = len == 0;
+	float inv = point ? 1 : 1 / len;
+
+	int idx = -1;
+	float best = -1;
+	int i = 0;
+#ifndef GEOMETRIC_KERNEL_SCALAR
+	if (count >= simd::WIDTH)
+	{
+		simd::Float vbx = simd::Set(bx), vby = simd::Set(by), vdx = simd::Set(dx), vdy = simd::Set(dy), vinv = simd::Set(inv);
+		simd::Float vbest = simd::Set(-1), vidx = simd::Set(-1), vi = simd::Iota(), step = simd::Set((float)simd::WIDTH);
+		for (; i + simd::WIDTH <= count; i += simd::WIDTH)
+		{
+			simd::Float px = simd::Sub(simd::Load(xs + i), vbx), py = simd::Sub(simd::Load(ys + i), vby);
+			simd::Float d = point
+				? simd::Sqrt(simd::Add(simd::Mul(px, px), simd::Mul(py, py)))
+				: simd::Mul(simd::Abs(simd::Sub(simd::Mul(vdx, py), simd::Mul(vdy, px))), vinv);
+			// strictly greater, so each lane keeps its first max
+			simd::Float m = simd::Greater(d, vbest);
+			vbest = simd::Select(m, d, vbest);
+			vidx = simd::Select(m, vi, vidx);
+			vi = simd::Add(vi, step);
+		}
+
+		// merge lanes, the smallest index wins on ties
+		float lb[simd::WIDTH], li[simd::WIDTH];
+		simd::Store(lb, vbest); simd::Store(li, vidx);
+		for (int l = 0; l < simd::WIDTH; l++)
+		{
+			if (lb[l] > best || (lb[l] == best && (int)li[l] < idx))
+			{
+				best = lb[l];
+				idx = (int)li[l];
+			}
+		}
+	}
+#endif
+	for (; i < count; i++)
+	{
+		float px = xs[i] - bx, py = ys[i] - by;
+		float d = point ? std::sqrt(px*px + py*py) : std::fabs(dx*py - dy*px) * inv;
+		if (d > best)
+		{
+			best = d;
+			idx = i;
+		}
+	}
+	*dmax = idx < 0 ? 0 : best;
+	return idx;
+}
+
+/**
+ * Euclidean distances from points to a fixed point
+ * @param xs, ys	points
+ * @param count		the number of points
+ * @param px, py	fixed point
+ * @param out		OUTPUT, count distances
+ */
+inline void Distances(const float* xs, const float* ys, int count, float px, float py, float* out)
+{
+	int i = 0;
+#ifndef GEOMETRIC_KERNEL_SCALAR
+	simd::Float vpx = simd::Set(px), vpy = simd::Set(py);
+	for (; i + simd::WIDTH <= count; i += simd::WIDTH)
+	{
+		simd::Float dx = simd::Sub(simd::Load(xs + i), vpx), dy = simd::Sub(simd::Load(ys + i), vpy);
+		simd::Store(out + i, simd::Sqrt(simd::Add(simd::Mul(dx, dx), simd::Mul(dy, dy))));
+	}
+#endif
+	for (; i < count; i++)out[i] = std::sqrt((xs[i] - px)*(xs[i] - px) + (ys[i] - py)*(ys[i] - py));
+}
+
+/**
+ * Min & max Euclidean distance from points to a fixed point
+ * @param xs, ys	points
+ * @param count		the number of points
+ * @param px, py	fixed point
+ * @param dmin		OUTPUT, min distance, FLT_MAX if there are no points
+ * @param dmax		OUTPUT, max distance, 0 if there are no points
+ */
+inline void DistanceRange(const float* xs, const float* ys, int count, float px, float py, float* dmin, float* dmax)
+{
+	// compare squared distances, sqrt only once at last
+	float lo = FLT_MAX, hi = 0;
+	int i = 0;
+#ifndef GEOMETRIC_KERNEL_SCALAR
+	if (count >= simd::WIDTH)
+	{
+		simd::Float vpx = simd::Set(px), vpy = simd::Set(py), vlo = simd::Set(FLT_MAX), vhi = simd::Set(0);
+		for (; i + simd::WIDTH <= count; i += simd::WIDTH)
+		{
+			simd::Float dx = simd::Sub(simd::Load(xs + i), vpx), dy = simd::Sub(simd::Load(ys + i), vpy);
+			simd::Float d2 = simd::Add(simd::Mul(dx, dx), simd::Mul(dy, dy));
+			vlo = simd::Min(vlo, d2);
+			vhi = simd::Max(vhi, d2);
+		}
+		lo = simd::ReduceMin(vlo);
+		hi = simd::ReduceMax(vhi);
+	}
+#endif
+	for (; i < count; i++)
+	{
+		float d2 = (xs[i] - px)*(xs[i] - px) + (ys[i] - py)*(ys[i] - py);
+		lo = d2 < lo ? d2 : lo;
+		hi = d2 > hi ? d2 : hi;
+	}
+	*dmin = count ? std::sqrt(lo) : FLT_MAX;
+	*dmax = std::sqrt(hi);
+}
+
+/**
+ * Axis aligned bounding box of points
+ * @param xs, ys	points
+ * @param count		the number of points, at least 1
+ * @param xmin, ymin, xmax, ymax	OUTPUT, bounding box anchors
+ */
+inline void BoundingBox(const float* xs, const float* ys, int count, float* xmin, float* ymin, float* xmax, float* ymax)
+{
+	float x0 = FLT_MAX, y0 = FLT_MAX, x1 = -FLT_MAX, y1 = -FLT_MAX;
+	int i = 0;
+#ifndef GEOMETRIC_KERNEL_SCALAR
+	if (count >= simd::WIDTH)
+	{
+		simd::Float vx0 = simd::Load(xs), vy0 = simd::Load(ys), vx1 = vx0, vy1 = vy0;
+		for (i = simd::WIDTH; i + simd::WIDTH <= count; i += simd::WIDTH)
+		{
+			simd::Float x = simd::Load(xs + i), y = simd::Load(ys + i);
+			vx0 = simd::Min(vx0, x); vx1 = simd::Max(vx1, x);
+			vy0 = simd::Min(vy0, y); vy1 = simd::Max(vy1, y);
+		}
+		x0 = simd::ReduceMin(vx0); x1 = simd::ReduceMax(vx1);
+		y0 = simd::ReduceMin(vy0); y1 = simd::ReduceMax(vy1);
+	}
+#endif
+	for (; i < count; i++)
+	{
+		x0 = xs[i] < x0 ? xs[i] : x0; x1 = xs[i] > x1 ? xs[i] : x1;
+		y0 = ys[i] < y0 ? ys[i] : y0; y1 = ys[i] > y1 ? ys[i] : y1;
+	}
+	*xmin = x0; *ymin = y0; *xmax = x1; *ymax = y1;
+}
+
+/**
+ * Centroid of points, the average of all the points
+ * @param xs, ys	points
+ * @param count		the number of points, at least 1
+ * @param cx, cy	OUTPUT, centroid
+ */
+inline void Centroid(const float* xs, const float* ys, int count, float* cx, float* cy)
+{
+	float sx = 0, sy = 0;
+	int i = 0;
+#ifndef GEOMETRIC_KERNEL_SCALAR
+	simd::Float vsx = simd::Set(0), vsy = simd::Set(0);
+	for (; i + simd::WIDTH <= count; i += simd::WIDTH)
+	{
+		vsx = simd::Add(vsx, simd::Load(xs + i));
+		vsy = simd::Add(vsy, simd::Load(ys + i));
+	}
+	sx = simd::ReduceAdd(vsx);
+	sy = simd::ReduceAdd(vsy);
+#endif
+	for (; i < count; i++)
+	{
+		sx += xs[i];
+		sy += ys[i];
+	}
+	*cx = sx / count;
+	*cy = sy / count;
+}
+
+/**
+ * Orientation of points relative to the directed line from A to B
+ * Plain floating point determinants, use Orient2D in GeometricPredicates.h where the exact sign matters
+ * @param xs, ys	points
+ * @param count		the number of points
+ * @param ax, ay	point A
+ * @param bx, by	point B
+ * @param out		OUTPUT, positive if a point is on the left (anti-clockwise) side, negative if on the right
+ */
+inline void Orientations(const float* xs, const float* ys, int count, float ax, float ay, float bx, float by, float* out)
+{
+	float dx = bx - ax, dy = by - ay;
+	int i = 0;
+#ifndef GEOMETRIC_KERNEL_SCALAR
+	simd::Float vax = simd::Set(ax), vay = simd::Set(ay), vdx = simd::Set(dx), vdy = simd::Set(dy);
+	for (; i + simd::WIDTH <= count; i += simd::WIDTH)
+	{
+		simd::Float px = simd::Sub(simd::Load(xs + i), vax), py = simd::Sub(simd::Load(ys + i), vay);
+		simd::Store(out + i, simd::Sub(simd::Mul(vdx, py), simd::Mul(vdy, px)));
+	}
+#endif
+	for (; i < count; i++)out[i] = dx*(ys[i] - ay) - dy*(xs[i] - ax);
+}
+
+/**
+ * Signed area of a polygon
+ * @param xs, ys	polygon points, the polygon is closed implicitly
+ * @param count		the number of points
+ * @return positive if points are in anti-clockwise order, negative if clockwise
+ */
+inline float SignedArea(const float* xs, const float* ys, int count)
+{
+	if (count < 3)return 0;
+	float area = 0;
+	int i = 0, edges = count - 1;
+#ifndef GEOMETRIC_KERNEL_SCALAR
+	simd::Float varea = simd::Set(0);
+	for (; i + simd::WIDTH <= edges; i += simd::WIDTH)
+	{
+		simd::Float x0 = simd::Load(xs + i), y0 = simd::Load(ys + i);
+		simd::Float x1 = simd::Load(xs + i + 1), y1 = simd::Load(ys + i + 1);
+		varea = simd::Add(varea, simd::Sub(simd::Mul(x0, y1), simd::Mul(x1, y0)));
+	}
+	area = simd::ReduceAdd(varea);
+#endif
+	for (; i < edges; i++)area += xs[i] * ys[i + 1] - xs[i + 1] * ys[i];
+	// closing edge
+	area += xs[edges] * ys[0] - xs[0] * ys[edges];
+	return area / 2;
+}
+
+/**
+ * Point in polygon test by crossing number (even-odd rule)
+ * @param xs, ys	polygon points, the polygon is closed implicitly
+ * @param count		the number of points
+ * @param px, py	point to be checked
+ * @return true if the point is inside the polygon, false otherwise
+ */
+inline bool PointInPolygon(const float* xs, const float* ys, int count, float px, float py)
+{
+	if (count < 3)return false;
+	int crossings = 0, i = 0;
+#ifndef GEOMETRIC_KERNEL_SCALAR
+	// the closing edge is left to the scalar loop
+	int edges = count - 1;
+	if (edges >= simd::WIDTH)
+	{
+		simd::Float vpx = simd::Set(px), vpy = simd::Set(py), one = simd::Set(1), vcnt = simd::Set(0);
+		for (; i + simd::WIDTH <= edges; i += simd::WIDTH)
+		{
+			simd::Float x0 = simd::Load(xs + i), y0 = simd::Load(ys + i);
+			simd::Float x1 = simd::Load(xs + i + 1), y1 = simd::Load(ys + i + 1);
+			// edge straddles the horizontal line through p
+			simd::Float straddle = simd::Xor(simd::Greater(y0, vpy), simd::Greater(y1, vpy));
+			// x of the intersection, horizontal edges are masked out by straddle
+			simd::Float xi = simd::Add(x0, simd::Div(simd::Mul(simd::Sub(vpy, y0), simd::Sub(x1, x0)), simd::Sub(y1, y0)));
+			simd::Float m = simd::And(straddle, simd::Less(vpx, xi));
+			vcnt = simd::Add(vcnt, simd::And(m, one));
+		}
+		crossings = (int)simd::ReduceAdd(vcnt);
+	}
+#endif
+	for (; i < count; i++)
+	{
+		int j = i + 1 == count ? 0 : i + 1;
+		if ((ys[i] > py) != (ys[j] > py)
+			&& px < xs[i] + (py - ys[i]) * (xs[j] - xs[i]) / (ys[j] - ys[i]))
+			crossings++;
+	}
+	return (crossings & 1) != 0;
+}
+
+/**
+ * Min distance from a fixed point to a polyline
+ * @param xs, ys	polyline points
+ * @param count		the number of points, a single point is measured as it is
+ * @param px, py	fixed point
+ * @return min distance to any segment of the polyline, FLT_MAX if there are no points
+ */
+inline float MinDistanceToPolyline(const float* xs, const float* ys, int count, float px, float py)
+{
+	if (count <= 0)return FLT_MAX;
+	if (count == 1)return std::sqrt((xs[0] - px)*(xs[0] - px) + (ys[0] - py)*(ys[0] - py));
+
+	// closest point on segment AB is A + t(B - A), t clamped to [0, 1]
+	float best = FLT_MAX;
+	int i = 0, edges = count - 1;
+#ifndef GEOMETRIC_KERNEL_SCALAR
+	if (edges >= simd::WIDTH)
+	{
+		simd::Float vpx = simd::Set(px), vpy = simd::Set(py), zero = simd::Set(0), one = simd::Set(1), tiny = simd::Set(FLT_MIN);
+		simd::Float vbest = simd::Set(FLT_MAX);
+		for (; i + simd::WIDTH <= edges; i += simd::WIDTH)
+		{
+			simd::Float ax = simd::Load(xs + i), ay = simd::Load(ys + i);
+			simd::Float dx = simd::Sub(simd::Load(xs + i + 1), ax), dy = simd::Sub(simd::Load(ys + i + 1), ay);
+			simd::Float qx = simd::Sub(vpx, ax), qy = simd::Sub(vpy, ay);
+			simd::Float len2 = simd::Max(simd::Add(simd::Mul(dx, dx), simd::Mul(dy, dy)), tiny);
+			simd::Float t = simd::Div(simd::Add(simd::Mul(qx, dx), simd::Mul(qy, dy)), len2);
+			t = simd::Min(simd::Max(t, zero), one);
+			simd::Float rx = simd::Sub(qx, simd::Mul(t, dx)), ry = simd::Sub(qy, simd::Mul(t, dy));
+			vbest = simd::Min(vbest, simd::Add(simd::Mul(rx, rx), simd::Mul(ry, ry)));
+		}
+		best = simd::ReduceMin(vbest);
+	}
+#endif
+	for (; i < edges; i++)
+	{
+		float dx = xs[i + 1] - xs[i], dy = ys[i + 1] - ys[i];
+		float qx = px - xs[i], qy = py - ys[i];
+		float len2 = dx*dx + dy*dy;
+		float t = len2 > FLT_MIN ? (qx*dx + qy*dy) / len2 : 0;
+		t = t < 0 ? 0 : (t > 1 ? 1 : t);
+		float rx = qx - t*dx, ry = qy - t*dy;
+		float d2 = rx*rx + ry*ry;
+		best = d2 < best ? d2 : best;
+	}
+	return std::sqrt(best);
+}
+
+}	// namespace GeometricKernel
+
+#endif	/* __GEOMETRIC_KERNEL_H__ */
@@ -0,0 +1,118 @@
+#ifndef __GEOMETRIC_KERNEL_ADAPTER_H__
+#define __GEOMETRIC_KERNEL_ADAPTER_H__
+
+#include "cocos2d.h"
+#include "geometry/GeometricKernel.h"
+
+namespace GeometricKernel
+{
+
+/**
+ * Point Buffer
+ * SoA storage of cocos2d::Vec2 points, to be used with GeometricKernel
+ */
+struct PointBuffer
+{
+	std::vector<float> xs;	// x coordinates
+	std::vector<float> ys;	// y coordinates
+
+	PointBuffer() {}
+
+	explicit PointBuffer(const std::vector<cocos2d::Vec2>& points)
+	{
+		assign(points);
+	}
+
+	/**
+	 * Replace all points
+	 * @param points	points to be copied
+	 */
+	void assign(const std::vector<cocos2d::Vec2>& points)
+	{
+		xs.resize(points.size());
+		ys.resize(points.size());
+		for (size_t i = 0; i < points.size(); i++)
+		{
+			xs[i] = points[i].x;
+			ys[i] = points[i].y;
+		}
+	}
+
+	void push_back(const cocos2d::Vec2& p)
+	{
+		xs.push_back(p.x);
+		ys.push_back(p.y);
+	}
+
+	void clear()
+	{
+		xs.clear();
+		ys.clear();
+	}
+
+	int size() const
+	{
+		return (int)xs.size();
+	}
+
+	bool empty() const
+	{
+		return xs.empty();
+	}
+
+	cocos2d::Vec2 operator[](int i) const
+	{
+		return cocos2d::Vec2(xs[i], ys[i]);
+	}
+};
+
+/**
+ * Axis aligned bounding box of points
+ * @param points	points, at least 1
+ * @return bounding box
+ * @see cocos2d::Rect
+ */
+inline cocos2d::Rect BoundingBox(const PointBuffer& points)
+{
+	float xmin, ymin, xmax, ymax;
+	BoundingBox(points.xs.data(), points.ys.data(), points.size(), &xmin, &ymin, &xmax, &ymax);
+	return cocos2d::Rect(xmin, ymin, xmax - xmin, ymax - ymin);
+}
+
+/**
+ * Centroid of points, the average of all the points
+ * @param points	points, at least 1
+ * @return centroid
+ */
+inline cocos2d::Vec2 Centroid(const PointBuffer& points)
+{
+	float cx, cy;
+	Centroid(points.xs.data(), points.ys.data(), points.size(), &cx, &cy);
+	return cocos2d::Vec2(cx, cy);
+}
+
+/**
+ * Point in polygon test
+ * @param polygon	polygon points
+ * @param p			point to be checked
+ * @return true if the point is inside the polygon, false otherwise
+ */
+inline bool PointInPolygon(const PointBuffer& polygon, const cocos2d::Vec2& p)
+{
+	return PointInPolygon(polygon.xs.data(), polygon.ys.data(), polygon.size(), p.x, p.y);
+}
+
+/**
+ * Min distance from a fixed point to a polyline
+ * @param polyline	polyline points
+ * @param p			fixed point
+ * @return min distance
+ */
+inline float MinDistanceToPolyline(const PointBuffer& polyline, const cocos2d::Vec2& p)
+{
+	return MinDistanceToPolyline(polyline.xs.data(), polyline.ys.data(), polyline.size(), p.x, p.y);
+}
+
+}	// namespace GeometricKernel
+
+#endif	/* __GEOMETRIC_KERNEL_ADAPTER_H__ */
@@ -1,12 +1,15 @@
 #include "GeometricMath.h"
+#include "GeometricPredicates.h"
+#include "GeometricKernelAdapter.h"
+#include <queue>
+#include <limits>
+#include <functional>
 
 USING_NS_CC;
 using namespace std;
 
 #define SQR(x) ((x)*(x))
 
-void RamerDouglasPeuckerSegment(vector<Vec2>& points, float epsilon, vector<Vec2>& result, int begin, int end);
-
 float PerpendicularDistance(Vec2 p, Vec2 begin, Vec2 end)
 {
 	if (begin.x == end.x)
@@ -22,39 +25,115 @@ float PerpendicularDistance(Vec2 p, Vec2 begin, Vec2 end)
 
 void RamerDouglasPeucker(vector<Vec2>& points, float epsilon, vector<Vec2>& result)
 {
-	RamerDouglasPeuckerSegment(points, epsilon, result, 0, points.size() - 1);
-}
+	// nothing to simplify, a single point would be output as both ends
+	if (points.size() < 2)
+	{
+		result.insert(result.end(), points.begin(), points.end());
+		return;
+	}
 
-void RamerDouglasPeuckerSegment(vector<Vec2>& points, float epsilon, vector<Vec2>& result, int begin, int end)
-{
-	if (points.empty()) return;
+	// SoA copy of points for batched distance
+	GeometricKernel::PointBuffer buffer(points);
+	const float *xs = buffer.xs.data(), *ys = buffer.ys.data();
 
-	// check the point with max perpendicular distance to point begin & end
-	float dmax = 0;
-	int idx = 0;
-	for (int i = begin + 1; i <= end - 1; i++)
+	// segments to be checked, begin & end index
+	// right segment is pushed first so that points are output from left to right
+	vector<pair<int, int> > segments;
+	segments.push_back(make_pair(0, (int)points.size() - 1));
+	while (!segments.empty())
 	{
-		float d = PerpendicularDistance(points[i], points[begin], points[end]);
-		if (d > dmax)
+		int begin = segments.back().first, end = segments.back().second;
+		segments.pop_back();
+
+		// check the point with max perpendicular distance to point begin & end
+		float dmax = 0;
+		int idx = begin + 1 + GeometricKernel::MaxPerpendicularDistance(xs + begin + 1, ys + begin + 1, end - begin - 1,
+			xs[begin], ys[begin], xs[end], ys[end], &dmax);
+
+		// if distance is larger than user-defined epsilon
+		if (dmax > epsilon)
+		{
+			// split at the farthest point, check both sides later
+			segments.push_back(make_pair(idx, end));
+			segments.push_back(make_pair(begin, idx));
+		}
+		else
 		{
-			idx = i;
-			dmax = d;
+			// otherwise, just ignore the points between point begin & end
+			if (result.empty())result.push_back(points[begin]);
+			result.push_back(points[end]);
 		}
 	}
+}
+
+// triangle area formed by point b and its neighbours a, c
+inline float TriangleArea(const Vec2& a, const Vec2& b, const Vec2& c)
+{
+	return abs((b.x - a.x)*(c.y - a.y) - (c.x - a.x)*(b.y - a.y)) / 2;
+}
+
+void VisvalingamWhyatt(const vector<Vec2>& points, int maxVertices, vector<Vec2>& result, float minArea, bool closed)
+{
+	result.clear();
+	int n = points.size();
+	int minVertices = closed ? 3 : 2;
+	maxVertices = MAX(maxVertices, minVertices);
+	if (n <= minVertices){ result = points; return; }
 
-	// if distance is larger than user-defined epsilon
-	if (dmax > epsilon)
+	// doubly linked list of remaining points
+	vector<int> prev(n), next(n), version(n, 0);
+	vector<float> area(n, numeric_limits<float>::max());
+	vector<bool> removed(n, false);
+	for (int i = 0; i < n; i++)
 	{
-		// do recursively
-		RamerDouglasPeuckerSegment(points, epsilon, result, begin, idx);
-		RamerDouglasPeuckerSegment(points, epsilon, result, idx, end);
+		prev[i] = (i + n - 1) % n;
+		next[i] = (i + 1) % n;
+	}
 
+	// min-heap by effective area, stale entries are skipped by version
+	typedef pair<float, pair<int, int> > HeapEntry;
+	priority_queue<HeapEntry, vector<HeapEntry>, greater<HeapEntry> > heap;
+	for (int i = 0; i < n; i++)
+	{
+		// end points of an open path are never removed
+		if (!closed && (i == 0 || i == n - 1))continue;
+		area[i] = TriangleArea(points[prev[i]], points[i], points[next[i]]);
+		heap.push(make_pair(area[i], make_pair(i, 0)));
 	}
-	else
+
+	int remain = n;
+	while (!heap.empty() && remain > minVertices)
+	{
+		HeapEntry top = heap.top();
+		int i = top.second.first;
+		if (removed[i] || top.second.second != version[i]){ heap.pop(); continue; }
+
+		// stop when budget is met and no point is negligible
+		if (remain <= maxVertices && top.first >= minArea)break;
+		heap.pop();
+
+		// unlink point i, then update the area of its neighbours
+		removed[i] = true;
+		remain--;
+		int p = prev[i], q = next[i];
+		next[p] = q;
+		prev[q] = p;
+		int neighbours[2] = { p, q };
+		for (int k = 0; k < 2; k++)
+		{
+			int j = neighbours[k];
+			if (!closed && (j == 0 || j == n - 1))continue;
+
+			// effective area never decreases, so that removal order is kept stable
+			area[j] = MAX(top.first, TriangleArea(points[prev[j]], points[j], points[next[j]]));
+			heap.push(make_pair(area[j], make_pair(j, ++version[j])));
+		}
+	}
+
+	// output remaining points by original order
+	for (int i = 0; i < n; i++)
 	{
-		// otherwise, just ignore the points between point begin & end
-		if (result.empty())result.push_back(points[begin]);
-		result.push_back(points[end]);
+		if (!removed[i])result.push_back(points[i]);
 	}
 }
 
@@ -80,15 +159,15 @@ bool PointClockwiseComparator(const Vec2& a, const Vec2& b)
 	if (a.x < 0 && b.x >= 0)return false;
 	if (a.x == 0 && b.x == 0)return a.y>b.y;
 
-	// vector cross product
-	int c = CrossVec2(a, b);
+	// vector cross product, exact sign relative to the zero origin
+	double c = Orient2D(0, 0, a.x, a.y, b.x, b.y);
 	//if (c<0){ log("a: %f, %f < b: %f, %f", a.x, a.y, b.x, b.y); }
 	//else if (c>0){ log("a: %f, %f > b: %f, %f", a.x, a.y, b.x, b.y); }
 	if (c)return (c < 0) ? true : false;
 	else 
 	{
 		// if collinear, choose the farthest
-		int d = SQR(a.x) - SQR(b.x) + SQR(a.y) - SQR(b.y); 
+		float d = SQR(a.x) - SQR(b.x) + SQR(a.y) - SQR(b.y); 
 		//if (d<0){ log("a: %f, %f < b: %f, %f", a.x, a.y, b.x, b.y); }
 		//else if (d>0){ log("a: %f, %f > b: %f, %f", a.x, a.y, b.x, b.y); }
 		return (d < 0) ? true : false;
@@ -126,45 +205,62 @@ Rect Intersection(const Rect& rect1, const Rect& rect2)
 	return CCRectMake(xc1, yc1, MAX(xc2 - xc1, 0), MAX(yc2 - yc1, 0));
 }
 
-void ConvexHull(vector<Vec2>& points, vector<Vec2>& result)
+void ConvexHull(const vector<Vec2>& points, vector<Vec2>& result)
 {
-	if (points.size() <= 2){ result = points; return; }
-	int idx = 0;
 	result.clear();
-	for (int i = 1; i<points.size(); i++)
+	int n = points.size();
+	if (n == 0)return;
+
+	// Vec2 array is read as interleaved x/y
+	static_assert(sizeof(Vec2) == 2 * sizeof(float), "Vec2 is not two packed floats");
+	static thread_local vector<int> hull;
+	if ((int)hull.size() < n)hull.resize(n);
+	int k = ConvexHullXY(&points[0].x, n, hull.data());
+	result.reserve(k);
+	for (int i = 0; i < k; i++)result.push_back(points[hull[i]]);
+}
+
+float SignedArea(const vector<Vec2>& polygon)
+{
+	float area = 0;
+	for (int i = 0, n = polygon.size(); i < n; i++)
 	{
-		if ((points[idx].x >points[i].x)
-			|| ((points[idx].x == points[i].x) && (points[idx].y) > points[i].y))
-			idx = i;
+		area += CrossVec2(polygon[i], polygon[(i + 1) % n]);
 	}
+	return area / 2;
+}
 
-	// swap points[0] and points[idx], and calc relative points
-	Vec2 relativePoint = points[idx]; points[idx] = points[0]; points[0] = relativePoint;
-	for (int i = 0; i < points.size(); i++)
+bool IsConvexPolygon(const vector<Vec2>& polygon)
+{
+	for (int i = 0, n = polygon.size(); i < n; i++)
 	{
-		points[i] = points[i] - relativePoint;
+		const Vec2& a = polygon[i];
+		const Vec2& b = polygon[(i + 1) % n];
+		const Vec2& c = polygon[(i + 2) % n];
+		if (CrossVec2(b - a, c - b) < 0)return false;
 	}
+	return true;
+}
 
-	// sort points by clockwise
-	sort(points.begin() + 1, points.end(), PointClockwiseComparator);
+bool TriangulatePolygon(const vector<Vec2>& polygon, vector<int>& triangles)
+{
+	triangles.clear();
+	if (polygon.size() < 3) return false;
+	// Vec2 array is read as interleaved x/y
+	return TriangulatePolygonXY(&polygon[0].x, polygon.size(), triangles);
+}
 
-	// graham scan algorithm
-	result.push_back(points[0]);
-	result.push_back(points[1]);
-	for (int i = 2; i < points.size(); i++)
+bool ConvexDecomposition(const vector<Vec2>& polygon, vector<vector<Vec2> >& result, int maxVertices)
+{
+	result.clear();
+	if (polygon.size() < 3) return false;
+	vector<int> indices, offsets;
+	if (!ConvexDecompositionXY(&polygon[0].x, polygon.size(), indices, offsets, maxVertices))return false;
+	for (size_t p = 0; p + 1 < offsets.size(); p++)
 	{
-		Vec2 *top1, *top2;
-
-		while (top1 = &result[result.size() - 1],
-			top2 = &result[result.size() - 2],
-			CrossVec2(*top2 - *top1, points[i] - *top1) <= 0)
-		{
-			result.pop_back();
-			if (result.size() < 2)break;
-		}
-		result.push_back(points[i]);
+		vector<Vec2> piece;
+		for (int i = offsets[p]; i < offsets[p + 1]; i++)piece.push_back(polygon[indices[i]]);
+		result.push_back(piece);
 	}
-
-	// output result, add back relative points offset
-	for (int i = 0; i < result.size(); i++)result[i] = result[i] + relativePoint;
-}
\ No newline at end of file
+	return true;
+}
@@ -2,6 +2,8 @@
 #define __GEOMETRIC_MATH_H__
 
 #include "cocos2d.h"
+#include "geometry/GeometricHull.h"
+#include "geometry/GeometricDecomposition.h"
 
 /**
  * Perpendicular Distance in 2D space
@@ -24,6 +26,20 @@ float PerpendicularDistance(cocos2d::Vec2 p, cocos2d::Vec2 begin, cocos2d::Vec2
  */
 void RamerDouglasPeucker(std::vector<cocos2d::Vec2>& points, float epsilon, std::vector<cocos2d::Vec2>& result);
 
+/**
+ * Visvalingam-Whyatt Algorithm
+ * Reducing the number of points in a curve to a vertex budget,
+ * the point forming the smallest triangle area with its neighbours is removed first
+ * @param points		points to be simplified
+ * @param maxVertices	vertex budget, at most maxVertices points are kept
+ * @param result		points after simplified, in original order
+ * @param minArea		points forming a triangle area smaller than minArea are removed
+ *						even if the budget is met, such as nearly collinear points
+ * @param closed		true if points form a closed polygon, false for an open path
+ *						whose end points are always kept
+ */
+void VisvalingamWhyatt(const std::vector<cocos2d::Vec2>& points, int maxVertices, std::vector<cocos2d::Vec2>& result, float minArea = 0.0f, bool closed = true);
+
 /**
  * Euclidean Distance
  * @param a	point A
@@ -67,9 +83,49 @@ cocos2d::Rect Intersection(const cocos2d::Rect& a, const cocos2d::Rect& b);
 
 /**
  * Calculate Convex Hull
+ * Andrew's monotone chain with exact orientation tests,
+ * collinear and duplicated points are not included in the hull
  * @param points	orignal points, with random shape
- * @param result	convex hull shape points 	
+ * @param result	convex hull shape points, sorted by clockwise, starting at the leftmost-lowest point
+ * @see ConvexHullXY
+ */
+void ConvexHull(const std::vector<cocos2d::Vec2>& points, std::vector<cocos2d::Vec2>& result);
+
+/**
+ * Signed Area of a simple polygon
+ * @param polygon	polygon points
+ * @return positive if points are in anti-clockwise order, negative if clockwise
+ */
+float SignedArea(const std::vector<cocos2d::Vec2>& polygon);
+
+/**
+ * Check if a polygon is convex, collinear points are allowed
+ * @param polygon	polygon points, in anti-clockwise order
+ * @return true if every corner turns anti-clockwise or goes straight
+ */
+bool IsConvexPolygon(const std::vector<cocos2d::Vec2>& polygon);
+
+/**
+ * Triangulate a simple polygon by ear clipping
+ * Concave polygon is supported, self-intersecting polygon is not
+ * @param polygon	simple polygon points, in anti-clockwise order
+ * @param triangles	output, 3 indices into polygon per triangle, in anti-clockwise order
+ * @return true if polygon is triangulated, false if no ear is found (self-intersecting polygon)
+ * @see TriangulatePolygonXY
+ */
+bool TriangulatePolygon(const std::vector<cocos2d::Vec2>& polygon, std::vector<int>& triangles);
+
+/**
+ * Approximate Convex Decomposition, Hertel-Mehlhorn algorithm
+ * Triangulate polygon, then remove diagonals greedily
+ * as long as the two pieces sharing it still merge to a convex piece
+ * The result is at most 4 times the optimal number of convex pieces
+ * @param polygon		simple polygon points, in anti-clockwise order
+ * @param result		convex pieces, points in clockwise order
+ * @param maxVertices	max number of points per convex piece
+ * @return true if polygon is decomposed, false if polygon can not be triangulated
+ * @see ConvexDecompositionXY
  */
-void ConvexHull(std::vector<cocos2d::Vec2>& points, std::vector<cocos2d::Vec2>& result);
+bool ConvexDecomposition(const std::vector<cocos2d::Vec2>& polygon, std::vector<std::vector<cocos2d::Vec2> >& result, int maxVertices = 8);
 
 #endif	/* __GEOMETRIC_MATH_H__ */
\ No newline at end of file
@@ -1,77 +1,125 @@
 #include "geometry/GeometricPhysics.h"
 #include "geometry/GeometricMath.h"
-#include "geometry/delaunay/Clarkson-Delaunay.h"
+#include "geometry/GeometricKernelAdapter.h"
+#include "geometry/CollisionFilter.h"
+#include "geometry/delaunay/DivideConquer-Delaunay.h"
+#include "util/ParallelFor.h"
 
 USING_NS_CC;
 
-int PHYSICS_BODY_CONTACT_MASK = 0xFFFFFFFF;
-int PHYSICS_BODY_CATEGORY_MASK = 0xFFFFFFFF;
+// put recognized body on body layer, jointed composites are grouped later by makeJoints
+static void SetBodyCollisionFilter(PhysicsBody* physicsBody)
+{
+	auto filter = CollisionFilter::getInstance();
+	filter->apply(physicsBody, filter->getLayer(COLLISION_LAYER_BODY));
+}
 
-#define MAKE_PHYSICS_BODY_MASK(physicsBody)\
-do{\
-	(physicsBody)->setContactTestBitmask(PHYSICS_BODY_CONTACT_MASK); \
-	PHYSICS_BODY_CONTACT_MASK = PHYSICS_BODY_CONTACT_MASK << 1; \
-	(physicsBody)->setCategoryBitmask(PHYSICS_BODY_CATEGORY_MASK); \
-	PHYSICS_BODY_CATEGORY_MASK = PHYSICS_BODY_CATEGORY_MASK << 1; \
-}while(0)
+#define EPSILON 10.0f
+// max vertices of a single polygon shape
+#define POLYGON_VERTEX_BUDGET 8
+// vertices forming a triangle area smaller than this are negligible
+#define POLYGON_MIN_AREA (EPSILON * EPSILON / 2)
 
 vector<Vec2> makePolygonShape(const vector<Vec2>& strokePath, Vec2 baryCenter)
 {
-#define EPSILON 10.0f
-	int cnt = 0;
-	vector<Vec2> path, poly;
+	vector<Vec2> path, hull, poly;
 	// calculate stroke path relative location to it's bary center/centroid 
 	for (auto p = strokePath.begin(); p != strokePath.end(); p++)
 	{
 		path.push_back(*p - baryCenter);
 	}
-	Vec2 baryOffset;
-
-	// do until the number of points is no longer changed
-	do{
-		cnt = path.size();
-		poly.clear();
-
-		// simplified/reduce path by RamerDouglasPeucker algorithm 
-		RamerDouglasPeucker(path, EPSILON, poly);
-		if (cnt == poly.size())break;
-
-		// calculate convex hull for shape
-		vector<Vec2> res;
-		ConvexHull(poly, res);
-		poly = res;
-
-		// recalculate bary for new shape
-		Vec2 offset, nbary;
-		for (auto p = poly.begin(); p != poly.end(); p++)nbary += *p;
-		nbary = nbary / poly.size(); offset = baryOffset - nbary;
-		for (auto p = poly.begin(); p != poly.end(); p++)*p = *p + offset;
-		baryOffset = nbary;
-
-		// sort point by clock wise
-		sort(poly.begin(), poly.end(), PointClockwiseComparator);
-		path = poly;
-	} while (cnt != poly.size());
-
-	if (!poly.empty())
+	if (path.empty())return poly;
+
+	// calculate convex hull for shape, sorted by clock wise
+	ConvexHull(path, hull);
+
+	// reduce hull to the vertex budget by VisvalingamWhyatt algorithm,
+	// nearly collinear vertices are dropped as well
+	VisvalingamWhyatt(hull, POLYGON_VERTEX_BUDGET, poly, POLYGON_MIN_AREA, true);
+
+	return poly;
+}
+
+vector<Vec2> makeOutlineShape(const vector<Vec2>& strokePath, Vec2 baryCenter)
+{
+	// calculate stroke path relative location to it's bary center/centroid
+	// skip repeated points, such as a pen held still
+	vector<Vec2> path, poly;
+	for (auto p = strokePath.begin(); p != strokePath.end(); p++)
 	{
-		// restore with orignal bary center
-		for (auto p = poly.begin(); p != poly.end(); p++)
-		{
-			(*p) = (*p) + baryOffset;
-		}
+		Vec2 cur = *p - baryCenter;
+		if (path.empty() || path.back() != cur)path.push_back(cur);
 	}
-	cocos2d::log("make polygon shape end!");
 
+	// simplified/reduce path by RamerDouglasPeucker algorithm
+	RamerDouglasPeucker(path, EPSILON, poly);
+
+	// a closed stroke ends where it starts
+	while (poly.size() > 3 && EuclideanDistance(poly.front(), poly.back()) < EPSILON)poly.pop_back();
+
+	// sort point by anti-clockwise
+	if (SignedArea(poly) < 0)reverse(poly.begin(), poly.end());
 	return poly;
 }
 
-PhysicsBody* makePhysicsBodyAsPolygon(DrawableSprite* drawableSprite)
+void computePhysicsShapeData(const DrawableSprite* drawableSprite, PhysicsShapeData& data)
 {
-	auto _baryCenter = drawableSprite->getBaryCenter();
-	Vec2 offset = drawableSprite->getShapeCenter() - _baryCenter;
+	const auto& points = drawableSprite->getStrokes().points();
+	auto baryCenter = drawableSprite->getBaryCenter();
+	data.version = drawableSprite->getContentVersion();
+	data.offset = drawableSprite->getShapeCenter() - baryCenter;
+
 	// calculate a new polygon with approximate shape and less points
-	auto poly = makePolygonShape(drawableSprite->getPath(), _baryCenter);
+	auto path = drawableSprite->getPath();
+	data.polygon = makePolygonShape(path, baryCenter);
+
+	// decompose outline into convex pieces for makePhysicsBodyAsConvexPieces,
+	// a convex outline is a single piece, the same as polygon, so it's not decomposed
+	data.pieces.clear();
+	auto outline = makeOutlineShape(path, baryCenter);
+	if (!IsConvexPolygon(outline) && (!ConvexDecomposition(outline, data.pieces) || data.pieces.size() <= 1))data.pieces.clear();
+
+	// calculate the max/min raduis for sprite with ball shape
+	data.radiusMin = std::numeric_limits<float>::max();
+	data.radiusMax = 0;
+	GeometricKernel::DistanceRange(points.xs.data(), points.ys.data(), points.size(),
+		baryCenter.x, baryCenter.y, &data.radiusMin, &data.radiusMax);
+}
+
+void preparePhysicsShapeData(const vector<DrawableSprite*>& drawableSprites)
+{
+	vector<DrawableSprite*> pending;
+	for (auto p = drawableSprites.begin(); p != drawableSprites.end(); p++)
+	{
+		if (!(*p)->empty() && !(*p)->hasShapeData())pending.push_back(*p);
+	}
+
+	// compute on worker threads into plain data, sprites are only read
+	vector<PhysicsShapeData> results(pending.size());
+	ParallelFor(0, pending.size(), [&](int i)
+	{
+		computePhysicsShapeData(pending[i], results[i]);
+	});
+
+	// store on main thread
+	for (size_t i = 0; i < pending.size(); i++)pending[i]->setShapeData(results[i]);
+	cocos2d::log("prepared physics shape data: %d sprites", (int)pending.size());
+}
+
+// shape data prepared on sprite, or computed on calling thread if it's not up to date
+static const PhysicsShapeData& ShapeDataOf(DrawableSprite* drawableSprite, PhysicsShapeData& local)
+{
+	if (drawableSprite->hasShapeData())return drawableSprite->getShapeData();
+	computePhysicsShapeData(drawableSprite, local);
+	return local;
+}
+
+PhysicsBody* makePhysicsBodyAsPolygon(DrawableSprite* drawableSprite)
+{
+	PhysicsShapeData local;
+	const auto& data = ShapeDataOf(drawableSprite, local);
+	Vec2 offset = data.offset;
+	const auto& poly = data.polygon;
 
 	// copy polygon
 	Vec2* vers = new Vec2[poly.size()];
@@ -94,21 +142,17 @@ PhysicsBody* makePhysicsBodyAsPolygon(DrawableSprite* drawableSprite)
 	physicsBody->setMass(10);
 	// set linear damping
 	physicsBody->setLinearDamping(0.0f);
-	// set physics body mask
-	MAKE_PHYSICS_BODY_MASK(physicsBody);
-	//physicsBody->setContactTestBitmask(0xFFFFFFFF);
-	//physicsBody->setCategoryBitmask(0xFFFFFFFF)
-	//log("MASK1:%d", PHYSICS_BODY_CONTACT_MASK);
-	//log("MASK2:%d", PHYSICS_BODY_CATEGORY_MASK);
+	// set physics body collision filter
+	SetBodyCollisionFilter(physicsBody);
 	return physicsBody;
 }
 
 PhysicsBody* makePhysicsBodyAsPolygonWithTriangulation(DrawableSprite* drawableSprite)
 {
-	auto _baryCenter = drawableSprite->getBaryCenter();
-	Vec2 offset = drawableSprite->getShapeCenter() - _baryCenter;
-	// calculate a new polygon with approximate shape and less points
-	auto poly = makePolygonShape(drawableSprite->getPath(), _baryCenter);
+	PhysicsShapeData local;
+	const auto& data = ShapeDataOf(drawableSprite, local);
+	Vec2 offset = data.offset;
+	const auto& poly = data.polygon;
 	
 	// copy polygon
 	float* ivers = new float[poly.size() * 2];
@@ -123,28 +167,32 @@ PhysicsBody* makePhysicsBodyAsPolygonWithTriangulation(DrawableSprite* drawableS
 	// pressing i or d on the keyboard
 	int numTriangleVertices;   // OUTPUT, this does not need initialization
 
-	triangleIndexList = BuildTriangleIndexList((void*)ivers,	// The array of points
+	triangleIndexList = BuildTriangleIndexListParallel((void*)ivers,	// The array of points
 		1.0f,													// Multiplication factor. For testing: max random value
 		g_numTestPoints,										// The number of points
 		2,														// 2, the list is XY points, not XYZ points
 		1,														// 1, because I want the triangles clockwise
 		&numTriangleVertices);
-	Vec2* vers = new Vec2[numTriangleVertices];
-	for (int i = 0; i < numTriangleVertices; i++)
+
+	// make physics body by cocos2d::PhysicsBody::create
+	// every triangle is a convex shape of its own
+	cocos2d::log("make polygon physics body start!");
+	auto physicsBody = PhysicsBody::create();
+	for (int i = 0; i + 2 < numTriangleVertices; i += 3)
 	{
-		int idx = triangleIndexList[i];
-		vers[i] = Vec2(ivers[2 * idx], ivers[2 * idx + 1]);
+		Vec2 vers[3];
+		for (int j = 0; j < 3; j++)
+		{
+			int idx = triangleIndexList[i + j];
+			vers[j] = Vec2(ivers[2 * idx], ivers[2 * idx + 1]);
+		}
+		physicsBody->addShape(PhysicsShapePolygon::create(vers, 3, PHYSICSSHAPE_MATERIAL_DEFAULT, -offset));
 	}
 	free(triangleIndexList);
-
-	// make physics body by cocos2d::PhysicsBody::createPolygon
-	cocos2d::log("make polygon physics body start!");
-	auto physicsBody = PhysicsBody::createPolygon(vers, numTriangleVertices, PHYSICSBODY_MATERIAL_DEFAULT, -offset);
 	cocos2d::log("make polygon physics body end!");
 	
 	// delete vertex array
 	delete[] ivers;
-	delete[] vers;
 	
 	// get content rectangle
 	auto rect = drawableSprite->contentRect();
@@ -154,32 +202,55 @@ PhysicsBody* makePhysicsBodyAsPolygonWithTriangulation(DrawableSprite* drawableS
 	physicsBody->setMass((_xMax - _xMin)*(_yMax - _yMin));
 	// set linear damping
 	physicsBody->setLinearDamping(0.0f);
-	// set physics body mask
-	MAKE_PHYSICS_BODY_MASK(physicsBody);
+	// set physics body collision filter
+	SetBodyCollisionFilter(physicsBody);
 	
 	return physicsBody;
 }
 
-PhysicsBody* makePhysicsBodyAsBall(DrawableSprite* drawableSprite)
+PhysicsBody* makePhysicsBodyAsConvexPieces(DrawableSprite* drawableSprite)
 {
-	float radiusMax = 0;
-	float radiusMin = std::numeric_limits<float>::max();
-	auto _path = drawableSprite->getPath();
-	auto _baryCenter = drawableSprite->getBaryCenter();
+	PhysicsShapeData local;
+	const auto& data = ShapeDataOf(drawableSprite, local);
+	Vec2 offset = data.offset;
 
-	// calculate the max/min raduis for sprite with ball shape
-	for (auto p = _path.begin(); p != _path.end(); p++)
+	// convex pieces of a simplified outline, concave corners are kept
+	const auto& pieces = data.pieces;
+	if (pieces.empty())
 	{
-		float dx = p->x - _baryCenter.x;
-		float dy = p->y - _baryCenter.y;
-		float d = sqrt(dx*dx + dy*dy);
-		radiusMax = MAX(d, radiusMax);
-		radiusMin = MIN(d, radiusMin);
+		// self-intersecting or already convex, a convex hull is good enough
+		return makePhysicsBodyAsPolygon(drawableSprite);
 	}
 
+	// make physics body by cocos2d::PhysicsBody::create
+	// add every convex piece as a PhysicsShapePolygon, with the density of createPolygon,
+	// so moment is computed from pieces as it is from convex polygon
+	auto physicsBody = PhysicsBody::create();
+	for (auto p = pieces.begin(); p != pieces.end(); p++)
+	{
+		physicsBody->addShape(PhysicsShapePolygon::create(&p->front(), p->size(), PHYSICSBODY_MATERIAL_DEFAULT, -offset));
+	}
+	cocos2d::log("make convex pieces physics body: %d pieces", (int)pieces.size());
+
+	// same mass as convex polygon body
+	physicsBody->setMass(10);
+	// set linear damping
+	physicsBody->setLinearDamping(0.0f);
+	// set physics body collision filter
+	SetBodyCollisionFilter(physicsBody);
+
+	return physicsBody;
+}
+
+PhysicsBody* makePhysicsBodyAsBall(DrawableSprite* drawableSprite)
+{
+	// max/min raduis for sprite with ball shape
+	PhysicsShapeData local;
+	const auto& data = ShapeDataOf(drawableSprite, local);
+
 	// adjust shape center for physics body offset
-	Vec2 offset = drawableSprite->getShapeCenter() - _baryCenter;
-	float radius = (radiusMax + radiusMin) / 2;
+	Vec2 offset = data.offset;
+	float radius = (data.radiusMax + data.radiusMin) / 2;
 
 	// make physics body by cocos2d::PhysicsBody::createCircle
 	auto physicsBody = PhysicsBody::createCircle(radius, PHYSICSBODY_MATERIAL_DEFAULT, offset);
@@ -188,8 +259,8 @@ PhysicsBody* makePhysicsBodyAsBall(DrawableSprite* drawableSprite)
 	physicsBody->setMass(radius*radius*3.14f);
 	// set linear damping
 	physicsBody->setLinearDamping(0.0f);
-	// set physics body mask
-	MAKE_PHYSICS_BODY_MASK(physicsBody);
+	// set physics body collision filter
+	SetBodyCollisionFilter(physicsBody);
 	
 	return physicsBody;
 }
@@ -218,8 +289,8 @@ PhysicsBody* makePhysicsBodyAsTriangle(DrawableSprite* drawableSprite)
 	physicsBody->setMass((_xMax - _xMin)*(_yMax - _yMin) / 2);
 	// set linear damping
 	physicsBody->setLinearDamping(0.0f);
-	// set physics body mask
-	MAKE_PHYSICS_BODY_MASK(physicsBody);
+	// set physics body collision filter
+	SetBodyCollisionFilter(physicsBody);
 
 	return physicsBody;
 }
@@ -241,8 +312,8 @@ PhysicsBody* makePhysicsBodyAsBox(DrawableSprite* drawableSprite)
 	physicsBody->setMass((_xMax - _xMin)*(_yMax - _yMin));
 	// set linear damping
 	physicsBody->setLinearDamping(0.0f);
-	// set physics body mask
-	MAKE_PHYSICS_BODY_MASK(physicsBody);
+	// set physics body collision filter
+	SetBodyCollisionFilter(physicsBody);
 
 	return physicsBody;
 }
@@ -294,8 +365,8 @@ PhysicsBody* makePhysicsBodyAsGroove(DrawableSprite* drawableSprite)
 
 	// set mass by rectangle area size
 	physicsBody->setMass((_xMax - _xMin)*(_yMax - _yMin));
-	// set physics body mask
-	MAKE_PHYSICS_BODY_MASK(physicsBody);
+	// set physics body collision filter
+	SetBodyCollisionFilter(physicsBody);
 
 	return physicsBody;
 }
@@ -316,7 +387,6 @@ bool IsSnapedTo(DrawableSprite* a, DrawableSprite* b, float epsilon)
 
 void InitGeometricPhysicsMask()
 {
-	// initialize physics body mask
-	PHYSICS_BODY_CONTACT_MASK = 0xFFFFFFFF;
-	PHYSICS_BODY_CATEGORY_MASK = 0xFFFFFFFF;
+	// initialize collision layers and rules
+	CollisionFilter::getInstance()->reset();
 }
\ No newline at end of file
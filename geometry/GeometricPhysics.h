@@ -21,13 +21,42 @@ typedef vector<Joints> JointsList;
 
 /**
  * Make polygon shape by default
- * Auto detect a approximate polygon shape and make convex hull
+ * Auto detect a approximate polygon shape and make convex hull,
+ * the hull is reduced to a fixed vertex budget so that it fits a single physics shape
  * @param path			original polygon shape/stroke path		
  * @param baryCenter	centroid of polygon shape
- * @return				a approximate convex hull with points resampled, sorted by clockwise
+ * @return				a approximate convex hull with at most 8 points, sorted by clockwise
  */
 vector<cocos2d::Vec2> makePolygonShape(const vector<cocos2d::Vec2>& path, cocos2d::Vec2 baryCenter);
 
+/**
+ * Make outline shape
+ * Simplify stroke path to a simple polygon, concave corners are kept
+ * @param path			original polygon shape/stroke path
+ * @param baryCenter	centroid of polygon shape
+ * @return				a simplified outline relative to bary center, sorted by anti-clockwise
+ */
+vector<cocos2d::Vec2> makeOutlineShape(const vector<cocos2d::Vec2>& path, cocos2d::Vec2 baryCenter);
+
+/**
+ * Compute physics shape data
+ * Polygon, convex pieces and ball radius are computed from path, only path is read,
+ * so it's safe to compute for different sprites on different threads
+ * @param drawableSprite	a pointer to a existing drawable sprite object
+ * @param data				OUTPUT, computed shape data
+ * @see PhysicsShapeData
+ */
+void computePhysicsShapeData(const DrawableSprite* drawableSprite, PhysicsShapeData& data);
+
+/**
+ * Prepare physics shape data
+ * Shape data is computed on worker threads, and stored on each sprite,
+ * sprites with up to date shape data are skipped
+ * @param drawableSprites	sprites to be prepared
+ * @see computePhysicsShapeData
+ */
+void preparePhysicsShapeData(const vector<DrawableSprite*>& drawableSprites);
+
 /**
  * Make polygon shape by default
  * Auto detect a approximate polygon shape and make a convex physics body
@@ -49,6 +78,18 @@ cocos2d::PhysicsBody* makePhysicsBodyAsPolygon(DrawableSprite* drawableSprite);
  */
 cocos2d::PhysicsBody* makePhysicsBodyAsPolygonWithTriangulation(DrawableSprite* drawableSprite);
 
+/**
+ * Make polygon shape with convex decomposition
+ * Auto detect a approximate outline and decompose it into a handful of convex pieces,
+ * each piece is added as a separate PhysicsShapePolygon on one physics body.
+ * Fall back to makePhysicsBodyAsPolygon if the outline can not be decomposed
+ * @param drawableSprite	a pointer to a existing drawable sprite object
+ * @return					a pointer to PhysicsBody object which has a approximate concave shape
+ * @see ConvexDecomposition
+ * @see cocos2d::PhysicsBody
+ */
+cocos2d::PhysicsBody* makePhysicsBodyAsConvexPieces(DrawableSprite* drawableSprite);
+
 /**
  * Make polygon shape as ball/cycle shape
  * @param drawableSprite	a pointer to a existing drawable sprite object
@@ -102,7 +143,8 @@ cocos2d::PhysicsBody* makePhysicsBodyAsGroove(DrawableSprite* drawableSprite);
 bool IsSnapedTo(DrawableSprite* a, DrawableSprite* b, float epsilon = DEFAULT_SNAP_EPSILON);
 
 /**
- * Initialize physics body colison mask
+ * Initialize physics body collision filter, layers and rules are reset to built-in ones
+ * @see CollisionFilter
  */
 void InitGeometricPhysicsMask();
 
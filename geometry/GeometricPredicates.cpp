@@ -0,0 +1,55 @@
+#include "GeometricPredicates.h"
+
+// x = a + b exactly, with s the rounded sum and e the round-off error
+inline void TwoSum(double a, double b, double& s, double& e)
+{
+	s = a + b;
+	double bv = s - a;
+	double av = s - bv;
+	e = (a - av) + (b - bv);
+}
+
+// x = a * b exactly, with p the rounded product and e the round-off error
+inline void TwoProduct(double a, double b, double& p, double& e)
+{
+	p = a * b;
+	e = std::fma(a, b, -p);
+}
+
+// add b into expansion e of length n, components are kept in increasing magnitude
+// zero components are eliminated, return the new length
+static int GrowExpansion(double* e, int n, double b)
+{
+	int m = 0;
+	double q = b;
+	for (int i = 0; i < n; i++)
+	{
+		double s, err;
+		TwoSum(q, e[i], s, err);
+		q = s;
+		if (err != 0)e[m++] = err;
+	}
+	if (q != 0)e[m++] = q;
+	return m;
+}
+
+double Orient2DExact(double ax, double ay, double bx, double by, double cx, double cy)
+{
+	// det = ax*by - ay*bx + bx*cy - by*cx + cx*ay - cy*ax
+	double terms[6][2] = {
+		{ ax, by }, { -ay, bx },
+		{ bx, cy }, { -by, cx },
+		{ cx, ay }, { -cy, ax }
+	};
+	double e[12];
+	int n = 0;
+	for (int i = 0; i < 6; i++)
+	{
+		double p, err;
+		TwoProduct(terms[i][0], terms[i][1], p, err);
+		n = GrowExpansion(e, n, err);
+		n = GrowExpansion(e, n, p);
+	}
+	// sign of the largest component is the sign of the expansion
+	return n ? e[n - 1] : 0;
+}
@@ -0,0 +1,55 @@
+#ifndef __GEOMETRIC_PREDICATES_H__
+#define __GEOMETRIC_PREDICATES_H__
+
+#include <cmath>
+#include <cfloat>
+
+// error bound of the fast orientation determinant, (3 + 16 * eps) * eps, eps = 2^-53
+// see Shewchuk, "Adaptive Precision Floating-Point Arithmetic and Fast Robust Geometric Predicates"
+#define ORIENT2D_ERRBOUND ((3.0 + 8.0 * DBL_EPSILON) * DBL_EPSILON / 2)
+
+/**
+ * Exact orientation test in 2D space, evaluated with floating point expansions
+ * @see Orient2D
+ * @return a value with the exact sign of the determinant
+ */
+double Orient2DExact(double ax, double ay, double bx, double by, double cx, double cy);
+
+/**
+ * Adaptive precision orientation test in 2D space
+ * A fast floating point determinant is computed first, only when it is too close to zero
+ * to trust its sign, the determinant is evaluated again with exact arithmetic.
+ * The sign of the result is always exact, so nearly collinear points never flip side.
+ * @param ax, ay	point A
+ * @param bx, by	point B
+ * @param cx, cy	point C
+ * @return positive if A, B, C are in anti-clockwise order, negative if clockwise, zero if collinear
+ */
+inline double Orient2D(double ax, double ay, double bx, double by, double cx, double cy)
+{
+	double detleft = (ax - cx) * (by - cy);
+	double detright = (ay - cy) * (bx - cx);
+	double det = detleft - detright;
+
+	// if both sides have different signs, the sign of det is already exact
+	double detsum;
+	if (detleft > 0)
+	{
+		if (detright <= 0)return det;
+		detsum = detleft + detright;
+	}
+	else if (detleft < 0)
+	{
+		if (detright >= 0)return det;
+		detsum = -detleft - detright;
+	}
+	else return det;
+
+	// the fast determinant is far enough from zero
+	if (std::fabs(det) >= ORIENT2D_ERRBOUND * detsum)return det;
+
+	// nearly collinear, evaluate again exactly
+	return Orient2DExact(ax, ay, bx, by, cx, cy);
+}
+
+#endif	/* __GEOMETRIC_PREDICATES_H__ */
@@ -0,0 +1,305 @@
+#include "KinematicsSolver.h"
+#include <cfloat>
+#include <cmath>
+
+using namespace std;
+
+#define SUPPORT_TOLERANCE 3.0f		// max gap/overlap between a sliding body and its surface, in world units
+#define MIN_CONTACT_LENGTH 2.0f		// min length of a flat side lying on surface
+#define FLAT_SLOPE 0.0175f			// sine of the max slope of a horizontal plane, 1 degree
+#define CHECK_STEP 0.01f			// time step of motion checks, in seconds
+
+namespace
+{
+	struct Box
+	{
+		float minX, minY, maxX, maxY;
+	};
+
+	Box BoundsOf(const KinematicBody& body)
+	{
+		Box box = { FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX };
+		if (body.isCircle)
+		{
+			Box circle = { body.cx - body.radius, body.cy - body.radius, body.cx + body.radius, body.cy + body.radius };
+			return circle;
+		}
+		for (auto p = body.polygons.begin(); p != body.polygons.end(); p++)
+		{
+			for (size_t i = 0; i + 1 < p->size(); i += 2)
+			{
+				box.minX = fminf(box.minX, (*p)[i]);
+				box.maxX = fmaxf(box.maxX, (*p)[i]);
+				box.minY = fminf(box.minY, (*p)[i + 1]);
+				box.maxY = fmaxf(box.maxY, (*p)[i + 1]);
+			}
+		}
+		return box;
+	}
+
+	// overlap of boxes moved by (dxA, dyA) and (dxB, dyB), each shrunk by margin
+	bool Overlaps(const Box& a, float dxA, float dyA, const Box& b, float dxB, float dyB, float margin)
+	{
+		return a.minX + dxA + margin < b.maxX + dxB - margin && b.minX + dxB + margin < a.maxX + dxA - margin
+			&& a.minY + dyA + margin < b.maxY + dyB - margin && b.minY + dyB + margin < a.maxY + dyA - margin;
+	}
+
+	float Sign(float v)
+	{
+		return v < 0 ? -1.0f : 1.0f;
+	}
+
+	// a flat side of a body lying on an edge of a static body
+	struct Support
+	{
+		int		body;		// index of static body
+		float	ax, ay;		// edge start
+		float	tx, ty;		// edge direction
+		float	length;		// edge length
+		float	contact;	// middle of contact along edge, from edge start
+		float	gap;		// distance between body and edge, < 0 if overlapped
+	};
+
+	// find the edge a dynamic body lies on, false if there is none
+	bool FindSupport(const KinematicBody& body, const vector<KinematicBody>& bodies, float gx, float gy, Support& support)
+	{
+		bool found = false;
+		for (size_t b = 0; b < bodies.size(); b++)
+		{
+			if (!bodies[b].isStatic || bodies[b].isCircle)continue;
+			for (auto p = bodies[b].polygons.begin(); p != bodies[b].polygons.end(); p++)
+			{
+				int n = (int)p->size() / 2;
+				if (n < 3)continue;
+
+				// orientation decides outward normal
+				float area = 0;
+				for (int i = 0; i < n; i++)
+				{
+					int j = (i + 1) % n;
+					area += (*p)[i * 2] * (*p)[j * 2 + 1] - (*p)[j * 2] * (*p)[i * 2 + 1];
+				}
+				for (int i = 0; i < n; i++)
+				{
+					int j = (i + 1) % n;
+					float ax = (*p)[i * 2], ay = (*p)[i * 2 + 1];
+					float dx = (*p)[j * 2] - ax, dy = (*p)[j * 2 + 1] - ay;
+					float length = sqrtf(dx * dx + dy * dy);
+					if (length < MIN_CONTACT_LENGTH)continue;
+					float tx = dx / length, ty = dy / length;
+					float nx = area > 0 ? ty : -ty, ny = area > 0 ? -tx : tx;
+					// surface must face against gravity
+					if (nx * gx + ny * gy >= 0)continue;
+
+					// distance of body vertices to edge line
+					float dmin = FLT_MAX;
+					for (auto q = body.polygons.begin(); q != body.polygons.end(); q++)
+					{
+						for (size_t k = 0; k + 1 < q->size(); k += 2)dmin = fminf(dmin, ((*q)[k] - ax) * nx + ((*q)[k + 1] - ay) * ny);
+					}
+					if (fabsf(dmin) > SUPPORT_TOLERANCE || (found && fabsf(dmin) >= fabsf(support.gap)))continue;
+
+					// vertices close to the line form the contact side
+					float cmin = FLT_MAX, cmax = -FLT_MAX;
+					for (auto q = body.polygons.begin(); q != body.polygons.end(); q++)
+					{
+						for (size_t k = 0; k + 1 < q->size(); k += 2)
+						{
+							float rx = (*q)[k] - ax, ry = (*q)[k + 1] - ay;
+							if (rx * nx + ry * ny > dmin + SUPPORT_TOLERANCE)continue;
+							float s = rx * tx + ry * ty;
+							cmin = fminf(cmin, s);
+							cmax = fmaxf(cmax, s);
+						}
+					}
+					float contact = (cmin + cmax) / 2;
+					if (cmax - cmin < MIN_CONTACT_LENGTH || contact < 0 || contact > length)continue;
+
+					// edge direction points downhill, or to +x on a plane
+					if (ty > 0 || (ty == 0 && tx < 0))
+					{
+						ax += dx;
+						ay += dy;
+						tx = -tx;
+						ty = -ty;
+						contact = length - contact;
+					}
+					Support s = { (int)b, ax, ay, tx, ty, length, contact, dmin };
+					support = s;
+					found = true;
+				}
+			}
+		}
+		return found;
+	}
+}
+
+void KinematicMotion::velocity(double t, float& vx, float& vy) const
+{
+	if (type == KINEMATICS_VACUUM || type == KINEMATICS_NONE)
+	{
+		vx = (float)(vx0 + ax * t);
+		vy = (float)(vy0 + ay * t);
+		return;
+	}
+	float u = (float)(t < t1 ? u0 + a1 * t : a2 * (t - t1));
+	vx = u * tx;
+	vy = u * ty;
+}
+
+void KinematicMotion::displacement(double t, float& dx, float& dy) const
+{
+	if (type == KINEMATICS_VACUUM || type == KINEMATICS_NONE)
+	{
+		dx = (float)(vx0 * t + ax * t * t / 2);
+		dy = (float)(vy0 * t + ay * t * t / 2);
+		return;
+	}
+	double s;
+	if (t < t1)s = u0 * t + a1 * t * t / 2;
+	else s = u0 * (double)t1 + a1 * (double)t1 * t1 / 2 + a2 * (t - t1) * (t - t1) / 2;
+	dx = (float)(s * tx);
+	dy = (float)(s * ty);
+}
+
+KinematicsSolver::KinematicsSolver(float gx, float gy)
+:_gx(gx)
+, _gy(gy)
+{
+}
+
+bool KinematicsSolver::solve(const vector<KinematicBody>& bodies, float duration)
+{
+	_motions.clear();
+	vector<int> dynamics;
+	vector<Box> boxes(bodies.size());
+	vector<Support> supports;
+	for (size_t b = 0; b < bodies.size(); b++)
+	{
+		boxes[b] = BoundsOf(bodies[b]);
+		if (!bodies[b].isStatic)dynamics.push_back((int)b);
+	}
+
+	bool solved = true;
+	for (size_t d = 0; d < dynamics.size(); d++)
+	{
+		const KinematicBody& body = bodies[dynamics[d]];
+		KinematicMotion m = {};
+		m.vx0 = body.vx;
+		m.vy0 = body.vy;
+		m.validUntil = duration;
+		m.t1 = FLT_MAX;
+
+		Support s = {};
+		s.body = -1;
+		if (!body.isCircle && FindSupport(body, bodies, _gx, _gy, s))
+		{
+			// forces along & against surface
+			float nx = -s.ty, ny = s.tx;
+			if (nx * _gx + ny * _gy > 0)
+			{
+				nx = -nx;
+				ny = -ny;
+			}
+			float normal = -(body.mass * (_gx * nx + _gy * ny) + body.fx * nx + body.fy * ny);
+			float vn = body.vx * nx + body.vy * ny;
+			float speed = sqrtf(body.vx * body.vx + body.vy * body.vy);
+			// leaving or hitting surface has no closed form
+			if (normal > 0 && body.mass > 0 && fabsf(vn) <= 1e-3f * speed + 1e-3f)
+			{
+				float friction = body.friction * bodies[s.body].friction * normal / body.mass;
+				float drive = _gx * s.tx + _gy * s.ty + (body.fx * s.tx + body.fy * s.ty) / body.mass;
+				m.type = fabsf(s.ty) < FLAT_SLOPE ? KINEMATICS_PLANE : KINEMATICS_INCLINE;
+				m.tx = s.tx;
+				m.ty = s.ty;
+				m.u0 = body.vx * s.tx + body.vy * s.ty;
+
+				// friction opposes motion, or holds body still if drive is not larger
+				float rest = fabsf(drive) <= friction ? 0 : drive - Sign(drive) * friction;
+				if (fabsf(m.u0) <= 1e-3f * speed + 1e-3f)
+				{
+					m.u0 = 0;
+					m.a1 = rest;
+				}
+				else
+				{
+					m.a1 = drive - Sign(m.u0) * friction;
+					if (m.a1 * m.u0 < 0)
+					{
+						m.t1 = -m.u0 / m.a1;
+						m.a2 = rest;
+					}
+				}
+			}
+			else m.type = KINEMATICS_NONE;
+		}
+		else
+		{
+			// free only if nothing is near
+			m.type = KINEMATICS_VACUUM;
+			for (size_t b = 0; b < bodies.size(); b++)
+			{
+				if (bodies[b].isStatic && Overlaps(boxes[dynamics[d]], 0, 0, boxes[b], 0, 0, -SUPPORT_TOLERANCE))m.type = KINEMATICS_NONE;
+			}
+			if (body.mass > 0)
+			{
+				m.ax = _gx + body.fx / body.mass;
+				m.ay = _gy + body.fy / body.mass;
+			}
+			else m.type = KINEMATICS_NONE;
+		}
+		if (m.type == KINEMATICS_NONE)solved = false;
+		_motions.push_back(m);
+		supports.push_back(s);
+	}
+
+	// a body without closed form may hit any other, nothing is exact
+	if (!solved)
+	{
+		for (auto m = _motions.begin(); m != _motions.end(); m++)m->validUntil = 0;
+		return false;
+	}
+
+	// check motions until bodies touch each other, touch another static body, or slide off surface
+	int steps = (int)ceilf(duration / CHECK_STEP);
+	vector<float> dx(dynamics.size()), dy(dynamics.size());
+	vector<bool> valid(dynamics.size(), true);
+	for (int k = 1; k <= steps; k++)
+	{
+		float t = fminf(k * CHECK_STEP, duration);
+		for (size_t d = 0; d < dynamics.size(); d++)_motions[d].displacement(t, dx[d], dy[d]);
+		for (size_t d = 0; d < dynamics.size(); d++)
+		{
+			if (!valid[d])continue;
+			const Box& box = boxes[dynamics[d]];
+			bool ok = true;
+			if (supports[d].body >= 0)
+			{
+				float along = supports[d].contact + dx[d] * supports[d].tx + dy[d] * supports[d].ty;
+				ok = along >= 0 && along <= supports[d].length;
+			}
+			for (size_t b = 0; b < bodies.size() && ok; b++)
+			{
+				if (bodies[b].isStatic && (int)b != supports[d].body)ok = !Overlaps(box, dx[d], dy[d], boxes[b], 0, 0, SUPPORT_TOLERANCE / 2);
+			}
+			for (size_t e = 0; e < dynamics.size() && ok; e++)
+			{
+				if (e != d)ok = !Overlaps(box, dx[d], dy[d], boxes[dynamics[e]], dx[e], dy[e], SUPPORT_TOLERANCE / 2);
+			}
+			if (!ok)
+			{
+				valid[d] = false;
+				_motions[d].validUntil = t - CHECK_STEP;
+				solved = false;
+			}
+		}
+	}
+	return solved;
+}
+
+float KinematicsSolver::getValidUntil() const
+{
+	float t = FLT_MAX;
+	for (auto m = _motions.begin(); m != _motions.end(); m++)t = fminf(t, m->validUntil);
+	return _motions.empty() ? 0 : t;
+}
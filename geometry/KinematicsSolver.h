@@ -0,0 +1,118 @@
+#ifndef __KINEMATICS_SOLVER_H__
+#define __KINEMATICS_SOLVER_H__
+
+#include <vector>
+
+// motion types of a dynamic body
+#define KINEMATICS_NONE		0	// no closed form, simulate it
+#define KINEMATICS_VACUUM	1	// free motion, nothing touched
+#define KINEMATICS_PLANE	2	// sliding on a horizontal surface
+#define KINEMATICS_INCLINE	3	// sliding on an inclined surface
+
+/**
+ * Kinematic Body, plain description of a physics body at t=0
+ * Everything is in world units, friction is per body, contact friction is the product of both bodies
+ */
+struct KinematicBody
+{
+	bool							isStatic;	// true if body never moves
+	bool							isCircle;	// true if body is a circle, polygons are not used
+	std::vector<std::vector<float> >	polygons;	// world vertices x0,y0,x1,y1... of each polygon shape
+	float							cx, cy;		// circle center
+	float							radius;		// circle radius
+	float							mass;		// body mass
+	float							friction;	// body friction
+	float							vx, vy;		// initial velocity
+	float							fx, fy;		// constant applied force
+};
+
+/**
+ * Kinematic Motion, closed form motion of a dynamic body
+ * Free motion has a constant acceleration, sliding motion has up to two phases of constant acceleration
+ * along the surface, the second phase starts when friction stops the body.
+ */
+struct KinematicMotion
+{
+	int		type;			// KINEMATICS_*
+	float	validUntil;		// time the motion stops being exact, e.g. bodies touch or leave surface
+	float	tx, ty;			// surface direction, sliding motion only
+	float	vx0, vy0;		// initial velocity
+	float	ax, ay;			// acceleration of free motion
+	float	u0;				// initial speed along surface
+	float	a1;				// acceleration along surface of the first phase
+	float	t1;				// time the second phase starts, FLT_MAX if there is only one phase
+	float	a2;				// acceleration along surface of the second phase
+
+	/**
+	 * Get velocity at time t
+	 * @param t		time since t=0, in seconds
+	 * @param vx	OUTPUT, velocity
+	 * @param vy	OUTPUT, velocity
+	 */
+	void velocity(double t, float& vx, float& vy) const;
+
+	/**
+	 * Get displacement from t=0 at time t
+	 * @param t		time since t=0, in seconds
+	 * @param dx	OUTPUT, displacement
+	 * @param dy	OUTPUT, displacement
+	 */
+	void displacement(double t, float& dx, float& dy) const;
+};
+
+/**
+ * Kinematics Solver
+ * Detects the lesson scenarios, blocks in vacuum, on a horizontal plane and on an incline,
+ * with initial velocity, constant force and friction, and solves their motion in closed form.
+ * A body is sliding if a flat side lies on an upward facing edge of a static polygon,
+ * free if nothing is near it, otherwise it has no closed form.
+ * Motion is checked against other bodies and surface ends, validUntil is where it stops being exact.
+ * Bodies are assumed not to rotate, circles are only solved in vacuum since they roll on surfaces.
+ */
+class KinematicsSolver
+{
+public:
+
+	/**
+	 * Constructor
+	 * @param gx	gravity
+	 * @param gy	gravity
+	 */
+	KinematicsSolver(float gx, float gy);
+
+	/**
+	 * Solve motion of dynamic bodies
+	 * @param bodies	bodies at t=0, static and dynamic
+	 * @param duration	time span to be checked, in seconds
+	 * @return true if every dynamic body has an exact motion over duration
+	 */
+	bool solve(const std::vector<KinematicBody>& bodies, float duration);
+
+	/**
+	 * Get the number of dynamic bodies
+	 */
+	int getMotionCount() const
+	{
+		return (int)_motions.size();
+	}
+
+	/**
+	 * Get motion of a dynamic body
+	 * @param index	dynamic body index, by order in solved bodies
+	 */
+	const KinematicMotion& getMotion(int index) const
+	{
+		return _motions[index];
+	}
+
+	/**
+	 * Get the time all motions are exact until
+	 */
+	float getValidUntil() const;
+
+private:
+	float						_gx, _gy;	// gravity
+	std::vector<KinematicMotion>	_motions;	// motions of dynamic bodies
+};
+
+#endif	/* __KINEMATICS_SOLVER_H__ */
@@ -0,0 +1,22 @@
+#include "MaterialTable.h"
+
+using namespace std;
+
+// value of a body from a list, the last value is used beyond its length
+static float ValueOf(const vector<double>& values, int index, float defaultValue)
+{
+	if (values.empty())return defaultValue;
+	return (float)(index < (int)values.size() ? values[index] : values.back());
+}
+
+BodyMaterial MaterialTable::getDynamic(int index) const
+{
+	BodyMaterial m = { ValueOf(_friction, index, 0), ValueOf(_restitution, index, DEFAULT_RESTITUTION) };
+	return m;
+}
+
+BodyMaterial MaterialTable::getStatic() const
+{
+	BodyMaterial m = { STATIC_FRICTION, DEFAULT_RESTITUTION };
+	return m;
+}
@@ -0,0 +1,62 @@
+#ifndef __MATERIAL_TABLE_H__
+#define __MATERIAL_TABLE_H__
+
+#include <vector>
+
+#define DEFAULT_RESTITUTION 0.5f	// PHYSICSBODY_MATERIAL_DEFAULT restitution
+#define STATIC_FRICTION 1.0f		// friction of static bodies
+
+/**
+ * Body Material, set on every shape of a body
+ */
+struct BodyMaterial
+{
+	float friction;		// shape friction, contact friction is the product of both shapes
+	float restitution;	// shape restitution, contact restitution is the product of both shapes
+};
+
+/**
+ * Material Table
+ * Materials of dynamic bodies by order, from ToolLayer-style lists, the last value is used by the rest.
+ * Static bodies have friction 1, so a body sliding on a surface gets exactly its own friction.
+ * Materials are set once when bodies are made, instead of on every contact.
+ */
+class MaterialTable
+{
+public:
+
+	/**
+	 * Set friction list
+	 * @param friction	friction of dynamic bodies by order, 0 if empty
+	 */
+	void setFriction(const std::vector<double>& friction)
+	{
+		_friction = friction;
+	}
+
+	/**
+	 * Set restitution list
+	 * @param restitution	restitution of dynamic bodies by order, DEFAULT_RESTITUTION if empty
+	 */
+	void setRestitution(const std::vector<double>& restitution)
+	{
+		_restitution = restitution;
+	}
+
+	/**
+	 * Get material of a dynamic body
+	 * @param index	dynamic body index
+	 */
+	BodyMaterial getDynamic(int index) const;
+
+	/**
+	 * Get material of static bodies
+	 */
+	BodyMaterial getStatic() const;
+
+private:
+	std::vector<double>	_friction;		// friction of dynamic bodies
+	std::vector<double>	_restitution;	// restitution of dynamic bodies
+};
+
+#endif	/* __MATERIAL_TABLE_H__ */
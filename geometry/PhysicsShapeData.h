@@ -0,0 +1,30 @@
+#ifndef __PHYSICS_SHAPE_DATA_H__
+#define __PHYSICS_SHAPE_DATA_H__
+
+#include "cocos2d.h"
+
+/**
+ * Physics Shape Data
+ * Plain data computed from a drawn path, everything a physics body needs except the body itself.
+ * It holds no cocos2d object, so it can be computed on worker threads.
+ * Points are relative to bary center of the path.
+ */
+struct PhysicsShapeData
+{
+	// Constructor, not computed
+	PhysicsShapeData()
+	:version(0)
+	, radiusMin(0)
+	, radiusMax(0)
+	{
+	}
+
+	unsigned int								version;	// content version of the sprite it was computed from, 0 if not computed
+	cocos2d::Vec2								offset;		// shape center relative to bary center
+	std::vector<cocos2d::Vec2>					polygon;	// convex hull within vertex budget, sorted by clockwise
+	std::vector<std::vector<cocos2d::Vec2> >	pieces;		// convex pieces of outline, empty if outline is convex or invalid
+	float										radiusMin;	// min distance from path to bary center
+	float										radiusMax;	// max distance from path to bary center
+};
+
+#endif	/* __PHYSICS_SHAPE_DATA_H__ */
@@ -0,0 +1,69 @@
+#include "PhysicsWorldSnapshot.h"
+#include "chipmunk/chipmunk.h"
+
+USING_NS_CC;
+using namespace std;
+
+void PhysicsWorldSnapshot::capture(const vector<Node*>& nodes)
+{
+	_bodies.resize(nodes.size());
+	_joints.clear();
+	for (size_t i = 0; i < nodes.size(); i++)
+	{
+		PhysicsBodyState& s = _bodies[i];
+		memset(&s, 0, sizeof(s));
+		auto body = nodes[i]->getPhysicsBody();
+		if (!body)continue;
+
+		s.x = nodes[i]->getPositionX();
+		s.y = nodes[i]->getPositionY();
+		s.rotation = nodes[i]->getRotation();
+		Vec2 v = body->getVelocity();
+		s.vx = v.x;
+		s.vy = v.y;
+		s.angularVelocity = body->getAngularVelocity();
+
+		// accumulated force is not exposed by PhysicsBody
+		cpVect f = cpBodyGetForce(body->getCPBody());
+		s.fx = (float)f.x;
+		s.fy = (float)f.y;
+		s.torque = (float)cpBodyGetTorque(body->getCPBody());
+
+		for (auto j = body->getJoints().begin(); j != body->getJoints().end(); j++)
+		{
+			_joints.push_back((*j)->isEnabled() ? 1 : 0);
+		}
+	}
+}
+
+void PhysicsWorldSnapshot::restore(const vector<Node*>& nodes, int mask) const
+{
+	size_t joint = 0;
+	for (size_t i = 0; i < nodes.size() && i < _bodies.size(); i++)
+	{
+		const PhysicsBodyState& s = _bodies[i];
+		auto body = nodes[i]->getPhysicsBody();
+		if (!body)continue;
+
+		// body follows node transform before next step
+		if (mask & SNAPSHOT_TRANSFORM)
+		{
+			nodes[i]->setPosition(s.x, s.y);
+			nodes[i]->setRotation(s.rotation);
+		}
+		if (mask & SNAPSHOT_VELOCITY)
+		{
+			body->setVelocity(Vec2(s.vx, s.vy));
+			body->setAngularVelocity(s.angularVelocity);
+		}
+		if (mask & SNAPSHOT_FORCE)
+		{
+			cpBodySetForce(body->getCPBody(), cpv(s.fx, s.fy));
+			cpBodySetTorque(body->getCPBody(), s.torque);
+		}
+		for (auto j = body->getJoints().begin(); j != body->getJoints().end() && joint < _joints.size(); j++, joint++)
+		{
+			if (mask & SNAPSHOT_JOINT)(*j)->setEnable(_joints[joint] != 0);
+		}
+	}
+}
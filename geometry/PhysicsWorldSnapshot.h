@@ -0,0 +1,107 @@
+#ifndef __PHYSICS_WORLD_SNAPSHOT_H__
+#define __PHYSICS_WORLD_SNAPSHOT_H__
+
+#include "cocos2d.h"
+
+// restore masks, parts of body state to be restored
+#define SNAPSHOT_TRANSFORM	0x0001	// position & rotation
+#define SNAPSHOT_VELOCITY	0x0002	// linear & angular velocity
+#define SNAPSHOT_FORCE		0x0004	// applied force & torque
+#define SNAPSHOT_JOINT		0x0008	// joint enabled state
+#define SNAPSHOT_ALL		0x000F
+
+/**
+ * Physics Body State, plain data
+ */
+struct PhysicsBodyState
+{
+	float x, y;				// node position, in parent space
+	float rotation;			// node rotation, in degrees
+	float vx, vy;			// linear velocity
+	float angularVelocity;	// angular velocity
+	float fx, fy;			// applied force
+	float torque;			// applied torque
+};
+
+/**
+ * Physics World Snapshot
+ * States of simulated bodies captured into a compact buffer, restored in place without
+ * creating or destroying any sprite, body or joint.
+ * Bodies are identified by their order in the node list, capture and restore must use the same list.
+ */
+class PhysicsWorldSnapshot
+{
+public:
+
+	/**
+	 * Capture states of bodies attached to nodes
+	 * @param nodes	nodes with physics bodies, nodes without body are skipped but keep their slot
+	 */
+	void capture(const std::vector<cocos2d::Node*>& nodes);
+
+	/**
+	 * Restore states of bodies attached to nodes
+	 * @param nodes	nodes with physics bodies, the same list used to capture
+	 * @param mask	parts of state to be restored, SNAPSHOT_ALL by default
+	 */
+	void restore(const std::vector<cocos2d::Node*>& nodes, int mask = SNAPSHOT_ALL) const;
+
+	/**
+	 * Get state of a body
+	 * @param index	index of node in captured list
+	 */
+	const PhysicsBodyState& operator[](int index) const
+	{
+		return _bodies[index];
+	}
+
+	/**
+	 * Get state of a body, to be filled from somewhere else than capture
+	 * @param index	index of node in captured list
+	 */
+	PhysicsBodyState& operator[](int index)
+	{
+		return _bodies[index];
+	}
+
+	/**
+	 * Set the number of bodies, new states are zero, joint states are kept
+	 * @param count	number of bodies
+	 */
+	void resize(int count)
+	{
+		PhysicsBodyState zero = {};
+		_bodies.resize(count, zero);
+	}
+
+	/**
+	 * Get the number of captured bodies
+	 */
+	int size() const
+	{
+		return (int)_bodies.size();
+	}
+
+	/**
+	 * Check if nothing is captured
+	 */
+	bool empty() const
+	{
+		return _bodies.empty();
+	}
+
+	/**
+	 * Remove captured states
+	 */
+	void clear()
+	{
+		_bodies.clear();
+		_joints.clear();
+	}
+
+private:
+	std::vector<PhysicsBodyState>	_bodies;	// body states, by node order
+	std::vector<unsigned char>		_joints;	// joint enabled states, by node order then joint order
+};
+
+#endif	/* __PHYSICS_WORLD_SNAPSHOT_H__ */
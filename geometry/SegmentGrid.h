@@ -0,0 +1,179 @@
+#ifndef __SEGMENT_GRID_H__
+#define __SEGMENT_GRID_H__
+
+#include <vector>
+#include <cmath>
+#include <cfloat>
+
+/**
+ * Segment Grid
+ * Segments of polylines bucketed into horizontal bands by their y range,
+ * so that point in polygon and distance tests only visit the segments near the point.
+ * Points of all polylines are in one buffer, polyline k starts at offsets[k].
+ * Segment i connects point i and i + 1 of the same polyline, there is no segment between polylines.
+ * A polyline whose ends are close is closed, its last segment goes back to its first point.
+ * This header has no dependency on cocos2d.
+ */
+class SegmentGrid
+{
+public:
+
+	/**
+	 * Constructor
+	 * @param bandHeight	height of a horizontal band
+	 */
+	explicit SegmentGrid(float bandHeight = 16.0f)
+		:_bandHeight(bandHeight), _xs(nullptr), _ys(nullptr), _count(0), _lineCount(0), _yMin(0)
+	{
+	}
+
+	/**
+	 * Build grid over polylines, points are referenced but not copied
+	 * @param xs, ys		points of all polylines, must outlive the grid or until next build
+	 * @param count			the number of points
+	 * @param offsets		index of the first point of each polyline, ascending
+	 * @param lineCount		the number of polylines
+	 * @param closeDistance	a polyline of 3+ points is closed if its ends are within this distance
+	 */
+	void build(const float* xs, const float* ys, int count, const int* offsets, int lineCount, float closeDistance)
+	{
+		_xs = xs; _ys = ys; _count = count; _lineCount = lineCount;
+		_bands.clear();
+		_next.assign(count, -1);
+		_closed.assign(count, false);
+		_closing.assign(count, false);
+		if (count <= 0)return;
+
+		// link points of each polyline, closed ones back to their first point,
+		// a single point is a segment of zero length, so it's still measured
+		for (int k = 0; k < lineCount; k++)
+		{
+			int begin = offsets[k], end = k + 1 < lineCount ? offsets[k + 1] : count;
+			if (begin >= end)continue;
+			for (int i = begin; i + 1 < end; i++)_next[i] = i + 1;
+			float dx = xs[end - 1] - xs[begin], dy = ys[end - 1] - ys[begin];
+			bool closed = end - begin >= 3 && dx*dx + dy*dy <= closeDistance*closeDistance;
+			if (closed || end - begin == 1)_next[end - 1] = begin;
+			_closing[end - 1] = closed;
+			for (int i = begin; i < end; i++)_closed[i] = closed;
+		}
+
+		float yMin = ys[0], yMax = ys[0];
+		for (int i = 1; i < count; i++)
+		{
+			yMin = ys[i] < yMin ? ys[i] : yMin;
+			yMax = ys[i] > yMax ? ys[i] : yMax;
+		}
+		_yMin = yMin;
+		_bands.resize(band(yMax) + 1);
+
+		for (int i = 0; i < count; i++)
+		{
+			int j = _next[i];
+			if (j < 0)continue;
+			int b0 = band(ys[i] < ys[j] ? ys[i] : ys[j]);
+			int b1 = band(ys[i] < ys[j] ? ys[j] : ys[i]);
+			for (int b = b0; b <= b1; b++)_bands[b].push_back(i);
+		}
+	}
+
+	/**
+	 * Get the number of points the grid was built with
+	 */
+	int pointCount() const
+	{
+		return _count;
+	}
+
+	/**
+	 * Get the number of polylines the grid was built with
+	 */
+	int lineCount() const
+	{
+		return _lineCount;
+	}
+
+	/**
+	 * Point in polygon test by crossing number (even-odd rule) over closed polylines,
+	 * open polylines enclose nothing
+	 * @param px, py	point to be checked
+	 * @return true if the point is inside the polygons, false otherwise
+	 */
+	bool pointInPolygon(float px, float py) const
+	{
+		if (_count < 3 || py < _yMin)return false;
+		int b = band(py);
+		if (b >= (int)_bands.size())return false;
+
+		// only segments in the band of py can cross the horizontal line through p,
+		// and each of them is stored once in a band
+		bool inside = false;
+		const std::vector<int>& segs = _bands[b];
+		for (size_t k = 0; k < segs.size(); k++)
+		{
+			int i = segs[k], j = _next[i];
+			if (!_closed[i])continue;
+			if ((_ys[i] > py) != (_ys[j] > py)
+				&& px < _xs[i] + (py - _ys[i]) * (_xs[j] - _xs[i]) / (_ys[j] - _ys[i]))
+				inside = !inside;
+		}
+		return inside;
+	}
+
+	/**
+	 * Min distance from a point to the drawn segments, closing segments are not measured
+	 * @param px, py		fixed point
+	 * @param maxDistance	only segments within this distance are measured
+	 * @return min distance, FLT_MAX if no segment is within maxDistance
+	 */
+	float minDistance(float px, float py, float maxDistance) const
+	{
+		if (_count <= 0)return FLT_MAX;
+
+		int b0 = band(py - maxDistance), b1 = band(py + maxDistance);
+		b0 = b0 < 0 ? 0 : b0;
+		b1 = b1 >= (int)_bands.size() ? (int)_bands.size() - 1 : b1;
+
+		// a segment may be visited in several bands, that's fine for min
+		float best = FLT_MAX;
+		for (int b = b0; b <= b1; b++)
+		{
+			const std::vector<int>& segs = _bands[b];
+			for (size_t k = 0; k < segs.size(); k++)
+			{
+				int i = segs[k], j = _next[i];
+				if (_closing[i])continue;
+				float dx = _xs[j] - _xs[i], dy = _ys[j] - _ys[i];
+				float qx = px - _xs[i], qy = py - _ys[i];
+				float len2 = dx*dx + dy*dy;
+				float t = len2 > FLT_MIN ? (qx*dx + qy*dy) / len2 : 0;
+				t = t < 0 ? 0 : (t > 1 ? 1 : t);
+				float rx = qx - t*dx, ry = qy - t*dy;
+				float d2 = rx*rx + ry*ry;
+				best = d2 < best ? d2 : best;
+			}
+		}
+		best = std::sqrt(best);
+		return best <= maxDistance ? best : FLT_MAX;
+	}
+
+private:
+
+	int band(float y) const
+	{
+		return (int)std::floor((y - _yMin) / _bandHeight);
+	}
+
+	float							_bandHeight;	// height of a band
+	const float*					_xs;			// x coordinates of polyline points
+	const float*					_ys;			// y coordinates of polyline points
+	int								_count;			// the number of points
+	int								_lineCount;		// the number of polylines
+	float							_yMin;			// y of the lowest point, bottom of band 0
+	std::vector<std::vector<int> >	_bands;			// segment indices by band
+	std::vector<int>				_next;			// end point of segment i, -1 if point i ends an open polyline
+	std::vector<bool>				_closed;		// true if segment i belongs to a closed polyline
+	std::vector<bool>				_closing;		// true if segment i closes its polyline
+};
+
+#endif	/* __SEGMENT_GRID_H__ */
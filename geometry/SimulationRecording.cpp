@@ -0,0 +1,267 @@
+#include "SimulationRecording.h"
+#include <fstream>
+#include <cstring>
+#include <cmath>
+#include <climits>
+
+using namespace std;
+
+#define RECORDING_VERSION 1
+#define FIELD_COUNT 9
+
+namespace
+{
+	const char MAGIC[4] = { 'S', 'P', 'R', 'C' };
+
+	// recorded fields of body state and their quanta, values are stored as round(value * scale)
+	float PhysicsBodyState::* const FIELDS[FIELD_COUNT] = {
+		&PhysicsBodyState::x, &PhysicsBodyState::y, &PhysicsBodyState::rotation,
+		&PhysicsBodyState::vx, &PhysicsBodyState::vy, &PhysicsBodyState::angularVelocity,
+		&PhysicsBodyState::fx, &PhysicsBodyState::fy, &PhysicsBodyState::torque
+	};
+	const float SCALES[FIELD_COUNT] = {
+		64, 64, 100,		// 1/64 pixel, 0.01 degree
+		64, 64, 1000,		// 1/64 pixel/s, 0.001 rad/s
+		16, 16, 16
+	};
+
+	int quantize(float value, float scale)
+	{
+		double q = floor(value * (double)scale + 0.5);
+		if (q > INT_MAX)return INT_MAX;
+		if (q < INT_MIN)return INT_MIN;
+		return (int)q;
+	}
+
+	void writeVarint(vector<unsigned char>& out, unsigned int value)
+	{
+		while (value >= 0x80)
+		{
+			out.push_back((unsigned char)(value | 0x80));
+			value >>= 7;
+		}
+		out.push_back((unsigned char)value);
+	}
+
+	// zigzag maps small signed values to small unsigned values, 0,-1,1,-2 -> 0,1,2,3
+	void writeSigned(vector<unsigned char>& out, int value)
+	{
+		writeVarint(out, ((unsigned int)value << 1) ^ (unsigned int)(value >> 31));
+	}
+
+	bool readVarint(const vector<unsigned char>& in, size_t& pos, unsigned int& value)
+	{
+		value = 0;
+		for (int shift = 0; shift < 35; shift += 7)
+		{
+			if (pos >= in.size())return false;
+			unsigned char b = in[pos++];
+			value |= (unsigned int)(b & 0x7F) << shift;
+			if (!(b & 0x80))return true;
+		}
+		return false;
+	}
+
+	bool readSigned(const vector<unsigned char>& in, size_t& pos, int& value)
+	{
+		unsigned int u;
+		if (!readVarint(in, pos, u))return false;
+		value = (int)(u >> 1) ^ -(int)(u & 1);
+		return true;
+	}
+}
+
+SimulationRecorder::SimulationRecorder(int keyframeInterval)
+:_keyframeInterval(keyframeInterval < 1 ? 1 : keyframeInterval)
+, _bodyCount(0)
+, _steps(0)
+{
+}
+
+void SimulationRecorder::start(const PhysicsWorldSnapshot& initial, float timestep)
+{
+	_data.clear();
+	_steps = 0;
+	_bodyCount = initial.size();
+	_last.assign(_bodyCount * FIELD_COUNT, 0);
+
+	// header
+	_data.insert(_data.end(), MAGIC, MAGIC + 4);
+	writeVarint(_data, RECORDING_VERSION);
+	writeVarint(_data, _bodyCount);
+	writeVarint(_data, _keyframeInterval);
+	unsigned int bits;
+	memcpy(&bits, &timestep, sizeof(bits));
+	for (int i = 0; i < 4; i++)_data.push_back((unsigned char)(bits >> (i * 8)));
+
+	addStep(initial);
+}
+
+void SimulationRecorder::addEvent(int type, int value)
+{
+	if (_data.empty())return;
+	_data.push_back('E');
+	writeVarint(_data, type);
+	writeSigned(_data, value);
+}
+
+void SimulationRecorder::addStep(const PhysicsWorldSnapshot& snapshot)
+{
+	if (_data.empty() || snapshot.size() != _bodyCount)return;
+
+	_current.resize(_last.size());
+	for (int i = 0; i < _bodyCount; i++)
+	{
+		for (int f = 0; f < FIELD_COUNT; f++)
+		{
+			_current[i * FIELD_COUNT + f] = quantize(snapshot[i].*FIELDS[f], SCALES[f]);
+		}
+	}
+
+	bool keyframe = _steps % _keyframeInterval == 0;
+	_data.push_back(keyframe ? 'K' : 'D');
+	for (size_t i = 0; i < _current.size(); i++)
+	{
+		// delta is wrapped in 32 bits, decoding wraps it back
+		writeSigned(_data, keyframe ? _current[i] : (int)((unsigned int)_current[i] - (unsigned int)_last[i]));
+	}
+	_last.swap(_current);
+	_steps++;
+}
+
+bool SimulationRecorder::save(const string& path) const
+{
+	ofstream file(path.c_str(), ios::binary);
+	if (!file)return false;
+	file.write((const char*)_data.data(), _data.size());
+	return !file.fail();
+}
+
+SimulationPlayer::SimulationPlayer()
+:_bodyCount(0)
+, _keyframeInterval(1)
+, _timestep(0)
+, _step(-1)
+, _cursor(0)
+{
+}
+
+bool SimulationPlayer::open(const vector<unsigned char>& data)
+{
+	_data = data;
+	_frames.clear();
+	_events.clear();
+	_step = -1;
+
+	// header
+	size_t pos = 4;
+	unsigned int version, bodyCount, interval;
+	if (_data.size() < 4 || memcmp(_data.data(), MAGIC, 4) != 0)return false;
+	if (!readVarint(_data, pos, version) || version != RECORDING_VERSION)return false;
+	if (!readVarint(_data, pos, bodyCount) || !readVarint(_data, pos, interval) || interval == 0)return false;
+	if (pos + 4 > _data.size())return false;
+	unsigned int bits = 0;
+	for (int i = 0; i < 4; i++)bits |= (unsigned int)_data[pos++] << (i * 8);
+	memcpy(&_timestep, &bits, sizeof(bits));
+	_bodyCount = bodyCount;
+	_keyframeInterval = interval;
+
+	// index steps, values are skipped without being applied
+	size_t values = (size_t)_bodyCount * FIELD_COUNT;
+	while (pos < _data.size())
+	{
+		size_t start = pos;
+		while (pos < _data.size() && _data[pos] == 'E')
+		{
+			unsigned int type, value;
+			pos++;
+			if (!readVarint(_data, pos, type) || !readVarint(_data, pos, value))return false;
+		}
+		// trailing events without a step
+		if (pos >= _data.size())break;
+		if (_data[pos] != 'K' && _data[pos] != 'D')return false;
+		pos++;
+		for (size_t i = 0; i < values; i++)
+		{
+			unsigned int value;
+			if (!readVarint(_data, pos, value))return false;
+		}
+		_frames.push_back(start);
+	}
+	if (_frames.empty())return false;
+
+	_values.assign(values, 0);
+	_snapshot.resize(_bodyCount);
+	_cursor = _frames[0];
+	return next();
+}
+
+bool SimulationPlayer::load(const string& path)
+{
+	ifstream file(path.c_str(), ios::binary);
+	if (!file)return false;
+	vector<unsigned char> data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+	return open(data);
+}
+
+bool SimulationPlayer::next()
+{
+	if (_step + 1 >= (int)_frames.size())return false;
+	_events.clear();
+	return decode();
+}
+
+bool SimulationPlayer::seek(int step)
+{
+	if (_frames.empty())return false;
+	if (step < 0)step = 0;
+	if (step >= (int)_frames.size())step = (int)_frames.size() - 1;
+	_events.clear();
+
+	// continue from current step if it's on the way, otherwise start from keyframe
+	int keyframe = step - step % _keyframeInterval;
+	if (!(_step >= keyframe && _step <= step))
+	{
+		_step = keyframe - 1;
+		_cursor = _frames[keyframe];
+	}
+	while (_step < step)
+	{
+		if (!decode())return false;
+	}
+	return true;
+}
+
+bool SimulationPlayer::decode()
+{
+	size_t pos = _cursor;
+	while (pos < _data.size() && _data[pos] == 'E')
+	{
+		SimulationEvent e;
+		unsigned int type;
+		pos++;
+		if (!readVarint(_data, pos, type) || !readSigned(_data, pos, e.value))return false;
+		e.step = _step + 1;
+		e.type = type;
+		_events.push_back(e);
+	}
+	if (pos >= _data.size())return false;
+	bool keyframe = _data[pos++] == 'K';
+	for (size_t i = 0; i < _values.size(); i++)
+	{
+		int value;
+		if (!readSigned(_data, pos, value))return false;
+		_values[i] = keyframe ? value : (int)((unsigned int)_values[i] + (unsigned int)value);
+	}
+	_cursor = pos;
+	_step++;
+
+	for (int i = 0; i < _bodyCount; i++)
+	{
+		for (int f = 0; f < FIELD_COUNT; f++)
+		{
+			_snapshot[i].*FIELDS[f] = _values[i * FIELD_COUNT + f] / SCALES[f];
+		}
+	}
+	return true;
+}
@@ -0,0 +1,201 @@
+#ifndef __SIMULATION_RECORDING_H__
+#define __SIMULATION_RECORDING_H__
+
+#include "geometry/PhysicsWorldSnapshot.h"
+
+#define SIMULATION_KEYFRAME_INTERVAL 50	// steps between keyframes
+
+// recorded input event types
+#define SIMULATION_EVENT_GRAVITY		1	// gravity toggled, value is 1 if gravity is on
+#define SIMULATION_EVENT_PAUSE			2	// simulation paused/resumed, value is 1 if paused
+#define SIMULATION_EVENT_KEY_PRESSED	3	// key pressed, value is key code
+#define SIMULATION_EVENT_KEY_RELEASED	4	// key released, value is key code
+
+/**
+ * Simulation Event, a user input recorded before a step
+ */
+struct SimulationEvent
+{
+	int step;	// step the event happens before
+	int type;	// event type, SIMULATION_EVENT_*
+	int value;	// event value
+};
+
+/**
+ * Simulation Recorder
+ * Body states of every step are quantized and written to a compact binary stream,
+ * as zigzag varint deltas against the previous step, or as absolute values on keyframes.
+ * Quantized values are compared instead of floats, so decoding never drifts.
+ * Stream layout:
+ *   header	"SPRC", version, body count, keyframe interval, timestep
+ *   events	'E', type, value; events before the step they happen
+ *   frame	'K' with absolute values, or 'D' with deltas; 9 values per body
+ */
+class SimulationRecorder
+{
+public:
+
+	/**
+	 * Constructor
+	 * @param keyframeInterval	steps between keyframes
+	 */
+	SimulationRecorder(int keyframeInterval = SIMULATION_KEYFRAME_INTERVAL);
+
+	/**
+	 * Start a new recording, previous recording is dropped
+	 * @param initial	body states at t=0, written as keyframe of step 0
+	 * @param timestep	fixed timestep between steps, in seconds
+	 */
+	void start(const PhysicsWorldSnapshot& initial, float timestep);
+
+	/**
+	 * Record a user input, happens before the next step
+	 * @param type	event type, SIMULATION_EVENT_*
+	 * @param value	event value
+	 */
+	void addEvent(int type, int value);
+
+	/**
+	 * Record body states after a step
+	 * @param snapshot	body states, the same bodies as the initial snapshot
+	 */
+	void addStep(const PhysicsWorldSnapshot& snapshot);
+
+	/**
+	 * Get the number of recorded steps, step 0 included
+	 */
+	int getStepCount() const
+	{
+		return _steps;
+	}
+
+	/**
+	 * Get recorded stream
+	 */
+	const std::vector<unsigned char>& getData() const
+	{
+		return _data;
+	}
+
+	/**
+	 * Save recorded stream to file
+	 * @param path	file path
+	 * @return true if saved
+	 */
+	bool save(const std::string& path) const;
+
+private:
+	int							_keyframeInterval;	// steps between keyframes
+	int							_bodyCount;			// bodies per step
+	int							_steps;				// recorded steps
+	std::vector<int>			_last;				// quantized values of the last step
+	std::vector<int>			_current;			// quantized values of the step being written
+	std::vector<unsigned char>	_data;				// recorded stream
+};
+
+/**
+ * Simulation Player
+ * Decodes body states from a recorded stream without simulating,
+ * seeking decodes the nearest keyframe before target step and deltas after it.
+ * @see SimulationRecorder
+ */
+class SimulationPlayer
+{
+public:
+
+	// Constructor
+	SimulationPlayer();
+
+	/**
+	 * Open a recorded stream, positioned at step 0
+	 * @param data	recorded stream, copied
+	 * @return true if it's a valid stream
+	 */
+	bool open(const std::vector<unsigned char>& data);
+
+	/**
+	 * Open a recorded stream from file
+	 * @param path	file path
+	 * @return true if it's a valid stream
+	 */
+	bool load(const std::string& path);
+
+	/**
+	 * Decode the next step
+	 * @return false if the last step is reached
+	 */
+	bool next();
+
+	/**
+	 * Decode a step
+	 * @param step	target step, clamped to recorded steps
+	 * @return false if stream is not opened
+	 */
+	bool seek(int step);
+
+	/**
+	 * Get decoded body states of current step
+	 */
+	const PhysicsWorldSnapshot& getSnapshot() const
+	{
+		return _snapshot;
+	}
+
+	/**
+	 * Get events decoded by the last next/seek call
+	 */
+	const std::vector<SimulationEvent>& getEvents() const
+	{
+		return _events;
+	}
+
+	/**
+	 * Get current step
+	 */
+	int getStep() const
+	{
+		return _step;
+	}
+
+	/**
+	 * Get the number of recorded steps, step 0 included
+	 */
+	int getStepCount() const
+	{
+		return (int)_frames.size();
+	}
+
+	/**
+	 * Get fixed timestep between steps, in seconds
+	 */
+	float getTimestep() const
+	{
+		return _timestep;
+	}
+
+	/**
+	 * Get time of current step, in seconds
+	 */
+	double getTime() const
+	{
+		return _step * (double)_timestep;
+	}
+
+private:
+
+	// decode events and frame at _cursor into _values
+	bool decode();
+
+	int							_bodyCount;			// bodies per step
+	int							_keyframeInterval;	// steps between keyframes
+	float						_timestep;			// fixed timestep between steps
+	int							_step;				// current step, -1 if nothing decoded
+	size_t						_cursor;			// stream offset of the next step
+	std::vector<size_t>			_frames;			// stream offsets of steps, events included
+	std::vector<int>			_values;			// quantized values of current step
+	std::vector<unsigned char>	_data;				// recorded stream
+	PhysicsWorldSnapshot		_snapshot;			// decoded body states of current step
+	std::vector<SimulationEvent>	_events;		// events decoded by the last call
+};
+
+#endif	/* __SIMULATION_RECORDING_H__ */
@@ -0,0 +1,182 @@
+#ifndef __SPATIAL_GRID_H__
+#define __SPATIAL_GRID_H__
+
+#include <vector>
+#include <unordered_map>
+#include <cmath>
+
+/**
+ * Spatial Grid
+ * A uniform grid index over axis aligned bounding boxes, items are stored in every cell their bounds overlap.
+ * Queries only visit the cells overlapping the query area, instead of scanning all items.
+ * This header has no dependency on cocos2d.
+ * @param T	item type, must be hashable and comparable, such as a pointer
+ */
+template <typename T>
+class SpatialGrid
+{
+public:
+
+	/**
+	 * Constructor
+	 * @param cellSize	width & height of a grid cell
+	 */
+	explicit SpatialGrid(float cellSize = 64.0f)
+		:_cellSize(cellSize)
+	{
+	}
+
+	/**
+	 * Insert an item, or update its bounds if it's already in grid
+	 * @param item						item to be inserted
+	 * @param minX, minY, maxX, maxY	item bounds
+	 */
+	void insert(const T& item, float minX, float minY, float maxX, float maxY)
+	{
+		remove(item);
+		Bounds b = { minX, minY, maxX, maxY };
+		_items[item] = b;
+
+		int x0, y0, x1, y1;
+		cellRange(b, x0, y0, x1, y1);
+		for (int y = y0; y <= y1; y++)
+		{
+			for (int x = x0; x <= x1; x++)
+			{
+				_cells[cellKey(x, y)].push_back(item);
+			}
+		}
+	}
+
+	/**
+	 * Remove an item
+	 * @param item	item to be removed
+	 * @return true if the item was in grid, false otherwise
+	 */
+	bool remove(const T& item)
+	{
+		auto p = _items.find(item);
+		if (p == _items.end())return false;
+
+		int x0, y0, x1, y1;
+		cellRange(p->second, x0, y0, x1, y1);
+		for (int y = y0; y <= y1; y++)
+		{
+			for (int x = x0; x <= x1; x++)
+			{
+				auto c = _cells.find(cellKey(x, y));
+				if (c == _cells.end())continue;
+
+				// swap with the last one and pop, order in a cell is not kept
+				auto& list = c->second;
+				for (size_t i = 0; i < list.size(); i++)
+				{
+					if (list[i] == item)
+					{
+						list[i] = list.back();
+						list.pop_back();
+						break;
+					}
+				}
+				if (list.empty())_cells.erase(c);
+			}
+		}
+		_items.erase(p);
+		return true;
+	}
+
+	/**
+	 * Check if an item is in grid
+	 */
+	bool contains(const T& item) const
+	{
+		return _items.find(item) != _items.end();
+	}
+
+	/**
+	 * Find items whose bounds overlap the query area, each item is reported once
+	 * @param minX, minY, maxX, maxY	query area
+	 * @param result					OUTPUT, found items are appended
+	 */
+	void query(float minX, float minY, float maxX, float maxY, std::vector<T>& result) const
+	{
+		Bounds q = { minX, minY, maxX, maxY };
+		int x0, y0, x1, y1;
+		cellRange(q, x0, y0, x1, y1);
+		for (int y = y0; y <= y1; y++)
+		{
+			for (int x = x0; x <= x1; x++)
+			{
+				auto c = _cells.find(cellKey(x, y));
+				if (c == _cells.end())continue;
+				for (auto p = c->second.begin(); p != c->second.end(); p++)
+				{
+					const Bounds& b = _items.find(*p)->second;
+					if (b.maxX < minX || b.minX > maxX || b.maxY < minY || b.minY > maxY)continue;
+
+					// an item spanning several cells is only reported by
+					// the first cell shared by the item and the query area
+					int ix0, iy0, ix1, iy1;
+					cellRange(b, ix0, iy0, ix1, iy1);
+					if (x == (ix0 > x0 ? ix0 : x0) && y == (iy0 > y0 ? iy0 : y0))result.push_back(*p);
+				}
+			}
+		}
+	}
+
+	/**
+	 * Find items whose bounds contain a point
+	 * @param x, y		point to be checked
+	 * @param result	OUTPUT, found items are appended
+	 */
+	void queryPoint(float x, float y, std::vector<T>& result) const
+	{
+		query(x, y, x, y, result);
+	}
+
+	/**
+	 * Remove all items
+	 */
+	void clear()
+	{
+		_cells.clear();
+		_items.clear();
+	}
+
+	/**
+	 * Get the number of items
+	 */
+	int size() const
+	{
+		return (int)_items.size();
+	}
+
+private:
+
+	struct Bounds
+	{
+		float minX, minY, maxX, maxY;
+	};
+
+	int cellIndex(float v) const
+	{
+		return (int)std::floor(v / _cellSize);
+	}
+
+	void cellRange(const Bounds& b, int& x0, int& y0, int& x1, int& y1) const
+	{
+		x0 = cellIndex(b.minX); y0 = cellIndex(b.minY);
+		x1 = cellIndex(b.maxX); y1 = cellIndex(b.maxY);
+	}
+
+	static long long cellKey(int x, int y)
+	{
+		return ((long long)x << 32) ^ (unsigned int)y;
+	}
+
+	float									_cellSize;	// width & height of a cell
+	std::unordered_map<long long, std::vector<T> >	_cells;		// cell key-items map
+	std::unordered_map<T, Bounds>			_items;		// item-bounds map
+};
+
+#endif	/* __SPATIAL_GRID_H__ */
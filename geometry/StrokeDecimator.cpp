@@ -0,0 +1,88 @@
+#include "StrokeDecimator.h"
+
+USING_NS_CC;
+using namespace std;
+
+// distance from point p to the line segment a-b
+static float SegmentDistance(const Vec2& p, const Vec2& a, const Vec2& b)
+{
+	Vec2 d = b - a, q = p - a;
+	float len2 = d.x*d.x + d.y*d.y;
+	float t = len2 > 0 ? (q.x*d.x + q.y*d.y) / len2 : 0;
+	t = MAX(0.0f, MIN(1.0f, t));
+	return (q - d*t).length();
+}
+
+StrokeDecimator::StrokeDecimator(float tolerance, float minDistance, int maxWindow)
+:_tolerance(tolerance)
+, _minDistance(minDistance)
+, _maxWindow(MAX(maxWindow, 2))
+, _active(false)
+, _hasTail(false)
+{
+}
+
+void StrokeDecimator::setThresholds(float tolerance, float minDistance)
+{
+	_tolerance = tolerance;
+	_minDistance = minDistance;
+}
+
+void StrokeDecimator::begin(const Vec2& p, vector<Vec2>& out)
+{
+	_active = true;
+	_anchor = p;
+	_window.clear();
+	_hasTail = false;
+	out.push_back(p);
+}
+
+void StrokeDecimator::add(const Vec2& p, vector<Vec2>& out)
+{
+	if (!_active)return;
+
+	// drop points too close to the last kept one, but remember it for the stroke end
+	const Vec2& last = _window.empty() ? _anchor : _window.back();
+	if (p.distance(last) < _minDistance)
+	{
+		_tail = p;
+		_hasTail = true;
+		return;
+	}
+	_hasTail = false;
+	push(p, out);
+}
+
+void StrokeDecimator::end(vector<Vec2>& out)
+{
+	if (!_active)return;
+
+	// the last captured point ends the stroke, even if it's close to the previous one
+	if (_hasTail && (_window.empty() ? _anchor : _window.back()) != _tail)push(_tail, out);
+	if (!_window.empty())out.push_back(_window.back());
+
+	_active = false;
+	_window.clear();
+	_hasTail = false;
+}
+
+void StrokeDecimator::push(const Vec2& p, vector<Vec2>& out)
+{
+	_window.push_back(p);
+	int n = _window.size();
+	if (n < 2)return;
+
+	// check if all pending points can be replaced by line anchor-p
+	bool fit = n <= _maxWindow;
+	for (int i = 0; fit && i < n - 1; i++)
+	{
+		fit = SegmentDistance(_window[i], _anchor, p) <= _tolerance;
+	}
+	if (fit)return;
+
+	// otherwise, the point before p is kept and becomes the new anchor
+	_anchor = _window[n - 2];
+	out.push_back(_anchor);
+	_window.clear();
+	_window.push_back(p);
+}
@@ -0,0 +1,77 @@
+#ifndef __STROKE_DECIMATOR_H__
+#define __STROKE_DECIMATOR_H__
+
+#include "cocos2d.h"
+
+/**
+ * Stroke Decimator
+ * Simplify a stroke while it's being captured, points are fed one by one
+ * and only the points needed to keep the stroke shape are emitted.
+ * 1. points closer than minDistance to the last kept point are dropped
+ * 2. online Ramer-Douglas-Peucker with a bounded window: a point is emitted only when
+ *    the points since the last emitted one can no longer be replaced by a single line
+ *    within tolerance, or when the window is full
+ */
+class StrokeDecimator
+{
+public:
+
+	/**
+	 * Constructor
+	 * @param tolerance		max distance from a dropped point to the simplified stroke
+	 * @param minDistance	min distance between two kept points
+	 * @param maxWindow		max number of pending points before one is emitted
+	 */
+	StrokeDecimator(float tolerance = 1.0f, float minDistance = 2.0f, int maxWindow = 32);
+
+	/**
+	 * Set simplify thresholds, applied from the next stroke
+	 * @param tolerance		max distance from a dropped point to the simplified stroke, 0 keeps all points
+	 * @param minDistance	min distance between two kept points, 0 keeps all points
+	 */
+	void setThresholds(float tolerance, float minDistance);
+
+	/**
+	 * Begin a new stroke, the first point is always emitted
+	 * @param p		the first point
+	 * @param out	emitted points are appended
+	 */
+	void begin(const cocos2d::Vec2& p, std::vector<cocos2d::Vec2>& out);
+
+	/**
+	 * Add a point to current stroke
+	 * @param p		new point
+	 * @param out	emitted points are appended
+	 */
+	void add(const cocos2d::Vec2& p, std::vector<cocos2d::Vec2>& out);
+
+	/**
+	 * End current stroke, flush pending points, the last point is always emitted
+	 * @param out	emitted points are appended
+	 */
+	void end(std::vector<cocos2d::Vec2>& out);
+
+	/**
+	 * Check if a stroke is being captured
+	 */
+	bool active() const
+	{
+		return _active;
+	}
+
+private:
+
+	// feed a point into the window
+	void push(const cocos2d::Vec2& p, std::vector<cocos2d::Vec2>& out);
+
+	float						_tolerance;		// max distance from a dropped point to the simplified stroke
+	float						_minDistance;	// min distance between two kept points
+	int							_maxWindow;		// max number of pending points
+	bool						_active;		// true if a stroke is being captured
+	cocos2d::Vec2				_anchor;		// the last emitted point
+	std::vector<cocos2d::Vec2>	_window;		// pending points after anchor
+	cocos2d::Vec2				_tail;			// the last point dropped by minDistance
+	bool						_hasTail;		// true if tail is newer than window
+};
+
+#endif	/* __STROKE_DECIMATOR_H__ */
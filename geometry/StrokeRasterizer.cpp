@@ -0,0 +1,84 @@
+#include "StrokeRasterizer.h"
+#include <cmath>
+
+// draw capsule a-b with radius r, pixel centers are at (i + 0.5, j + 0.5)
+static void RasterizeCapsule(
+	float ax, float ay, float bx, float by, float r, const unsigned char rgba[4],
+	unsigned char* pixels, int stride, int width, int height)
+{
+	// pixels farther than r + 0.5 from the segment are not covered
+	float reach = r + 0.5f;
+	int x0 = (int)std::floor((ax < bx ? ax : bx) - reach);
+	int x1 = (int)std::ceil((ax < bx ? bx : ax) + reach);
+	int y0 = (int)std::floor((ay < by ? ay : by) - reach);
+	int y1 = (int)std::ceil((ay < by ? by : ay) + reach);
+	x0 = x0 < 0 ? 0 : x0;
+	y0 = y0 < 0 ? 0 : y0;
+	x1 = x1 > width ? width : x1;
+	y1 = y1 > height ? height : y1;
+
+	float dx = bx - ax, dy = by - ay;
+	float len2 = dx*dx + dy*dy;
+	float inv = len2 > 0 ? 1.0f / len2 : 0;
+
+	for (int j = y0; j < y1; j++)
+	{
+		unsigned char* row = pixels + j * stride;
+		float qy = j + 0.5f - ay;
+		for (int i = x0; i < x1; i++)
+		{
+			float qx = i + 0.5f - ax;
+			float t = (qx*dx + qy*dy) * inv;
+			t = t < 0 ? 0 : (t > 1 ? 1 : t);
+			float ex = qx - t*dx, ey = qy - t*dy;
+			float d = std::sqrt(ex*ex + ey*ey);
+
+			// coverage of a pixel is approximated by a one pixel linear ramp across the edge
+			float coverage = reach - d;
+			if (coverage <= 0)continue;
+			coverage = coverage > 1 ? 1 : coverage;
+
+			unsigned char alpha = (unsigned char)(coverage * rgba[3] + 0.5f);
+			unsigned char* p = row + i * 4;
+			if (alpha > p[3])
+			{
+				p[0] = rgba[0];
+				p[1] = rgba[1];
+				p[2] = rgba[2];
+				p[3] = alpha;
+			}
+		}
+	}
+}
+
+void RasterizePolyline(
+	const float* xs,
+	const float* ys,
+	int count,
+	float originX,
+	float originY,
+	float lineWidth,
+	const unsigned char rgba[4],
+	unsigned char* pixels,
+	int stride,
+	int width,
+	int height)
+{
+	if (count <= 0)return;
+	float r = lineWidth / 2;
+
+	if (count == 1)
+	{
+		float x = xs[0] - originX, y = ys[0] - originY;
+		RasterizeCapsule(x, y, x, y, r, rgba, pixels, stride, width, height);
+		return;
+	}
+
+	for (int i = 1; i < count; i++)
+	{
+		RasterizeCapsule(
+			xs[i - 1] - originX, ys[i - 1] - originY,
+			xs[i] - originX, ys[i] - originY,
+			r, rgba, pixels, stride, width, height);
+	}
+}
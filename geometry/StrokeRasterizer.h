@@ -0,0 +1,31 @@
+#ifndef __STROKE_RASTERIZER_H__
+#define __STROKE_RASTERIZER_H__
+
+/**
+ * Rasterize an antialiased polyline into a RGBA8888 image
+ * Each segment is drawn as a capsule, pixel coverage is estimated by the distance from pixel center
+ * to the segment, so joints and overlapping strokes are not blended twice: a pixel keeps the max alpha.
+ * Color is written without premultiplied alpha. This function has no dependency on cocos2d.
+ * @param xs, ys			polyline points, a single point is drawn as a dot
+ * @param count				the number of points
+ * @param originX, originY	the point mapped to the corner of pixel (0, 0), pixel rows go along +y
+ * @param lineWidth			line width in pixels
+ * @param rgba				line color, 4 bytes
+ * @param pixels			OUTPUT, the first pixel of target image
+ * @param stride			bytes per row of target image
+ * @param width, height		size of target image in pixels, nothing is drawn out of it
+ */
+void RasterizePolyline(
+	const float* xs,
+	const float* ys,
+	int count,
+	float originX,
+	float originY,
+	float lineWidth,
+	const unsigned char rgba[4],
+	unsigned char* pixels,
+	int stride,
+	int width,
+	int height);
+
+#endif	/* __STROKE_RASTERIZER_H__ */
@@ -0,0 +1,83 @@
+#include "StrokeTessellator.h"
+#include <cmath>
+
+// max miter length, in half widths
+#define MITER_LIMIT 2.0f
+
+// append triangle a-b-c
+static void PushTriangle(std::vector<float>& v, float ax, float ay, float bx, float by, float cx, float cy)
+{
+	v.push_back(ax); v.push_back(ay);
+	v.push_back(bx); v.push_back(by);
+	v.push_back(cx); v.push_back(cy);
+}
+
+// unit normal of segment a-b, zero if a and b are the same point
+static void SegmentNormal(float ax, float ay, float bx, float by, float& nx, float& ny)
+{
+	float dx = bx - ax, dy = by - ay;
+	float len = std::sqrt(dx*dx + dy*dy);
+	if (len > 0) { nx = -dy / len; ny = dx / len; }
+	else { nx = 0; ny = 0; }
+}
+
+int TessellatePolyline(const float* xs, const float* ys, int count, float halfWidth, std::vector<float>& vertices)
+{
+	if (count <= 0)return 0;
+
+	// a stroke with all points at the same location is a dot
+	bool dot = true;
+	for (int i = 1; i < count && dot; i++)dot = xs[i] == xs[0] && ys[i] == ys[0];
+
+	if (dot)
+	{
+		float x = xs[0], y = ys[0], r = halfWidth;
+		PushTriangle(vertices, x - r, y - r, x + r, y - r, x + r, y + r);
+		PushTriangle(vertices, x - r, y - r, x + r, y + r, x - r, y + r);
+		return 2;
+	}
+
+	// left & right side of the previous point
+	float plx = 0, ply = 0, prx = 0, pry = 0;
+	float pnx = 0, pny = 0;
+	int triangles = 0;
+	for (int i = 0; i < count; i++)
+	{
+		// normals of the segments before & after point i, end points use their only segment
+		float n0x = pnx, n0y = pny, n1x = 0, n1y = 0;
+		if (i + 1 < count)SegmentNormal(xs[i], ys[i], xs[i + 1], ys[i + 1], n1x, n1y);
+		if (i == 0) { n0x = n1x; n0y = n1y; }
+		if (i + 1 == count) { n1x = n0x; n1y = n0y; }
+		// a repeated point has no direction, keep the direction of the other segment
+		if (n1x == 0 && n1y == 0) { n1x = n0x; n1y = n0y; }
+		if (n0x == 0 && n0y == 0) { n0x = n1x; n0y = n1y; }
+
+		// miter direction, scaled so that both sides keep half width from the segments
+		float mx = n0x + n1x, my = n0y + n1y;
+		float mlen2 = mx*mx + my*my;
+		float scale = halfWidth;
+		if (mlen2 > 0)
+		{
+			float cosHalf = std::sqrt(mlen2) / 2;
+			float len = cosHalf > 1.0f / MITER_LIMIT ? halfWidth / cosHalf : halfWidth * MITER_LIMIT;
+			scale = len / std::sqrt(mlen2);
+		}
+		else
+		{
+			// the stroke turns back, offset along the incoming normal
+			mx = n0x; my = n0y;
+		}
+
+		float lx = xs[i] + mx * scale, ly = ys[i] + my * scale;
+		float rx = xs[i] - mx * scale, ry = ys[i] - my * scale;
+		if (i > 0)
+		{
+			PushTriangle(vertices, plx, ply, prx, pry, lx, ly);
+			PushTriangle(vertices, prx, pry, rx, ry, lx, ly);
+			triangles += 2;
+		}
+		plx = lx; ply = ly; prx = rx; pry = ry;
+		if (i + 1 < count && (n1x != 0 || n1y != 0)) { pnx = n1x; pny = n1y; }
+	}
+	return triangles;
+}
@@ -0,0 +1,19 @@
+#ifndef __STROKE_TESSELLATOR_H__
+#define __STROKE_TESSELLATOR_H__
+
+#include <vector>
+
+/**
+ * Tessellate a polyline into one joined triangle strip, emitted as a triangle list
+ * Each point is offset to both sides along the average normal of its segments (miter join),
+ * the miter is limited at sharp turns, so the line gets thinner there instead of spiking.
+ * This function has no dependency on cocos2d.
+ * @param xs, ys		polyline points, a polyline without length is emitted as a square dot
+ * @param count			the number of points
+ * @param halfWidth		half of line width
+ * @param vertices		OUTPUT, x, y of triangle vertices are appended, 6 floats per triangle
+ * @return the number of triangles appended
+ */
+int TessellatePolyline(const float* xs, const float* ys, int count, float halfWidth, std::vector<float>& vertices);
+
+#endif	/* __STROKE_TESSELLATOR_H__ */
@@ -0,0 +1,374 @@
+#include <math.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <deque>
+#include <thread>
+#include <vector>
+
+#include "DivideConquer-Delaunay.h"
+#include "Clarkson-Delaunay.h"
+
+/* ----------------------------------------------------------------------------
+	Divide-and-conquer Delaunay triangulation (Guibas & Stolfi, 1985)
+
+	Points are sorted lexicographically and split in halves, every half is
+	triangulated recursively, and the two triangulations are stitched together
+	along the seam by the "rising bubble" merge. Triangulation lives in a
+	quad-edge structure.
+
+	Unlike the Clarkson engine (which keeps its state in file statics), all state
+	lives in a DelaunayBuilder instance, so the two halves of a split can be
+	triangulated on different threads. Every thread allocates edges from its own
+	EdgePool, merges run on the parent thread once both halves are joined.
+   ---------------------------------------------------------------------------- */
+
+namespace
+{
+	struct SitePoint
+	{
+		double	x, y;	// location
+		int		index;	// index in the input point list
+	};
+
+	struct Edge
+	{
+		Edge*			next;	// next edge counter-clockwise around origin (onext)
+		int				org;	// origin site, -1 for dual edges
+		int				mark;	// visit mark used when triangles are collected
+		unsigned char	r;		// rotation index in quad-edge
+	};
+
+	struct QuadEdge
+	{
+		Edge	e[4];	// primal, dual, primal reversed, dual reversed
+		bool	alive;	// false after deleted by merge
+	};
+
+	typedef std::deque<QuadEdge> EdgePool;
+
+	inline Edge* Rot(Edge* e)		{ return e->r < 3 ? e + 1 : e - 3; }
+	inline Edge* InvRot(Edge* e)	{ return e->r > 0 ? e - 1 : e + 3; }
+	inline Edge* Sym(Edge* e)		{ return e->r < 2 ? e + 2 : e - 2; }
+	inline Edge* Onext(Edge* e)		{ return e->next; }
+	inline Edge* Oprev(Edge* e)		{ return Rot(Onext(Rot(e))); }
+	inline Edge* Lnext(Edge* e)		{ return Rot(Onext(InvRot(e))); }
+	inline Edge* Rprev(Edge* e)		{ return Onext(Sym(e)); }
+	inline int Org(Edge* e)			{ return e->org; }
+	inline int Dest(Edge* e)		{ return Sym(e)->org; }
+	inline QuadEdge* QuadOf(Edge* e){ return reinterpret_cast<QuadEdge*>(e - e->r); }
+
+	Edge* MakeEdge(EdgePool& pool, int org, int dest)
+	{
+		pool.push_back(QuadEdge());
+		QuadEdge& q = pool.back();
+		for (int i = 0; i < 4; i++)
+		{
+			q.e[i].r = (unsigned char)i;
+			q.e[i].org = -1;
+			q.e[i].mark = 0;
+		}
+		q.e[0].next = &q.e[0];
+		q.e[1].next = &q.e[3];
+		q.e[2].next = &q.e[2];
+		q.e[3].next = &q.e[1];
+		q.e[0].org = org;
+		q.e[2].org = dest;
+		q.alive = true;
+		return &q.e[0];
+	}
+
+	void Splice(Edge* a, Edge* b)
+	{
+		Edge* alpha = Rot(Onext(a));
+		Edge* beta = Rot(Onext(b));
+		std::swap(a->next, b->next);
+		std::swap(alpha->next, beta->next);
+	}
+
+	Edge* Connect(EdgePool& pool, Edge* a, Edge* b)
+	{
+		Edge* e = MakeEdge(pool, Dest(a), Org(b));
+		Splice(e, Lnext(a));
+		Splice(Sym(e), b);
+		return e;
+	}
+
+	void DeleteEdge(Edge* e)
+	{
+		Splice(e, Oprev(e));
+		Splice(Sym(e), Oprev(Sym(e)));
+		QuadOf(e)->alive = false;
+	}
+
+	class DelaunayBuilder
+	{
+	public:
+		DelaunayBuilder(const std::vector<SitePoint>& sites, int maxDepth, int grain)
+			:_sites(sites)
+			, _maxDepth(maxDepth)
+			, _grain(grain)
+			, _pools((size_t)2 << maxDepth)
+		{
+		}
+
+		/**
+		 * Triangulate all sites, write triangles as site index triples
+		 * @param triangles	output, 3 site indices per triangle, anti-clockwise
+		 */
+		void build(std::vector<int>& triangles)
+		{
+			triangulate(0, (int)_sites.size(), 1, 0, _pools[1]);
+			collect(triangles);
+		}
+
+	private:
+		typedef std::pair<Edge*, Edge*> HullEdges;
+
+		bool ccw(int a, int b, int c) const
+		{
+			const SitePoint &pa = _sites[a], &pb = _sites[b], &pc = _sites[c];
+			return (pb.x - pa.x)*(pc.y - pa.y) - (pb.y - pa.y)*(pc.x - pa.x) > 0;
+		}
+
+		bool rightOf(int x, Edge* e) const { return ccw(x, Dest(e), Org(e)); }
+		bool leftOf(int x, Edge* e) const { return ccw(x, Org(e), Dest(e)); }
+		bool valid(Edge* e, Edge* basel) const { return rightOf(Dest(e), basel); }
+
+		// true if site d lies inside the circle through anti-clockwise sites a, b, c
+		bool inCircle(int a, int b, int c, int d) const
+		{
+			const SitePoint &pa = _sites[a], &pb = _sites[b], &pc = _sites[c], &pd = _sites[d];
+			double adx = pa.x - pd.x, ady = pa.y - pd.y;
+			double bdx = pb.x - pd.x, bdy = pb.y - pd.y;
+			double cdx = pc.x - pd.x, cdy = pc.y - pd.y;
+			double alift = adx*adx + ady*ady;
+			double blift = bdx*bdx + bdy*bdy;
+			double clift = cdx*cdx + cdy*cdy;
+			return alift*(bdx*cdy - cdx*bdy)
+				+ blift*(cdx*ady - adx*cdy)
+				+ clift*(adx*bdy - bdx*ady) > 0;
+		}
+
+		/**
+		 * Triangulate sites in [lo, hi)
+		 * @return anti-clockwise hull edge out of the leftmost site,
+		 *         clockwise hull edge out of the rightmost site
+		 */
+		HullEdges triangulate(int lo, int hi, int node, int depth, EdgePool& pool)
+		{
+			int n = hi - lo;
+			if (n == 2)
+			{
+				Edge* a = MakeEdge(pool, lo, lo + 1);
+				return HullEdges(a, Sym(a));
+			}
+			if (n == 3)
+			{
+				Edge* a = MakeEdge(pool, lo, lo + 1);
+				Edge* b = MakeEdge(pool, lo + 1, lo + 2);
+				Splice(Sym(a), b);
+				if (ccw(lo, lo + 1, lo + 2))
+				{
+					Connect(pool, b, a);
+					return HullEdges(a, Sym(b));
+				}
+				else if (ccw(lo, lo + 2, lo + 1))
+				{
+					Edge* c = Connect(pool, b, a);
+					return HullEdges(Sym(c), c);
+				}
+				// collinear
+				return HullEdges(a, Sym(b));
+			}
+
+			int mid = lo + n / 2;
+			HullEdges left, right;
+			if (depth < _maxDepth && n >= 2 * _grain)
+			{
+				// triangulate left partition on a worker thread
+				std::thread worker([&]()
+				{
+					left = triangulate(lo, mid, 2 * node, depth + 1, _pools[2 * node]);
+				});
+				right = triangulate(mid, hi, 2 * node + 1, depth + 1, pool);
+				worker.join();
+			}
+			else
+			{
+				left = triangulate(lo, mid, 2 * node, depth + 1, pool);
+				right = triangulate(mid, hi, 2 * node + 1, depth + 1, pool);
+			}
+			return merge(left, right, pool);
+		}
+
+		// merge two adjacent triangulations along their seam
+		HullEdges merge(HullEdges left, HullEdges right, EdgePool& pool)
+		{
+			Edge *ldo = left.first, *ldi = left.second;
+			Edge *rdi = right.first, *rdo = right.second;
+
+			// compute the lower common tangent of both hulls
+			for (;;)
+			{
+				if (leftOf(Org(rdi), ldi)) ldi = Lnext(ldi);
+				else if (rightOf(Org(ldi), rdi)) rdi = Rprev(rdi);
+				else break;
+			}
+
+			Edge* basel = Connect(pool, Sym(rdi), ldi);
+			if (Org(ldi) == Org(ldo)) ldo = Sym(basel);
+			if (Org(rdi) == Org(rdo)) rdo = basel;
+
+			// rise the bubble, zip both sides up
+			for (;;)
+			{
+				Edge* lcand = Onext(Sym(basel));
+				if (valid(lcand, basel))
+				{
+					while (inCircle(Dest(basel), Org(basel), Dest(lcand), Dest(Onext(lcand))))
+					{
+						Edge* t = Onext(lcand);
+						DeleteEdge(lcand);
+						lcand = t;
+					}
+				}
+
+				Edge* rcand = Oprev(basel);
+				if (valid(rcand, basel))
+				{
+					while (inCircle(Dest(basel), Org(basel), Dest(rcand), Dest(Oprev(rcand))))
+					{
+						Edge* t = Oprev(rcand);
+						DeleteEdge(rcand);
+						rcand = t;
+					}
+				}
+
+				bool lvalid = valid(lcand, basel);
+				bool rvalid = valid(rcand, basel);
+				if (!lvalid && !rvalid) break;
+
+				if (!lvalid || (rvalid && inCircle(Dest(lcand), Org(lcand), Org(rcand), Dest(rcand))))
+				{
+					basel = Connect(pool, rcand, Sym(basel));
+				}
+				else
+				{
+					basel = Connect(pool, Sym(basel), Sym(lcand));
+				}
+			}
+			return HullEdges(ldo, rdo);
+		}
+
+		// walk every face, emit the anti-clockwise triangles
+		void collect(std::vector<int>& triangles)
+		{
+			for (auto pool = _pools.begin(); pool != _pools.end(); pool++)
+			{
+				for (auto q = pool->begin(); q != pool->end(); q++)
+				{
+					if (!q->alive) continue;
+					for (int i = 0; i < 4; i += 2)
+					{
+						Edge* a = &q->e[i];
+						if (a->mark) continue;
+						Edge* b = Lnext(a);
+						Edge* c = Lnext(b);
+						a->mark = 1;
+						if (Lnext(c) != a) continue;
+						b->mark = c->mark = 1;
+						if (ccw(Org(a), Org(b), Org(c)))
+						{
+							triangles.push_back(Org(a));
+							triangles.push_back(Org(b));
+							triangles.push_back(Org(c));
+						}
+					}
+				}
+			}
+		}
+
+		const std::vector<SitePoint>&	_sites;		// sorted, duplicate-free sites
+		int								_maxDepth;	// max recursion depth that spawns worker threads
+		int								_grain;		// min points of a partition handed to a worker thread
+		std::vector<EdgePool>			_pools;		// edge pools, indexed by recursion node
+	};
+
+	bool SiteLess(const SitePoint& a, const SitePoint& b)
+	{
+		return a.x < b.x || (a.x == b.x && a.y < b.y);
+	}
+}
+
+WORD *BuildTriangleIndexListParallel(
+	void *pointList,
+	float factor,
+	int numberOfInputPoints,
+	int numDimensions,
+	int clockwise,
+	int *numTriangleVertices,
+	int numThreads,
+	int grain)
+{
+	// this engine triangulates planar points only
+	if (numDimensions != 2)
+	{
+		return BuildTriangleIndexList(pointList, factor, numberOfInputPoints, numDimensions, clockwise, numTriangleVertices);
+	}
+
+	*numTriangleVertices = 0;
+	if (numberOfInputPoints < 3) return nullptr;
+
+	// load sites, keep index to the input list,
+	// floats are snapped to the same integer grid as the Clarkson engine
+	std::vector<SitePoint> sites(numberOfInputPoints);
+	for (int i = 0; i < numberOfInputPoints; i++)
+	{
+		if (factor)
+		{
+			sites[i].x = floor(((float*)pointList)[2 * i] * factor + 0.5);
+			sites[i].y = floor(((float*)pointList)[2 * i + 1] * factor + 0.5);
+		}
+		else
+		{
+			sites[i].x = ((int*)pointList)[2 * i];
+			sites[i].y = ((int*)pointList)[2 * i + 1];
+		}
+		sites[i].index = i;
+	}
+
+	// sort lexicographically, drop duplicated sites
+	std::stable_sort(sites.begin(), sites.end(), SiteLess);
+	sites.erase(std::unique(sites.begin(), sites.end(), [](const SitePoint& a, const SitePoint& b)
+	{
+		return a.x == b.x && a.y == b.y;
+	}), sites.end());
+	if (sites.size() < 3) return nullptr;
+
+	// one level of recursion doubles the number of workers
+	if (numThreads <= 0) numThreads = (int)std::thread::hardware_concurrency();
+	int maxDepth = 0;
+	while ((1 << maxDepth) < numThreads) maxDepth++;
+
+	std::vector<int> triangles;
+	DelaunayBuilder builder(sites, maxDepth, grain);
+	builder.build(triangles);
+
+	// output triangle list as input indices
+	WORD* indexList = (WORD*)malloc(sizeof(WORD) * (triangles.size() > 0 ? triangles.size() : 1));
+	int count = 0;
+	for (size_t i = 0; i < triangles.size(); i += 3)
+	{
+		int v0 = sites[triangles[i]].index;
+		int v1 = sites[triangles[i + 1]].index;
+		int v2 = sites[triangles[i + 2]].index;
+
+		// triangles are anti-clockwise now, reverse them if clockwise is wanted
+		if (clockwise > 0) std::swap(v1, v2);
+		indexList[count++] = (WORD)v0;
+		indexList[count++] = (WORD)v1;
+		indexList[count++] = (WORD)v2;
+	}
+	*numTriangleVertices = count;
+	return indexList;
+}
@@ -0,0 +1,50 @@
+#ifndef __DIVIDE_CONQUER_DELAUNAY_H__
+#define __DIVIDE_CONQUER_DELAUNAY_H__
+
+#ifndef WORD
+#define WORD  unsigned int
+#endif
+
+/**
+ * Minimum number of points in a partition before it is handed to a worker thread,
+ * smaller partitions are triangulated on the calling thread.
+ * sketch_headless --delaunay-benchmark times a split against the calling thread alone,
+ * on one core a split (thread spawn, join and seam merge) costs about 20-30us and a 256 point set
+ * takes about 170us, so from 512 points on a split costs about 15% of the work it hands over, less for larger sets.
+ * Re-run it on the target hardware before changing the grain, the crossover is where speedup passes 1.
+ * Sketch polygons are simplified to well under 512 points and stay on the calling thread,
+ * they are faster there.
+ */
+#define DELAUNAY_PARALLEL_GRAIN 256
+
+/**
+ * Build Delaunay triangle index list with a parallel divide-and-conquer engine
+ * Guibas-Stolfi divide-and-conquer: the point set is sorted and split spatially by x,
+ * partitions are triangulated on worker threads and merged along their seams.
+ * Same arguments and same output as BuildTriangleIndexList, so it can be used as a drop-in
+ * replacement for large point sets (scanned drawings, stippled outlines).
+ * Only XY points are triangulated by this engine, XYZ input is forwarded to BuildTriangleIndexList.
+ * @param pointList				array of float (factor != 0) or int (factor == 0) points
+ * @param factor				zero if pointList is a list of integers, otherwise floats are multiplied by it
+ *								and rounded to integers as BuildTriangleIndexList does,
+ *								points closer than 1/factor are merged
+ * @param numberOfInputPoints	the number of points in the list
+ * @param numDimensions			2 if the list is XY points, 3 if XYZ points
+ * @param clockwise				-1: anti-clockwise triangles, 0: don't care, 1: clockwise triangles
+ * @param numTriangleVertices	OUTPUT, the number of indices in the returned list
+ * @param numThreads			worker threads to use, 0 to use all hardware threads
+ * @param grain					min points of a partition handed to a worker thread, for benchmarks and tests
+ * @see BuildTriangleIndexList
+ * @return an array of triangle indices into pointList, the caller releases it with free()
+ */
+WORD *BuildTriangleIndexListParallel(
+	void *pointList,
+	float factor,
+	int numberOfInputPoints,
+	int numDimensions,
+	int clockwise,
+	int *numTriangleVertices,
+	int numThreads = 0,
+	int grain = DELAUNAY_PARALLEL_GRAIN);
+
+#endif	/* __DIVIDE_CONQUER_DELAUNAY_H__ */
@@ -2,6 +2,7 @@
 #include "gesture/GeometricRecognizer.h"
 #include "geometry/GeomtryType.h"
 #include "geometry/GeometricPhysics.h"
+#include "geometry/CollisionFilter.h"
 #include "geometry/Weapon.h"
 #include "geometry/GeometricMath.h"
 #include "controller/PawnController.h"
@@ -16,6 +17,27 @@ void handleDefaultWithPhysics(
 	void* udata,
 	PhysicsBody*(*pfMakePhysicsBody)(DrawableSprite*));
 
+// add a generated sprite to result map, index it by its bounds in owner space if indexed is true
+static void AddGenSprite(PostCommandData* data, DrawableSprite* drawNode, Sprite* sprite, bool indexed = true)
+{
+	data->resultMap->insert(pair<DrawableSprite*, Sprite*>(drawNode, sprite));
+	if (indexed)
+	{
+		Vec2 min = sprite->getPosition() - sprite->getContentSize() / 2;
+		Vec2 max = sprite->getPosition() + sprite->getContentSize() / 2;
+		data->spriteIndex->insert(sprite, min.x, min.y, max.x, max.y);
+	}
+}
+
+// get texture of a sketch from atlas, or render it if it's not in atlas
+static Texture2D* SketchTexture(PostCommandData* data, DrawableSprite* drawNode, Rect& rect)
+{
+	Texture2D* texture = data && data->atlas ? data->atlas->getTexture(drawNode, rect) : nullptr;
+	if (texture)return texture;
+	rect = drawNode->contentRect();
+	return drawNode->createTexture();
+}
+
 void CommandHandlerFactory::registerCommandHandler(const string& name, CommandHandler handler)
 {
 	auto p = _handlerMap.find(name);
@@ -57,14 +79,14 @@ bool PreCommandHandlerFactory::init()
 		Node* owner, 
 		void* udata)
 	{
-		DrawSpriteResultMap* rmap = static_cast<DrawSpriteResultMap*>(udata);
-		if (rmap)
+		PreCommandData* data = static_cast<PreCommandData*>(udata);
+		if (data)
 		{
 			// defualt priority is 5
 			// set a lower priority so that Spring can attach to other
 			// existing object drawn after it
 			recSprite._priority = 4;
-			rmap->insert(pair<DrawableSprite*, RecognizedSprite>(recSprite._drawNode, recSprite));
+			data->resultMap->insert(pair<DrawableSprite*, RecognizedSprite>(recSprite._drawNode, recSprite));
 		}
 	});
 
@@ -75,14 +97,14 @@ bool PreCommandHandlerFactory::init()
 		Node* owner, 
 		void* udata)
 	{
-		DrawSpriteResultMap* rmap = static_cast<DrawSpriteResultMap*>(udata);
-		if (rmap)
+		PreCommandData* data = static_cast<PreCommandData*>(udata);
+		if (data)
 		{
 			// defualt priority is 5
 			// set a lower priority so that Pistal can attach to other 
 			// existing object drawn after it, such as a gunman
 			recSprite._priority = 4;
-			rmap->insert(pair<DrawableSprite*, RecognizedSprite>(recSprite._drawNode, recSprite));
+			data->resultMap->insert(pair<DrawableSprite*, RecognizedSprite>(recSprite._drawNode, recSprite));
 		}
 	});
 
@@ -93,11 +115,11 @@ bool PreCommandHandlerFactory::init()
 		Node* owner,
 		void* udata)
 	{
-		DrawSpriteResultMap* rmap = static_cast<DrawSpriteResultMap*>(udata);
-		if (rmap)
+		PreCommandData* data = static_cast<PreCommandData*>(udata);
+		if (data)
 		{
 			recSprite._priority = 1;
-			rmap->insert(pair<DrawableSprite*, RecognizedSprite>(recSprite._drawNode, recSprite));
+			data->resultMap->insert(pair<DrawableSprite*, RecognizedSprite>(recSprite._drawNode, recSprite));
 		}
 	});
 
@@ -108,29 +130,23 @@ bool PreCommandHandlerFactory::init()
 		Node* owner,
 		void* udata)
 	{
-		DrawSpriteResultMap* rmap = static_cast<DrawSpriteResultMap*>(udata);
-		if (rmap)
+		PreCommandData* data = static_cast<PreCommandData*>(udata);
+		if (data)
 		{
 			// iterate result map to find other control symbol
 			// just remove it if find, transfer control to current sprite
-			auto p = rmap->begin();
-			while (p != rmap->end())
+			vector<DrawableSprite*> controls;
+			for (auto p = data->resultMap->begin(); p != data->resultMap->end(); p++)
 			{
 				auto& rs = p->second;
-				if ((recSprite._drawNode != rs._drawNode) && rs.isType(GT_MARK_CONCTROL))
-				{
-					owner->removeChild(rs._drawNode);
-					drawNodeList.remove(rs._drawNode);
-					auto to_erase = p;
-					++p;
-					rmap->erase(to_erase);
-				}
-				++p;
+				if ((recSprite._drawNode != rs._drawNode) && rs.isType(GT_MARK_CONCTROL))controls.push_back(rs._drawNode);
 			}
+			// owner removes them from result map, node list and index
+			for (auto i = controls.begin(); i != controls.end(); i++)owner->removeChild(*i);
 			
 			// lower priority to make sure other sprite can be generated before this
 			recSprite._priority = 1;
-			rmap->insert(pair<DrawableSprite*, RecognizedSprite>(recSprite._drawNode, recSprite));
+			data->resultMap->insert(pair<DrawableSprite*, RecognizedSprite>(recSprite._drawNode, recSprite));
 		}
 	});
 
@@ -141,28 +157,19 @@ bool PreCommandHandlerFactory::init()
 		Node* owner,
 		void* udata)
 	{
-		RecognitionResult& result = recSprite._result;
+		PreCommandData* data = static_cast<PreCommandData*>(udata);
 		DrawableSprite* currentDrawNode = recSprite._drawNode;
-		Vec2 position = currentDrawNode->getShapeCenter();
 
-		// iterate all sprites 
+		// query sprites overlapping this delete symbol
 		// remove other sprite when this delete symbol IsSnappedTo other sprite
-		for (auto i = drawNodeList.begin(); i != drawNodeList.end(); i++)
+		vector<DrawableSprite*> candidates;
+		if (data)QueryDrawNodes(*data->drawNodeIndex, currentDrawNode->contentRect(), candidates);
+		for (auto i = candidates.begin(); i != candidates.end(); i++)
 		{
-			if (*i != currentDrawNode)
-			{
-				Vec2 candinate = (*i)->getShapeCenter();
-				if (IsSnapedTo(currentDrawNode, *i))
-				{
-					DrawSpriteResultMap* rmap = static_cast<DrawSpriteResultMap*>(udata);
-					if (rmap && rmap->end() != rmap->find(*i))rmap->erase(*i);
-					owner->removeChild(*i);
-					i = drawNodeList.erase(i);
-				}
-			}
+			// owner removes it from result map, node list and index
+			if (*i != currentDrawNode && IsSnapedTo(currentDrawNode, *i))owner->removeChild(*i);
 		}
 		// remove itself
-		drawNodeList.remove(currentDrawNode);
 		owner->removeChild(currentDrawNode);
 	});
 
@@ -176,10 +183,10 @@ void PreCommandHandlerFactory::handleDefault(
 	void* udata)
 {
 	// just add to result map, with defualt priority
-	DrawSpriteResultMap* rmap = static_cast<DrawSpriteResultMap*>(udata);
-	if (rmap)
+	PreCommandData* data = static_cast<PreCommandData*>(udata);
+	if (data)
 	{
-		rmap->insert(pair<DrawableSprite*, RecognizedSprite>(recSprite._drawNode, recSprite));
+		data->resultMap->insert(pair<DrawableSprite*, RecognizedSprite>(recSprite._drawNode, recSprite));
 	}
 }
 
@@ -201,11 +208,11 @@ bool PostCommandHandlerFactory::init()
 		Node* owner,
 		void* udata)
 	{
-		GenSpriteResultMap* rmap = static_cast<GenSpriteResultMap*>(udata);
-		RecognitionResult& result = recSprite._result;
+		PostCommandData* data = static_cast<PostCommandData*>(udata);
 		DrawableSprite* ds = recSprite._drawNode;
 		Vec2 position = ds->getShapeCenter();
-		auto sprite = Sprite::createWithTexture(ds->createTexture(), ds->contentRect());
+		Rect rect;
+		auto sprite = Sprite::createWithTexture(SketchTexture(data, ds, rect), rect);
 
 		sprite->setPosition(position);
 		sprite->setFlippedY(true);
@@ -215,7 +222,7 @@ bool PostCommandHandlerFactory::init()
 		pb->setTag(TRIANGLE_TAG);
 		pb->setDynamic(false);
 		owner->addChild(sprite);
-		if (rmap)rmap->insert(pair<DrawableSprite*, Sprite*>(recSprite._drawNode, sprite));
+		if (data)AddGenSprite(data, recSprite._drawNode, sprite);
 
 	});
 
@@ -252,45 +259,44 @@ bool PostCommandHandlerFactory::init()
 		RecognitionResult& result = recSprite._result;
 		DrawableSprite* ds = recSprite._drawNode;
 		Vec2 position = ds->getShapeCenter();
-		auto sprite = Sprite::createWithTexture(ds->createTexture(), ds->contentRect());
+		PostCommandData* data = static_cast<PostCommandData*>(udata);
+		Rect rect;
+		auto sprite = Sprite::createWithTexture(SketchTexture(data, ds, rect), rect);
 		sprite->setPosition(position);
 		sprite->setFlippedY(true);
 
 		// attach sprite to it's parent sprite/scene
 		owner->addChild(sprite);
 
-		GenSpriteResultMap* rmap = static_cast<GenSpriteResultMap*>(udata);
-		if (rmap)
+		if (data)
 		{
 			vector<Sprite*> targets(2);
 			vector<Vec2> anchors(2);
 			int cnt = 0;
-			auto path = ds->getPath();
-			auto first = path.front();
-			auto end = path.back();
-
-			for (auto p = rmap->begin(); p != rmap->end(); p++)
+			const auto& strokes = ds->getStrokes();
+			auto first = strokes.stroke(0).front();
+			auto end = strokes.back();
+
+			// generated sprites are indexed by their rectangle area,
+			// so sprites found contain one of the spring side points.
+			vector<Sprite*> found;
+			data->spriteIndex->queryPoint(first.x, first.y, found);
+			if (!found.empty())
 			{
-				auto cur = p->second;
-				// calculate current rectangle area
-				auto curRect = Rect(
-					Vec2(cur->getPositionX(), cur->getPositionY()) - cur->getContentSize() / 2,		// left-down location
-					cur->getContentSize()
-					);
-				
-				// if current rectangle area contains one of the spring side points.
-				if (curRect.containsPoint(first))
-				{ 
-					targets[0] = cur;
-					anchors[0] = (first - cur->getPosition());
-					cnt++;
-				}
-				else if (curRect.containsPoint(end))
-				{
-					targets[1] = cur;
-					anchors[1] = (end - cur->getPosition());
-					cnt++;
-				}
+				targets[0] = found.front();
+				anchors[0] = (first - targets[0]->getPosition());
+				cnt++;
+			}
+			found.clear();
+			data->spriteIndex->queryPoint(end.x, end.y, found);
+			for (auto p = found.begin(); p != found.end(); p++)
+			{
+				// spring side points are attached to different sprites
+				if (*p == targets[0])continue;
+				targets[1] = *p;
+				anchors[1] = (end - targets[1]->getPosition());
+				cnt++;
+				break;
 			}
 
 			// spring can have only 2 joints
@@ -349,23 +355,28 @@ bool PostCommandHandlerFactory::init()
 		Node* owner,
 		void* udata)
 	{
-		GenSpriteResultMap* rmap = static_cast<GenSpriteResultMap*>(udata);
-		RecognitionResult& result = recSprite._result;
+		PostCommandData* data = static_cast<PostCommandData*>(udata);
 		DrawableSprite* ds = recSprite._drawNode;
 		Vec2 position = ds->getShapeCenter();
-		auto pistal = Pistal::createWithTexture(ds->createTexture(), ds->contentRect());
+		Rect rect;
+		auto pistal = Pistal::createWithTexture(SketchTexture(data, ds, rect), rect);
 		pistal->setFlippedY(true);
+		if (data)pistal->getBulletLayer()->setContactQueue(data->contactQueue);
 		// check if there is gunman to be attached
 		bool findGunman = false;
-		if (rmap)
+		if (data)
 		{
+			// the right side of a gunman is on its bounds, so only sprites
+			// overlapping the square around pistal grip can be within distance
 			Vec2 my = Vec2(ds->contentRect().getMinX(), (ds->contentRect().getMinY() + ds->contentRect().getMaxY()) / 2);
-			for (auto p = rmap->begin(); p != rmap->end(); p++)
+			vector<Sprite*> found;
+			data->spriteIndex->query(my.x - 100.0f, my.y - 100.0f, my.x + 100.0f, my.y + 100.0f, found);
+			for (auto p = found.begin(); p != found.end(); p++)
 			{
-				Vec2 cur = (p->second)->getPosition() + Vec2(((p->second)->getContentSize().width / 2), 0);
+				Vec2 cur = (*p)->getPosition() + Vec2(((*p)->getContentSize().width / 2), 0);
 				if (EuclideanDistance(cur, my) < 100.0f)
 				{
-					auto gunman = (p->second);
+					auto gunman = (*p);
 					gunman->addChild(pistal);
 					gunman->addChild(pistal->getBulletLayer());
 					pistal->setGunman(gunman);
@@ -391,7 +402,8 @@ bool PostCommandHandlerFactory::init()
 			owner->addChild(pistal->getBulletLayer());
 		}
 
-		if (rmap)rmap->insert(pair<DrawableSprite*, Sprite*>(ds, pistal));
+		// an attached pistal is positioned in gunman space, it's not indexed
+		if (data)AddGenSprite(data, ds, pistal, !findGunman);
 	});
 
 	// static, @see CommandHandler
@@ -401,18 +413,18 @@ bool PostCommandHandlerFactory::init()
 		Node* owner, 
 		void* udata)
 	{
-		GenSpriteResultMap* rmap = static_cast<GenSpriteResultMap*>(udata);
-		if (rmap)
+		PostCommandData* data = static_cast<PostCommandData*>(udata);
+		if (data)
 		{
-			RecognitionResult& result = recSprite._result;
+			auto rmap = data->resultMap;
 			DrawableSprite* currentDrawNode = recSprite._drawNode;
-			Vec2 position = currentDrawNode->getShapeCenter();
-			for (auto i = drawNodeList.begin(); i != drawNodeList.end(); i++)
+			vector<DrawableSprite*> candidates;
+			QueryDrawNodes(*data->drawNodeIndex, currentDrawNode->contentRect(), candidates);
+			for (auto i = candidates.begin(); i != candidates.end(); i++)
 			{
 				// is not static mark
 				if (*i != currentDrawNode)
 				{
-					Vec2 candinate = (*i)->getShapeCenter();
 					// if static mark is snaped to a node
 					if (IsSnapedTo(currentDrawNode, *i))
 					{
@@ -439,18 +451,18 @@ bool PostCommandHandlerFactory::init()
 		Node* owner,
 		void* udata)
 	{
-		GenSpriteResultMap* rmap = static_cast<GenSpriteResultMap*>(udata);
-		if (rmap)
+		PostCommandData* data = static_cast<PostCommandData*>(udata);
+		if (data)
 		{
-			RecognitionResult& result = recSprite._result;
+			auto rmap = data->resultMap;
 			DrawableSprite* currentDrawNode = recSprite._drawNode;
-			Vec2 position = currentDrawNode->getShapeCenter();
-			for (auto i = drawNodeList.begin(); i != drawNodeList.end(); i++)
+			vector<DrawableSprite*> candidates;
+			QueryDrawNodes(*data->drawNodeIndex, currentDrawNode->contentRect(), candidates);
+			for (auto i = candidates.begin(); i != candidates.end(); i++)
 			{
 				// is not control mark
 				if (*i != currentDrawNode)
 				{
-					Vec2 candinate = (*i)->getShapeCenter();
 					// if control mark is snaped to a node, with epsilon 0.5
 					if (IsSnapedTo(currentDrawNode, *i, 0.5f))
 					{
@@ -478,11 +490,12 @@ void handleDefaultWithPhysics(
 	void* udata, 
 	PhysicsBody*(*pfMakePhysicsBody)(DrawableSprite*))
 {
-	RecognitionResult& result = recSprite._result;
+	PostCommandData* data = static_cast<PostCommandData*>(udata);
 	DrawableSprite* ds = recSprite._drawNode;
 
 	// create sprite with drawn texture(clipped by content rectangle) 
-	auto sprite = Sprite::createWithTexture(ds->createTexture(), ds->contentRect());
+	Rect rect;
+	auto sprite = Sprite::createWithTexture(SketchTexture(data, ds, rect), rect);
 	// set shape center as current postion
 	Vec2 position = ds->getShapeCenter();
 	sprite->setPosition(position);
@@ -497,8 +510,7 @@ void handleDefaultWithPhysics(
 	owner->addChild(sprite);
 
 	// add to generated sprite result map
-	GenSpriteResultMap* rmap = static_cast<GenSpriteResultMap*>(udata);
-	if (rmap)rmap->insert(pair<DrawableSprite*, Sprite*>(recSprite._drawNode, sprite));
+	if (data)AddGenSprite(data, recSprite._drawNode, sprite);
 }
 
 void PostCommandHandlerFactory::handleDefault(
@@ -507,8 +519,9 @@ void PostCommandHandlerFactory::handleDefault(
 	Node* owner, 
 	void* udata)
 {
-	// default use makePhysicsBodyAsPolygon to generate physics body
-	handleDefaultWithPhysics(recSprite, drawNodeList, owner, udata, makePhysicsBodyAsPolygon);
+	// default use makePhysicsBodyAsConvexPieces to generate physics body, so concave sketches keep their shape,
+	// it falls back to convex hull polygon if outline is convex or can't be decomposed
+	handleDefaultWithPhysics(recSprite, drawNodeList, owner, udata, makePhysicsBodyAsConvexPieces);
 }
 
 void PostCommandHandlerFactory::makeJoints(
@@ -516,6 +529,15 @@ void PostCommandHandlerFactory::makeJoints(
 	JointsList& jointsList,
 	GenSpriteResultMap& resultMap)
 {
+	// bodies connected by joints form a composite, index bodies by result map order
+	map<PhysicsBody*, int> bodyIndex;
+	for (auto p = resultMap.begin(); p != resultMap.end(); p++)
+	{
+		auto cur = p->second->getPhysicsBody();
+		if (cur != nullptr && bodyIndex.find(cur) == bodyIndex.end())bodyIndex.insert(pair<PhysicsBody*, int>(cur, (int)bodyIndex.size()));
+	}
+	CollisionGroups groups((int)bodyIndex.size());
+
 	for (auto pjoints = jointsList.begin(); pjoints != jointsList.end(); pjoints++)
 	{
 		// check is empty
@@ -545,6 +567,7 @@ void PostCommandHandlerFactory::makeJoints(
 					{
 						PhysicsJointDistance* joint = PhysicsJointDistance::construct(body[0], body[1], Point::ZERO, Point::ZERO);
 						physicsWorld->addJoint(joint);
+						groups.unite(bodyIndex[body[0]], bodyIndex[body[1]]);
 					}
 					else
 					{
@@ -558,4 +581,12 @@ void PostCommandHandlerFactory::makeJoints(
 			}
 		}
 	}
+
+	// parts of a composite never collide with each other, filtered before narrowphase
+	auto filter = CollisionFilter::getInstance();
+	for (auto p = bodyIndex.begin(); p != bodyIndex.end(); p++)
+	{
+		int group = groups.getGroup(p->second);
+		if (group)filter->applyGroup(p->first, group);
+	}
 }
\ No newline at end of file
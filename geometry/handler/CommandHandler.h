@@ -4,6 +4,9 @@
 #include "cocos2d.h"
 #include "geometry/recognizer/RecognizedSprite.h"
 #include "geometry/GeometricPhysics.h"
+#include "geometry/SpatialGrid.h"
+#include "scene/SketchAtlas.h"
+#include "geometry/ContactEventQueue.h"
 #define TRIANGLE_TAG 0x10000
 #define RECTANGLE_TAG 0x10001
 class CommandHandlerFactory;
@@ -12,6 +15,52 @@ class PostCommandHandlerFactory;
 
 typedef std::map<DrawableSprite*, RecognizedSprite> DrawSpriteResultMap;
 typedef std::map<DrawableSprite*, cocos2d::Sprite*> GenSpriteResultMap;
+typedef SpatialGrid<DrawableSprite*> DrawNodeIndex;
+typedef SpatialGrid<cocos2d::Sprite*> GenSpriteIndex;
+
+/**
+ * Pre command data, passed to pre-handlers as udata
+ * Owner keeps result map and index in sync when a drawn node is removed from it
+ */
+struct PreCommandData
+{
+	DrawSpriteResultMap*	resultMap;		// DrawableSprite-RecognizedSprite map
+	DrawNodeIndex*			drawNodeIndex;	// spatial index over content rectangles of drawn nodes
+};
+
+/**
+ * Post command data, passed to post-handlers as udata
+ */
+struct PostCommandData
+{
+	GenSpriteResultMap*	resultMap;		// DrawableSprite-Sprite map, generated sprites
+	DrawNodeIndex*		drawNodeIndex;	// spatial index over content rectangles of drawn nodes
+	GenSpriteIndex*		spriteIndex;	// spatial index over bounds of generated sprites, in owner space
+	SketchAtlas*		atlas;			// rasterized sketches, uploaded before handling
+	ContactEventQueue*	contactQueue;	// contact events of physics world, drained once per step
+};
+
+/**
+ * Index a drawn node by its content rectangle, or update it if it's already indexed
+ * @param index		spatial index of drawn nodes
+ * @param drawNode	drawn node to be indexed
+ */
+inline void IndexDrawNode(DrawNodeIndex& index, DrawableSprite* drawNode)
+{
+	cocos2d::Rect r = drawNode->contentRect();
+	index.insert(drawNode, r.getMinX(), r.getMinY(), r.getMaxX(), r.getMaxY());
+}
+
+/**
+ * Find drawn nodes whose content rectangle overlaps given area
+ * @param index		spatial index of drawn nodes
+ * @param area		query area
+ * @param result	OUTPUT, found nodes are appended
+ */
+inline void QueryDrawNodes(const DrawNodeIndex& index, const cocos2d::Rect& area, std::vector<DrawableSprite*>& result)
+{
+	index.query(area.getMinX(), area.getMinY(), area.getMaxX(), area.getMaxY(), result);
+}
 
 /**
  * Command handler
@@ -20,7 +69,7 @@ typedef std::map<DrawableSprite*, cocos2d::Sprite*> GenSpriteResultMap;
  * @param drawNodeList	list of DrawableSprite*, reference to user drawed shapes in screen
  * @see DrawableSprite
  * @param owner			recognized sprite owner
- * @param udata			a pointer to user - defined data
+ * @param udata			a pointer to user - defined data, PreCommandData or PostCommandData
  */
 typedef std::function<void(RecognizedSprite&, std::list<DrawableSprite*>&, cocos2d::Node*, void*)> CommandHandler;
 
@@ -97,8 +146,9 @@ public:
 	virtual bool init();
 
 	/**
-	 * Default post-handler
+	 * Default post-handler, physics body is made of convex pieces of the sketch outline
 	 * @see CommandHandler
+	 * @see makePhysicsBodyAsConvexPieces
 	 * @param recSprite		recognized sprite associate with user drawed shapes
 	 * @see RecognizedSprite
 	 * @param drawNodeList	list of DrawableSprite*, reference to user drawed shapes in screen
@@ -110,6 +160,7 @@ public:
 
 	/**
 	 * Make physics joints
+	 * Bodies connected by joints are put in the same collision group, so parts of a composite never collide
 	 * @param physicsWorld	physics world in scene
 	 * @param jointsList	physics joints list
 	 * @param resultMap		store result as DrawableSprite*-cocos2d::Sprite* map
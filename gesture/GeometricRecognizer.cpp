@@ -674,6 +674,11 @@ double GeometricRecognizer::Rad2Deg(double r)
 { return (r * 180.0 / 3.14); }
 
 RecognitionResult GeometricRecognizer::Multirecognize(MultiStrokeGesture strokes,string method)
+{
+    return Multirecognize(CombineStrokes(strokes), strokes.size(), method);
+}
+
+RecognitionResult GeometricRecognizer::Multirecognize(const Path2D& combinedStrokes, int numStrokes, string method)
 {
     bool useProtractor=false;
     if(method=="protractor"){
@@ -682,7 +687,7 @@ RecognitionResult GeometricRecognizer::Multirecognize(MultiStrokeGesture strokes
     }
 
 
-        Path2D points=CombineStrokes(strokes);
+        Path2D points=combinedStrokes;
         //--- Make sure we have some templates to compare this to
         //---  or else recognition will be impossible
         if (allmultistrokenormalizedgestures.empty())
@@ -705,7 +710,7 @@ RecognitionResult GeometricRecognizer::Multirecognize(MultiStrokeGesture strokes
             {
 
                 GestureTemplates Mgestures= allmultistrokenormalizedgestures.at(i);
-                if (!requireSameNoOfStrokes || strokes.size() == Mgestures.size()) // optional -- only attempt match when same # of component strokes
+                if (!requireSameNoOfStrokes || numStrokes == (int)Mgestures.size()) // optional -- only attempt match when same # of component strokes
                 {
                     for (int j = 0; j < Mgestures.size(); j++) // each unistroke within this multistroke
                     {
@@ -106,6 +106,9 @@ namespace DollarRecognizer
                 void activateMultiStrokesTemplates(vector<string>);
 
                 RecognitionResult Multirecognize(MultiStrokeGesture paths, string method);
+                //--- Same as above, for strokes already combined into one path in drawing order,
+                //---  so callers holding their own stroke storage skip building a MultiStrokeGesture
+                RecognitionResult Multirecognize(const Path2D& combinedStrokes, int numStrokes, string method);
         private:
                 bool inTemplates(string, vector<string>);
                 double Deg2Rad(double d);
@@ -0,0 +1,63 @@
+#include "DelaunayBenchmark.h"
+#include "geometry/delaunay/DivideConquer-Delaunay.h"
+#include <chrono>
+#include <cstdlib>
+#include <random>
+
+using namespace std;
+
+#define DELAUNAY_BENCHMARK_SETS 16			// distinct point sets per row, reused in turn
+#define DELAUNAY_BENCHMARK_EXTENT 10000.0f	// wide enough that few points snap together
+
+namespace
+{
+	// triangulate every set in turn, return microseconds per triangulation
+	double TimeTriangulations(vector<vector<float> >& sets, int count, int repeat, int numThreads, int grain, long long& checksum)
+	{
+		auto begin = chrono::steady_clock::now();
+		for (int i = 0; i < repeat; i++)
+		{
+			vector<float>& set = sets[i % DELAUNAY_BENCHMARK_SETS];
+			int numIndices = 0;
+			WORD* indices = BuildTriangleIndexListParallel(set.data(), 1.0f, count, 2, 1, &numIndices, numThreads, grain);
+			checksum += numIndices;
+			free(indices);
+		}
+		chrono::duration<double, micro> elapsed = chrono::steady_clock::now() - begin;
+		return elapsed.count() / repeat;
+	}
+}
+
+DelaunayBenchmark::DelaunayBenchmark(int points)
+:_points(points)
+{
+}
+
+void DelaunayBenchmark::run(ostream& out, const vector<int>& sizes)
+{
+	out << "points,serial_us,split_us,speedup\n";
+	for (auto size = sizes.begin(); size != sizes.end(); size++)
+	{
+		int count = *size;
+		mt19937 rng(count);
+		uniform_real_distribution<float> coord(0, DELAUNAY_BENCHMARK_EXTENT);
+		vector<vector<float> > sets(DELAUNAY_BENCHMARK_SETS);
+		for (auto set = sets.begin(); set != sets.end(); set++)
+		{
+			set->resize(count * 2);
+			for (int i = 0; i < count * 2; i++)(*set)[i] = coord(rng);
+		}
+
+		// 2 threads split the set once at most, a small grain makes sure it is split even if points snap together,
+		// the left half goes to a worker thread
+		int repeat = _points / count > 1 ? _points / count : 1;
+		long long checksum = 0;
+		double serialUs = TimeTriangulations(sets, count, repeat, 1, count, checksum);
+		double splitUs = TimeTriangulations(sets, count, repeat, 2, count / 4, checksum);
+
+		out << count << ',' << serialUs << ',' << splitUs << ',' << (splitUs > 0 ? serialUs / splitUs : 0) << '\n';
+		out.flush();
+		// keep checksum alive, so neither loop is optimized away
+		if (checksum < 0)out << checksum;
+	}
+}
@@ -0,0 +1,36 @@
+#ifndef __DELAUNAY_BENCHMARK_H__
+#define __DELAUNAY_BENCHMARK_H__
+
+#include <ostream>
+#include <vector>
+
+/**
+ * Delaunay Benchmark
+ * Times BuildTriangleIndexListParallel on the calling thread against one split onto 2 threads,
+ * on random point sets. The smallest size whose split is faster is twice the right DELAUNAY_PARALLEL_GRAIN.
+ * Result is CSV, one row per size:
+ *   points,serial_us,split_us,speedup
+ * speedup above 1 means the split onto 2 threads is faster.
+ */
+class DelaunayBenchmark
+{
+public:
+
+	/**
+	 * Constructor
+	 * @param points	points triangulated per row and side, small sets are triangulated more often
+	 */
+	DelaunayBenchmark(int points = 4000000);
+
+	/**
+	 * Run benchmark and write rows as soon as they are measured
+	 * @param out		output stream
+	 * @param sizes		points of each point set
+	 */
+	void run(std::ostream& out, const std::vector<int>& sizes);
+
+private:
+	int	_points;	// points per row and side
+};
+
+#endif	/* __DELAUNAY_BENCHMARK_H__ */
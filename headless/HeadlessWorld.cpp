@@ -0,0 +1,284 @@
+#include "HeadlessWorld.h"
+#include "chipmunk/chipmunk.h"
+#include "chipmunk/cpHastySpace.h"
+#include "geometry/MaterialTable.h"
+#include "geometry/GeometricDecomposition.h"
+#include "util/SimulationClock.h"
+#include "util/AdaptiveSubsteps.h"
+#include <algorithm>
+
+using namespace std;
+
+// GameLayer scales ToolLayer inputs to world units
+#define VELOCITY_SCALE 10
+#define FORCE_SCALE 100
+// GeometricPhysics default polygon mass
+#define DEFAULT_POLYGON_MASS 10.0f
+
+// decompose polygon x0,y0,x1,y1... into convex pieces, indices are into its points
+static bool DecomposePolygon(const vector<float>& points, vector<int>& indices, vector<int>& offsets)
+{
+	int count = (int)points.size() / 2;
+	if (count < 3)return false;
+	double area = 0;
+	for (int i = 0; i < count; i++)
+	{
+		int j = (i + 1) % count;
+		area += (double)points[i * 2] * points[j * 2 + 1] - (double)points[j * 2] * points[i * 2 + 1];
+	}
+	if (area > 0)return ConvexDecompositionXY(&points[0], count, indices, offsets);
+
+	// decomposition takes anti-clockwise points
+	vector<float> reversed(points.size());
+	for (int i = 0; i < count; i++)
+	{
+		reversed[i * 2] = points[(count - 1 - i) * 2];
+		reversed[i * 2 + 1] = points[(count - 1 - i) * 2 + 1];
+	}
+	if (!ConvexDecompositionXY(&reversed[0], count, indices, offsets))return false;
+	for (auto i = indices.begin(); i != indices.end(); i++)*i = count - 1 - *i;
+	return true;
+}
+
+HeadlessWorld::HeadlessWorld()
+:_space(nullptr)
+, _threaded(false)
+, _solverThreads(1)
+, _solverMinLoad(SOLVER_THREADING_MIN_LOAD)
+, _timestep(0)
+, _steps(0)
+{
+}
+
+HeadlessWorld::~HeadlessWorld()
+{
+	release();
+}
+
+void HeadlessWorld::release()
+{
+	for (auto s = _shapes.begin(); s != _shapes.end(); s++)
+	{
+		cpSpaceRemoveShape(_space, *s);
+		cpShapeFree(*s);
+	}
+	for (auto b = _bodies.begin(); b != _bodies.end(); b++)
+	{
+		cpSpaceRemoveBody(_space, *b);
+		cpBodyFree(*b);
+	}
+	if (_space)
+	{
+		if (_threaded)cpHastySpaceFree(_space);
+		else cpSpaceFree(_space);
+	}
+	_space = nullptr;
+	_threaded = false;
+	_shapes.clear();
+	_shapeOffsets.assign(1, 0);
+	_shapeTypes.clear();
+	_bodies.clear();
+	_dynamicBodies.clear();
+	_forces.clear();
+	_thicknesses.clear();
+}
+
+void HeadlessWorld::init(const SceneDescription& scene)
+{
+	release();
+	// scene descriptions have no joints yet, load is the number of bodies
+	int load = (int)scene.bodies.size();
+	_threaded = _solverThreads != 1 && load >= _solverMinLoad;
+	if (_threaded)
+	{
+		_space = cpHastySpaceNew();
+		// chipmunk picks the number of cores for 0
+		cpHastySpaceSetThreads(_space, _solverThreads > 0 ? _solverThreads : 0);
+	}
+	else _space = cpSpaceNew();
+	cpSpaceSetGravity(_space, cpv(scene.gravityX, scene.gravityY));
+	// bodies at rest fall asleep as in GameLayer
+	cpSpaceSetIdleSpeedThreshold(_space, SIMULATION_SLEEP_IDLE_SPEED);
+	cpSpaceSetSleepTimeThreshold(_space, SIMULATION_SLEEP_TIME);
+	_timestep = scene.timestep;
+	_steps = 0;
+
+	// materials are set the same way as GameLayer::initMaterialForPhysicsBody
+	MaterialTable materials;
+	materials.setFriction(scene.friction);
+
+	for (auto d = scene.bodies.begin(); d != scene.bodies.end(); d++)
+	{
+		cpBody* body;
+		vector<cpShape*> shapes;
+		if (d->type == SHAPE_CIRCLE)
+		{
+			cpVect center = cpv(d->points[0], d->points[1]);
+			float mass = d->mass > 0 ? d->mass : d->radius * d->radius * 3.14f;
+			body = d->isStatic ? cpBodyNewStatic() : cpBodyNew(mass, cpMomentForCircle(mass, 0, d->radius, cpvzero));
+			cpBodySetPosition(body, center);
+			shapes.push_back(cpCircleShapeNew(body, d->radius, cpvzero));
+		}
+		else
+		{
+			// body is placed at polygon centroid, vertices are relative to it
+			int count = (int)d->points.size() / 2;
+			vector<cpVect> verts(count);
+			for (int i = 0; i < count; i++)verts[i] = cpv(d->points[i * 2], d->points[i * 2 + 1]);
+			cpVect centroid = cpCentroidForPoly(count, &verts[0]);
+			for (int i = 0; i < count; i++)verts[i] = cpvsub(verts[i], centroid);
+
+			// a concave polygon is made of convex pieces, the same as makePhysicsBodyAsConvexPieces,
+			// a convex one or one that can't be decomposed is a single hull computed by chipmunk
+			vector<int> indices, offsets;
+			if (!DecomposePolygon(d->points, indices, offsets) || offsets.size() <= 2)
+			{
+				indices.resize(count);
+				for (int i = 0; i < count; i++)indices[i] = i;
+				offsets.assign(1, 0);
+				offsets.push_back(count);
+			}
+			vector<vector<cpVect> > pieces(offsets.size() - 1);
+			for (size_t p = 0; p < pieces.size(); p++)
+			{
+				for (int i = offsets[p]; i < offsets[p + 1]; i++)pieces[p].push_back(verts[indices[i]]);
+			}
+
+			// mass is shared by area, so the moment is the one of the whole polygon
+			float mass = d->mass > 0 ? d->mass : DEFAULT_POLYGON_MASS;
+			cpFloat moment = 0, area = 0;
+			for (auto p = pieces.begin(); p != pieces.end(); p++)area += cpAreaForPoly((int)p->size(), &p->front(), 0);
+			for (auto p = pieces.begin(); p != pieces.end(); p++)
+			{
+				cpFloat share = pieces.size() > 1 ? cpAreaForPoly((int)p->size(), &p->front(), 0) / area : 1;
+				moment += cpMomentForPoly(mass * share, (int)p->size(), &p->front(), cpvzero, 0);
+			}
+			body = d->isStatic ? cpBodyNewStatic() : cpBodyNew(mass, moment);
+			cpBodySetPosition(body, centroid);
+			for (auto p = pieces.begin(); p != pieces.end(); p++)
+			{
+				shapes.push_back(cpPolyShapeNew(body, (int)p->size(), &p->front(), cpTransformIdentity, 0));
+			}
+		}
+		BodyMaterial material = d->isStatic ? materials.getStatic() : materials.getDynamic((int)_dynamicBodies.size());
+		cpSpaceAddBody(_space, body);
+		for (auto s = shapes.begin(); s != shapes.end(); s++)
+		{
+			cpShapeSetFriction(*s, material.friction);
+			cpShapeSetElasticity(*s, material.restitution);
+			cpSpaceAddShape(_space, *s);
+		}
+		_bodies.push_back(body);
+		_shapes.insert(_shapes.end(), shapes.begin(), shapes.end());
+		_shapeOffsets.push_back((int)_shapes.size());
+		_shapeTypes.push_back(d->type);
+
+		if (!d->isStatic)
+		{
+			int index = (int)_dynamicBodies.size();
+			cpBodySetVelocity(body, cpv(ValueAt(scene.vx, index) * VELOCITY_SCALE, (0 - ValueAt(scene.vy, index)) * VELOCITY_SCALE));
+			_forces.push_back((float)(ValueAt(scene.fx, index) * FORCE_SCALE));
+			_forces.push_back((float)((0 - ValueAt(scene.fy, index)) * FORCE_SCALE));
+			_thicknesses.push_back(d->type == SHAPE_CIRCLE ? d->radius * 2 : PolygonThickness(&d->points[0], (int)d->points.size() / 2));
+			_dynamicBodies.push_back(body);
+		}
+	}
+}
+
+void HeadlessWorld::step()
+{
+	// fast bodies split the step, so nothing moves through a surface between substeps
+	int substeps = getSubsteps();
+	cpFloat dt = _timestep / substeps;
+	for (int s = 0; s < substeps; s++)
+	{
+		// chipmunk clears forces after each step, applied forces are constant,
+		// setting a force wakes a body, so bodies without force and sleeping
+		// bodies are left alone, a forced body can rest against a wall and sleep
+		for (size_t i = 0; i < _dynamicBodies.size(); i++)
+		{
+			if (_forces[i * 2] == 0 && _forces[i * 2 + 1] == 0)continue;
+			if (cpBodyIsSleeping(_dynamicBodies[i]))continue;
+			cpBodySetForce(_dynamicBodies[i], cpv(_forces[i * 2], _forces[i * 2 + 1]));
+		}
+		if (_threaded)cpHastySpaceStep(_space, dt);
+		else cpSpaceStep(_space, dt);
+	}
+	_steps++;
+}
+
+int HeadlessWorld::getSubsteps() const
+{
+	int substeps = 1;
+	for (size_t i = 0; i < _dynamicBodies.size(); i++)
+	{
+		if (cpBodyIsSleeping(_dynamicBodies[i]))continue;
+		cpVect v = cpBodyGetVelocity(_dynamicBodies[i]);
+		substeps = max(substeps, AdaptiveSubsteps((float)cpvlength(v), _thicknesses[i], _timestep));
+	}
+	return substeps;
+}
+
+int HeadlessWorld::getSolverThreads() const
+{
+	return _threaded ? (int)cpHastySpaceGetThreads(_space) : 1;
+}
+
+void HeadlessWorld::describe(vector<KinematicBody>& bodies) const
+{
+	bodies.clear();
+	int dynamic = 0;
+	for (size_t i = 0; i < _bodies.size(); i++)
+	{
+		cpBody* body = _bodies[i];
+		cpShape* shape = _shapes[_shapeOffsets[i]];
+		KinematicBody b = {};
+		b.isStatic = cpBodyGetType(body) == CP_BODY_TYPE_STATIC;
+		b.mass = b.isStatic ? 0 : (float)cpBodyGetMass(body);
+		b.friction = (float)cpShapeGetFriction(shape);
+		cpVect v = cpBodyGetVelocity(body);
+		b.vx = (float)v.x;
+		b.vy = (float)v.y;
+		if (!b.isStatic)
+		{
+			b.fx = _forces[dynamic * 2];
+			b.fy = _forces[dynamic * 2 + 1];
+			dynamic++;
+		}
+		if (_shapeTypes[i] == SHAPE_CIRCLE)
+		{
+			cpVect center = cpBodyLocalToWorld(body, cpCircleShapeGetOffset(shape));
+			b.isCircle = true;
+			b.cx = (float)center.x;
+			b.cy = (float)center.y;
+			b.radius = (float)cpCircleShapeGetRadius(shape);
+		}
+		else
+		{
+			// one polygon per convex piece
+			for (int s = _shapeOffsets[i]; s < _shapeOffsets[i + 1]; s++)
+			{
+				vector<float> points;
+				for (int k = 0; k < cpPolyShapeGetCount(_shapes[s]); k++)
+				{
+					cpVect p = cpBodyLocalToWorld(body, cpPolyShapeGetVert(_shapes[s], k));
+					points.push_back((float)p.x);
+					points.push_back((float)p.y);
+				}
+				b.polygons.push_back(points);
+			}
+		}
+		bodies.push_back(b);
+	}
+}
+
+void HeadlessWorld::getState(int index, float state[4]) const
+{
+	cpBody* body = _dynamicBodies[index];
+	cpVect p = cpBodyGetPosition(body);
+	cpVect v = cpBodyGetVelocity(body);
+	state[0] = (float)p.x;
+	state[1] = (float)p.y;
+	state[2] = (float)v.x;
+	state[3] = (float)v.y;
+}
@@ -0,0 +1,134 @@
+#ifndef __HEADLESS_WORLD_H__
+#define __HEADLESS_WORLD_H__
+
+#include "headless/SceneDescription.h"
+#include "geometry/KinematicsSolver.h"
+
+struct cpSpace;
+struct cpBody;
+struct cpShape;
+
+// bodies & constraints below which a world stays single-threaded, threading costs more than it saves
+#define SOLVER_THREADING_MIN_LOAD 500
+
+/**
+ * Headless World
+ * A chipmunk space built from a scene description, with no cocos2d node, window or GL context.
+ * Bodies, materials and inputs follow GameLayer:
+ *   velocity (vx, -vy) * 10, constant force (fx, -fy) * 100 on dynamic bodies by order,
+ *   friction of dynamic bodies by order and friction 1 on static bodies (MaterialTable),
+ *   default polygon mass 10, default circle mass PI * r * r.
+ * Large worlds may be solved by chipmunk hasty space on worker threads, results of a threaded
+ * world are not bit-exact between runs, a single-threaded world is.
+ */
+class HeadlessWorld
+{
+public:
+
+	// Constructor
+	HeadlessWorld();
+
+	// Destructor, free space, bodies and shapes
+	~HeadlessWorld();
+
+	/**
+	 * Set solver threads of worlds built from now on, single-threaded by default
+	 * @param threads	solver worker threads, 0 for all cores, 1 is single-threaded
+	 * @param minLoad	bodies & constraints below which a world stays single-threaded
+	 */
+	void setSolverThreads(int threads, int minLoad = SOLVER_THREADING_MIN_LOAD)
+	{
+		_solverThreads = threads;
+		_solverMinLoad = minLoad;
+	}
+
+	/**
+	 * Get solver threads of current world, 1 if it's single-threaded
+	 */
+	int getSolverThreads() const;
+
+	/**
+	 * Build world from scene description, previous world is freed
+	 * @param scene	scene description
+	 */
+	void init(const SceneDescription& scene);
+
+	/**
+	 * Step world by one fixed timestep, split into substeps while some body is fast
+	 * @see getSubsteps
+	 */
+	void step();
+
+	/**
+	 * Get substeps the next step is split into, the most any awake dynamic body needs
+	 * @see AdaptiveSubsteps
+	 */
+	int getSubsteps() const;
+
+	/**
+	 * Get simulated time, in seconds
+	 */
+	double getTime() const
+	{
+		return _steps * (double)_timestep;
+	}
+
+	/**
+	 * Get fixed timestep, in seconds
+	 */
+	float getTimestep() const
+	{
+		return _timestep;
+	}
+
+	/**
+	 * Get the number of dynamic bodies
+	 */
+	int getBodyCount() const
+	{
+		return (int)_dynamicBodies.size();
+	}
+
+	/**
+	 * Get state of a dynamic body, in world units
+	 * @param index	dynamic body index, by scene order
+	 * @param state	OUTPUT, x, y, vx, vy
+	 */
+	void getState(int index, float state[4]) const;
+
+	/**
+	 * Describe bodies at current state for closed form solving, the same way GameLayer does
+	 * @param bodies	OUTPUT, all bodies by scene order, dynamic bodies keep their order
+	 * @see KinematicsSolver
+	 */
+	void describe(std::vector<KinematicBody>& bodies) const;
+
+	/**
+	 * Get chipmunk space
+	 */
+	cpSpace* getSpace() const
+	{
+		return _space;
+	}
+
+private:
+
+	// free space, bodies and shapes
+	void release();
+
+	cpSpace*				_space;			// chipmunk space
+	std::vector<cpBody*>	_bodies;		// all bodies
+	std::vector<cpShape*>	_shapes;		// all shapes, body by body
+	std::vector<int>		_shapeOffsets;	// shapes of body i are [_shapeOffsets[i], _shapeOffsets[i + 1]) in _shapes
+	std::vector<int>		_shapeTypes;	// shape types, SHAPE_*
+	std::vector<cpBody*>	_dynamicBodies;	// dynamic bodies, by scene order
+	std::vector<float>		_forces;		// constant forces of dynamic bodies, fx, fy
+	std::vector<float>		_thicknesses;	// thickness of dynamic bodies, decides substeps
+	bool					_threaded;		// true if space is a hasty space
+	int						_solverThreads;	// solver threads of worlds built from now on
+	int						_solverMinLoad;	// load below which a world stays single-threaded
+	float					_timestep;		// fixed timestep
+	long long				_steps;			// simulated steps
+};
+
+#endif	/* __HEADLESS_WORLD_H__ */
@@ -0,0 +1,153 @@
+#include "HullBenchmark.h"
+#include "geometry/GeometricHull.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+using namespace std;
+
+#define HULL_BENCHMARK_SETS 64			// distinct point sets per row, reused in turn
+#define HULL_BENCHMARK_EXTENT 500.0f	// point sets span about a canvas, in world units
+
+namespace
+{
+	struct RelativePoint
+	{
+		float x, y;
+	};
+
+	// order of the old PointClockwiseComparator, cross products are truncated to int as it did
+	bool ClockwiseLess(const RelativePoint& a, const RelativePoint& b)
+	{
+		if (a.x >= 0 && b.x < 0)return true;
+		if (a.x < 0 && b.x >= 0)return false;
+		if (a.x == 0 && b.x == 0)return a.y > b.y;
+		int c = (int)(a.x * b.y - b.x * a.y);
+		if (c)return c < 0;
+		int d = (int)(a.x * a.x - b.x * b.x + a.y * a.y - b.y * b.y);
+		return d < 0;
+	}
+
+	// uniform random points in a square
+	void MakeRandomSet(mt19937& rng, int count, vector<float>& xy)
+	{
+		uniform_real_distribution<float> coord(0, HULL_BENCHMARK_EXTENT);
+		xy.resize(count * 2);
+		for (int i = 0; i < count * 2; i++)xy[i] = coord(rng);
+	}
+
+	// half circle sampled like a drawn stroke, every point is on the hull
+	void MakeArcSet(mt19937& rng, int count, vector<float>& xy)
+	{
+		uniform_real_distribution<float> jitter(-0.5f, 0.5f);
+		float radius = HULL_BENCHMARK_EXTENT / 2;
+		xy.resize(count * 2);
+		for (int i = 0; i < count; i++)
+		{
+			float a = 3.14159265f * i / (count > 1 ? count - 1 : 1);
+			xy[i * 2] = radius + radius * cosf(a) + jitter(rng);
+			xy[i * 2 + 1] = radius + radius * sinf(a) + jitter(rng);
+		}
+	}
+}
+
+void GrahamScanHull(vector<float>& xy, int count, vector<float>& hull)
+{
+	hull.clear();
+	if (count <= 2)
+	{
+		hull.assign(xy.begin(), xy.begin() + count * 2);
+		return;
+	}
+	RelativePoint* points = (RelativePoint*)xy.data();
+	int idx = 0;
+	for (int i = 1; i < count; i++)
+	{
+		if (points[idx].x > points[i].x || (points[idx].x == points[i].x && points[idx].y > points[i].y))idx = i;
+	}
+	swap(points[0], points[idx]);
+	RelativePoint origin = points[0];
+	for (int i = 0; i < count; i++)
+	{
+		points[i].x -= origin.x;
+		points[i].y -= origin.y;
+	}
+	sort(points + 1, points + count, ClockwiseLess);
+
+	vector<RelativePoint> result;
+	result.push_back(points[0]);
+	result.push_back(points[1]);
+	for (int i = 2; i < count; i++)
+	{
+		for (;;)
+		{
+			const RelativePoint& top1 = result[result.size() - 1];
+			const RelativePoint& top2 = result[result.size() - 2];
+			float cross = (top2.x - top1.x) * (points[i].y - top1.y) - (points[i].x - top1.x) * (top2.y - top1.y);
+			if (cross > 0)break;
+			result.pop_back();
+			if (result.size() < 2)break;
+		}
+		result.push_back(points[i]);
+	}
+	for (auto p = result.begin(); p != result.end(); p++)
+	{
+		hull.push_back(p->x + origin.x);
+		hull.push_back(p->y + origin.y);
+	}
+}
+
+HullBenchmark::HullBenchmark(int hulls)
+:_hulls(hulls)
+{
+}
+
+void HullBenchmark::run(ostream& out, const vector<int>& sizes)
+{
+	out << "shape,points,graham_us,chain_us,speedup\n";
+	const char* shapes[] = { "random", "arc" };
+	for (int shape = 0; shape < 2; shape++)
+	{
+		for (auto size = sizes.begin(); size != sizes.end(); size++)
+		{
+			int count = *size;
+			mt19937 rng(count);
+			vector<vector<float> > sets(HULL_BENCHMARK_SETS);
+			for (auto set = sets.begin(); set != sets.end(); set++)
+			{
+				if (shape == 0)MakeRandomSet(rng, count, *set);
+				else MakeArcSet(rng, count, *set);
+			}
+
+			// graham scan sorts its input, so every hull starts from a fresh copy,
+			// the copy is paid by both sides to keep them comparable
+			vector<float> work, hull;
+			vector<int> indices(count);
+			long long checksum = 0;
+			auto begin = chrono::steady_clock::now();
+			for (int i = 0; i < _hulls; i++)
+			{
+				work = sets[i % HULL_BENCHMARK_SETS];
+				GrahamScanHull(work, count, hull);
+				checksum += hull.size();
+			}
+			chrono::duration<double, micro> graham = chrono::steady_clock::now() - begin;
+
+			begin = chrono::steady_clock::now();
+			for (int i = 0; i < _hulls; i++)
+			{
+				work = sets[i % HULL_BENCHMARK_SETS];
+				checksum += ConvexHullXY(work.data(), count, indices.data());
+			}
+			chrono::duration<double, micro> chain = chrono::steady_clock::now() - begin;
+
+			double grahamUs = graham.count() / _hulls, chainUs = chain.count() / _hulls;
+			out << shapes[shape] << ',' << count << ',' << grahamUs << ',' << chainUs << ','
+				<< (chainUs > 0 ? grahamUs / chainUs : 0) << '\n';
+			out.flush();
+			// keep checksum alive, so neither loop is optimized away
+			if (checksum < 0)out << checksum;
+		}
+	}
+}
@@ -0,0 +1,44 @@
+#ifndef __HULL_BENCHMARK_H__
+#define __HULL_BENCHMARK_H__
+
+#include <ostream>
+#include <vector>
+
+/**
+ * Graham scan convex hull, as ConvexHull was before the monotone chain, kept as benchmark baseline
+ * Points are sorted by angle around the leftmost-lowest point with truncated cross products
+ * @param xy		coordinates x0,y0,x1,y1..., sorted and moved in place
+ * @param count		the number of points
+ * @param hull		OUTPUT, hull coordinates x0,y0,x1,y1..., clockwise
+ */
+void GrahamScanHull(std::vector<float>& xy, int count, std::vector<float>& hull);
+
+/**
+ * Hull Benchmark
+ * Times ConvexHullXY against the Graham scan baseline on random point sets and stroke-like arcs.
+ * Result is CSV, one row per shape and size:
+ *   shape,points,graham_us,chain_us,speedup
+ * speedup above 1 means the monotone chain is faster.
+ */
+class HullBenchmark
+{
+public:
+
+	/**
+	 * Constructor
+	 * @param hulls		hulls timed per row, every hull is of a different point set
+	 */
+	HullBenchmark(int hulls = 20000);
+
+	/**
+	 * Run benchmark and write rows as soon as they are measured
+	 * @param out		output stream
+	 * @param sizes		points of each point set
+	 */
+	void run(std::ostream& out, const std::vector<int>& sizes);
+
+private:
+	int	_hulls;	// hulls per row
+};
+
+#endif	/* __HULL_BENCHMARK_H__ */
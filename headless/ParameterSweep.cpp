@@ -0,0 +1,198 @@
+#include "ParameterSweep.h"
+#include "util/ParallelFor.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <sstream>
+
+using namespace std;
+
+#define SWEEP_VERSION 1
+#define SWEEP_MAX_VALUES 100000
+
+// list of scene input by name, nullptr if unknown
+static vector<double>* InputOf(SceneDescription& scene, const string& parameter)
+{
+	if (parameter == "vx")return &scene.vx;
+	if (parameter == "vy")return &scene.vy;
+	if (parameter == "fx")return &scene.fx;
+	if (parameter == "fy")return &scene.fy;
+	if (parameter == "friction")return &scene.friction;
+	return nullptr;
+}
+
+bool SweepAxis::parse(const string& text, string& error)
+{
+	auto equal = text.find('=');
+	if (equal == string::npos)
+	{
+		error = "'" + text + "': <parameter>[<index>]=<values> expected";
+		return false;
+	}
+
+	// parameter and optional index
+	parameter = text.substr(0, equal);
+	index = 0;
+	auto bracket = parameter.find('[');
+	if (bracket != string::npos)
+	{
+		char* end = nullptr;
+		index = (int)strtol(parameter.c_str() + bracket + 1, &end, 10);
+		if (index < 0 || *end != ']' || end[1] != '\0')
+		{
+			error = "'" + text + "': bad index";
+			return false;
+		}
+		parameter.erase(bracket);
+	}
+	SceneDescription probe;
+	if (!InputOf(probe, parameter))
+	{
+		error = "'" + text + "': parameter must be vx, vy, fx, fy or friction";
+		return false;
+	}
+
+	// first:last:step or a value list
+	string range = text.substr(equal + 1);
+	values.clear();
+	double first, last, step;
+	char c1, c2;
+	istringstream in(range);
+	if (range.find(':') != string::npos)
+	{
+		if (!(in >> first >> c1 >> last >> c2 >> step) || c1 != ':' || c2 != ':' || !in.eof() || step <= 0 || last < first
+			|| (last - first) / step > SWEEP_MAX_VALUES)
+		{
+			error = "'" + text + "': <first>:<last>:<step> with first <= last and step > 0 expected";
+			return false;
+		}
+		// values are computed from the step count, so the last value is not lost to rounding
+		int count = (int)floor((last - first) / step + 1e-9) + 1;
+		for (int i = 0; i < count; i++)values.push_back(first + i * step);
+	}
+	else if (!ParseValueList(range, values) || values.empty())
+	{
+		error = "'" + text + "': <v0;v1;...> expected";
+		return false;
+	}
+	return true;
+}
+
+string SweepAxis::name() const
+{
+	ostringstream out;
+	out << parameter << '[' << index << ']';
+	return out.str();
+}
+
+ParameterSweep::ParameterSweep(const SceneDescription& scene, const vector<SweepAxis>& axes)
+:_scene(scene)
+, _axes(axes)
+{
+}
+
+int ParameterSweep::getVariantCount() const
+{
+	int count = 1;
+	for (auto a = _axes.begin(); a != _axes.end(); a++)count *= (int)a->values.size();
+	return count;
+}
+
+void ParameterSweep::getVariant(int variant, vector<double>& values) const
+{
+	values.resize(_axes.size());
+	for (int a = (int)_axes.size() - 1; a >= 0; a--)
+	{
+		int size = (int)_axes[a].values.size();
+		values[a] = _axes[a].values[variant % size];
+		variant /= size;
+	}
+}
+
+void ParameterSweep::makeScene(int variant, SceneDescription& scene) const
+{
+	vector<double> values;
+	getVariant(variant, values);
+	scene = _scene;
+	for (size_t a = 0; a < _axes.size(); a++)
+	{
+		auto input = InputOf(scene, _axes[a].parameter);
+		int index = _axes[a].index;
+		// bodies beyond the list use its last value, extend the list with it so they are not changed
+		double fill = ValueAt(*input, (int)input->size());
+		if ((int)input->size() <= index)input->resize(index + 1, fill);
+		(*input)[index] = values[a];
+	}
+}
+
+void ParameterSweep::run(int numThreads)
+{
+	_results.assign(getVariantCount(), TimeSeries());
+	ParallelFor(0, (int)_results.size(), [&](int variant)
+	{
+		SceneDescription scene;
+		makeScene(variant, scene);
+		SimulateScene(scene, _results[variant]);
+	}, numThreads);
+}
+
+void ParameterSweep::writeCsv(ostream& out) const
+{
+	out << "variant,";
+	for (auto a = _axes.begin(); a != _axes.end(); a++)out << a->name() << ',';
+	out << "t,body,x,y,vx,vy,speed\n";
+
+	vector<double> values;
+	for (size_t v = 0; v < _results.size(); v++)
+	{
+		ostringstream prefix;
+		prefix << v << ',';
+		getVariant((int)v, values);
+		for (auto x = values.begin(); x != values.end(); x++)prefix << *x << ',';
+		WriteTimeSeriesCsvRows(out, _results[v], prefix.str());
+	}
+}
+
+static void WriteUInt32(ostream& out, uint32_t value)
+{
+	unsigned char bytes[4];
+	for (int i = 0; i < 4; i++)bytes[i] = (unsigned char)(value >> (i * 8));
+	out.write((const char*)bytes, 4);
+}
+
+void ParameterSweep::writeBinary(ostream& out) const
+{
+	out.write("SPSW", 4);
+	WriteUInt32(out, SWEEP_VERSION);
+	WriteUInt32(out, (uint32_t)_axes.size());
+	WriteUInt32(out, (uint32_t)_results.size());
+	for (auto a = _axes.begin(); a != _axes.end(); a++)
+	{
+		string name = a->name();
+		WriteUInt32(out, (uint32_t)name.size());
+		out.write(name.data(), name.size());
+	}
+
+	// transpose samples into columns, floats are written in host order
+	vector<double> values;
+	vector<float> column;
+	for (size_t v = 0; v < _results.size(); v++)
+	{
+		const TimeSeries& series = _results[v];
+		getVariant((int)v, values);
+		if (!values.empty())out.write((const char*)&values[0], values.size() * sizeof(double));
+		WriteUInt32(out, series.bodyCount);
+		WriteUInt32(out, (uint32_t)series.times.size());
+		if (series.times.empty())continue;
+		out.write((const char*)&series.times[0], series.times.size() * sizeof(double));
+		column.resize(series.times.size());
+		for (int i = 0; i < series.bodyCount; i++)
+		{
+			for (int f = 0; f < 4; f++)
+			{
+				for (size_t s = 0; s < series.times.size(); s++)column[s] = series.values[(s * series.bodyCount + i) * 4 + f];
+				out.write((const char*)&column[0], column.size() * sizeof(float));
+			}
+		}
+	}
+}
@@ -0,0 +1,108 @@
+#ifndef __PARAMETER_SWEEP_H__
+#define __PARAMETER_SWEEP_H__
+
+#include <string>
+#include <vector>
+#include "headless/SceneDescription.h"
+#include "headless/TimeSeries.h"
+
+/**
+ * Sweep Axis, values of one scene input
+ */
+struct SweepAxis
+{
+	std::string			parameter;	// vx, vy, fx, fy or friction
+	int					index;		// list element to be replaced, dynamic body index
+	std::vector<double>	values;		// values to be swept
+
+	/**
+	 * Parse an axis definition
+	 *   <parameter>[<index>]=<first>:<last>:<step>, e.g. friction=0:1:0.1
+	 *   <parameter>[<index>]=<v0;v1;...>, e.g. vx[1]=1;2;5
+	 * index is 0 if not given
+	 * @param text	axis definition
+	 * @param error	OUTPUT, reason if parsing fails
+	 * @return true if parsed
+	 */
+	bool parse(const std::string& text, std::string& error);
+
+	/**
+	 * Get axis name, e.g. vx[1]
+	 */
+	std::string name() const;
+};
+
+/**
+ * Parameter Sweep
+ * Every point of the grid spanned by axes is a variant of the scene,
+ * variants run concurrently, each in its own headless world.
+ */
+class ParameterSweep
+{
+public:
+
+	/**
+	 * Constructor
+	 * @param scene	base scene description
+	 * @param axes	sweep axes, the last axis varies fastest
+	 */
+	ParameterSweep(const SceneDescription& scene, const std::vector<SweepAxis>& axes);
+
+	/**
+	 * Get the number of variants, product of axis sizes
+	 */
+	int getVariantCount() const;
+
+	/**
+	 * Get axis values of a variant
+	 * @param variant	variant index
+	 * @param values	OUTPUT, one value per axis
+	 */
+	void getVariant(int variant, std::vector<double>& values) const;
+
+	/**
+	 * Make scene description of a variant
+	 * @param variant	variant index
+	 * @param scene		OUTPUT, base scene with axis values applied
+	 */
+	void makeScene(int variant, SceneDescription& scene) const;
+
+	/**
+	 * Run all variants
+	 * @param numThreads	max number of threads, 0 for hardware concurrency
+	 */
+	void run(int numThreads = 0);
+
+	/**
+	 * Get sampled states of a variant, after run
+	 * @param variant	variant index
+	 */
+	const TimeSeries& getResult(int variant) const
+	{
+		return _results[variant];
+	}
+
+	/**
+	 * Write results as CSV, one row per variant per body per sample, in metres and m/s:
+	 *   variant,<axis names>,t,body,x,y,vx,vy,speed
+	 * @param out	output stream
+	 */
+	void writeCsv(std::ostream& out) const;
+
+	/**
+	 * Write results as columnar binary, little endian, in world units:
+	 *   "SPSW", uint32 version, uint32 axis count, uint32 variant count,
+	 *   per axis: uint32 name length, name,
+	 *   per variant: float64 axis values, uint32 body count, uint32 sample count,
+	 *     float64 t[samples], then float32 x[samples], y[samples], vx[samples], vy[samples] per body
+	 * @param out	output stream, opened in binary mode
+	 */
+	void writeBinary(std::ostream& out) const;
+
+private:
+	SceneDescription		_scene;		// base scene description
+	std::vector<SweepAxis>	_axes;		// sweep axes
+	std::vector<TimeSeries>	_results;	// sampled states, by variant
+};
+
+#endif	/* __PARAMETER_SWEEP_H__ */
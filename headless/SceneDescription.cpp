@@ -0,0 +1,172 @@
+#include "SceneDescription.h"
+#include "util/SimulationClock.h"
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+
+using namespace std;
+
+// parse a whole token as number
+static bool ParseNumber(const string& token, double& value)
+{
+	if (token.empty())return false;
+	char* end = nullptr;
+	value = strtod(token.c_str(), &end);
+	return end == token.c_str() + token.size();
+}
+
+// parse "x,y"
+static bool ParsePoint(const string& token, float& x, float& y)
+{
+	auto comma = token.find(',');
+	double vx, vy;
+	if (comma == string::npos)return false;
+	if (!ParseNumber(token.substr(0, comma), vx) || !ParseNumber(token.substr(comma + 1), vy))return false;
+	x = (float)vx;
+	y = (float)vy;
+	return true;
+}
+
+bool ParseValueList(const string& text, vector<double>& output)
+{
+	string::size_type begin = 0;
+	while (begin <= text.size())
+	{
+		auto end = text.find(';', begin);
+		if (end == string::npos)end = text.size();
+		double value;
+		string token = text.substr(begin, end - begin);
+		// an empty field is skipped, e.g. a trailing ';'
+		if (!token.empty())
+		{
+			if (!ParseNumber(token, value))return false;
+			output.push_back(value);
+		}
+		begin = end + 1;
+	}
+	return true;
+}
+
+double ValueAt(const vector<double>& values, int index)
+{
+	if (values.empty())return 0;
+	return index < (int)values.size() ? values[index] : values.back();
+}
+
+SceneDescription::SceneDescription()
+:gravityX(0)
+, gravityY(-100)
+, duration(10)
+, timestep(SIMULATION_TIMESTEP)
+, sample(0.04f)
+{
+}
+
+bool SceneDescription::parse(const string& text, string& error)
+{
+	istringstream lines(text);
+	string line;
+	int lineNumber = 0;
+	while (getline(lines, line))
+	{
+		lineNumber++;
+		auto comment = line.find('#');
+		if (comment != string::npos)line.erase(comment);
+
+		istringstream tokens(line);
+		vector<string> args;
+		string token;
+		while (tokens >> token)args.push_back(token);
+		if (args.empty())continue;
+
+		ostringstream where;
+		where << "line " << lineNumber << ": ";
+		const string& key = args[0];
+		double a, b;
+		if (key == "gravity")
+		{
+			if (args.size() != 3 || !ParseNumber(args[1], a) || !ParseNumber(args[2], b))
+			{
+				error = where.str() + "gravity <x> <y> expected";
+				return false;
+			}
+			gravityX = (float)a;
+			gravityY = (float)b;
+		}
+		else if (key == "duration" || key == "timestep" || key == "sample")
+		{
+			if (args.size() != 2 || !ParseNumber(args[1], a) || a <= 0)
+			{
+				error = where.str() + key + " <positive seconds> expected";
+				return false;
+			}
+			(key == "duration" ? duration : key == "timestep" ? timestep : sample) = (float)a;
+		}
+		else if (key == "vx" || key == "vy" || key == "fx" || key == "fy" || key == "friction")
+		{
+			auto& values = key == "vx" ? vx : key == "vy" ? vy : key == "fx" ? fx : key == "fy" ? fy : friction;
+			values.clear();
+			if (args.size() != 2 || !ParseValueList(args[1], values))
+			{
+				error = where.str() + key + " <v0;v1;...> expected";
+				return false;
+			}
+		}
+		else if (key == "polygon" || key == "circle")
+		{
+			BodyDescription body;
+			body.type = key == "polygon" ? SHAPE_POLYGON : SHAPE_CIRCLE;
+			body.isStatic = false;
+			body.mass = 0;
+			body.radius = 0;
+			size_t i = 1;
+			for (; i < args.size(); i++)
+			{
+				if (args[i] == "static")body.isStatic = true;
+				else if (args[i].compare(0, 5, "mass=") == 0 && ParseNumber(args[i].substr(5), a) && a > 0)body.mass = (float)a;
+				else break;
+			}
+			for (; i < args.size(); i++)
+			{
+				float x, y;
+				if (!ParsePoint(args[i], x, y))break;
+				body.points.push_back(x);
+				body.points.push_back(y);
+			}
+			if (body.type == SHAPE_POLYGON)
+			{
+				if (i != args.size() || body.points.size() < 6)
+				{
+					error = where.str() + "polygon [static] [mass=<m>] <x,y> <x,y> <x,y> ... expected";
+					return false;
+				}
+			}
+			else if (i + 1 != args.size() || body.points.size() != 2 || !ParseNumber(args[i], a) || a <= 0)
+			{
+				error = where.str() + "circle [static] [mass=<m>] <x,y> <radius> expected";
+				return false;
+			}
+			else body.radius = (float)a;
+			bodies.push_back(body);
+		}
+		else
+		{
+			error = where.str() + "unknown item '" + key + "'";
+			return false;
+		}
+	}
+	return true;
+}
+
+bool SceneDescription::load(const string& path, string& error)
+{
+	ifstream file(path.c_str());
+	if (!file)
+	{
+		error = "can not open " + path;
+		return false;
+	}
+	ostringstream text;
+	text << file.rdbuf();
+	return parse(text.str(), error);
+}
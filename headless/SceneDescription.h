@@ -0,0 +1,88 @@
+#ifndef __SCENE_DESCRIPTION_H__
+#define __SCENE_DESCRIPTION_H__
+
+#include <string>
+#include <vector>
+
+// body shape types
+#define SHAPE_POLYGON	0
+#define SHAPE_CIRCLE	1
+
+/**
+ * Body Description, a recognized shape
+ * Points are in world space, the same space as GameLayer
+ */
+struct BodyDescription
+{
+	int					type;		// SHAPE_POLYGON or SHAPE_CIRCLE
+	bool				isStatic;	// true if body never moves
+	float				mass;		// body mass, 0 to use default mass of shape type
+	std::vector<float>	points;		// polygon vertices x0,y0,x1,y1..., or circle center x,y
+	float				radius;		// circle radius
+};
+
+/**
+ * Scene Description
+ * Recognized shapes and the inputs ToolLayer collects, plain text, one item per line:
+ *   # comment
+ *   gravity <x> <y>
+ *   duration <seconds>
+ *   timestep <seconds>
+ *   sample <seconds>
+ *   vx|vy|fx|fy|friction <v0;v1;...>
+ *   polygon [static] [mass=<m>] <x,y> <x,y> <x,y> ...
+ *   circle [static] [mass=<m>] <x,y> <radius>
+ * Velocity, force & friction lists have the same meaning and units as ToolLayer text fields,
+ * they are applied to dynamic bodies by order, the last value is used by the rest.
+ */
+struct SceneDescription
+{
+	// Constructor, GameLayer defaults
+	SceneDescription();
+
+	float							gravityX;	// gravity
+	float							gravityY;
+	float							duration;	// simulated time, in seconds
+	float							timestep;	// fixed physics timestep, in seconds
+	float							sample;		// sampling interval, in seconds
+	std::vector<double>				vx;			// initial velocities, m/s
+	std::vector<double>				vy;
+	std::vector<double>				fx;			// applied forces, N
+	std::vector<double>				fy;
+	std::vector<double>				friction;	// friction of dynamic bodies by order, see MaterialTable
+	std::vector<BodyDescription>	bodies;		// bodies, by order
+
+	/**
+	 * Parse scene description text
+	 * @param text	scene description
+	 * @param error	OUTPUT, reason if parsing fails
+	 * @return true if parsed
+	 */
+	bool parse(const std::string& text, std::string& error);
+
+	/**
+	 * Load and parse scene description file
+	 * @param path	file path
+	 * @param error	OUTPUT, reason if loading fails
+	 * @return true if loaded
+	 */
+	bool load(const std::string& path, std::string& error);
+};
+
+/**
+ * Parse a semicolon separated list, the same format as ToolLayer text fields
+ * @param text		list text, e.g. "1;2.5;-3"
+ * @param output	OUTPUT, parsed values are appended
+ * @return true if all values are numbers
+ */
+bool ParseValueList(const std::string& text, std::vector<double>& output);
+
+/**
+ * Get a value from a ToolLayer-style list, the last value is used beyond its length
+ * @param values	value list
+ * @param index		index of dynamic body
+ * @return value, 0 if list is empty
+ */
+double ValueAt(const std::vector<double>& values, int index);
+
+#endif	/* __SCENE_DESCRIPTION_H__ */
@@ -0,0 +1,78 @@
+#include "SolverBenchmark.h"
+#include "headless/HeadlessWorld.h"
+#include "chipmunk/chipmunk.h"
+#include <chrono>
+#include <cmath>
+
+using namespace std;
+
+#define BENCHMARK_BOX_SIZE 10.0f	// box side, in world units
+#define BENCHMARK_BOX_GAP 1.0f		// gap between boxes at t=0
+#define BENCHMARK_GROUND_HEIGHT 20.0f
+
+void MakeBenchmarkScene(int boxCount, SceneDescription& scene)
+{
+	scene = SceneDescription();
+	// twice as many columns as rows, so stacks stay stable
+	int columns = (int)ceil(sqrt(boxCount * 2.0));
+	float pitch = BENCHMARK_BOX_SIZE + BENCHMARK_BOX_GAP;
+	float width = columns * pitch + BENCHMARK_BOX_SIZE * 4;
+
+	BodyDescription ground = {};
+	ground.type = SHAPE_POLYGON;
+	ground.isStatic = true;
+	float groundPoints[] = { 0, 0, width, 0, width, BENCHMARK_GROUND_HEIGHT, 0, BENCHMARK_GROUND_HEIGHT };
+	ground.points.assign(groundPoints, groundPoints + 8);
+	scene.bodies.push_back(ground);
+
+	for (int i = 0; i < boxCount; i++)
+	{
+		float x = BENCHMARK_BOX_SIZE * 2 + (i % columns) * pitch;
+		float y = BENCHMARK_GROUND_HEIGHT + BENCHMARK_BOX_GAP + (i / columns) * pitch;
+		BodyDescription box = {};
+		box.type = SHAPE_POLYGON;
+		float points[] = { x, y, x + BENCHMARK_BOX_SIZE, y, x + BENCHMARK_BOX_SIZE, y + BENCHMARK_BOX_SIZE, x, y + BENCHMARK_BOX_SIZE };
+		box.points.assign(points, points + 8);
+		scene.bodies.push_back(box);
+	}
+}
+
+SolverBenchmark::SolverBenchmark(int steps, int warmup)
+:_steps(steps)
+, _warmup(warmup)
+{
+}
+
+double SolverBenchmark::measure(const SceneDescription& scene, int threads)
+{
+	HeadlessWorld world;
+	world.setSolverThreads(threads, 0);
+	world.init(scene);
+	// resting stacks would fall asleep and skip solving
+	cpSpaceSetSleepTimeThreshold(world.getSpace(), INFINITY);
+
+	for (int i = 0; i < _warmup; i++)world.step();
+	auto begin = chrono::steady_clock::now();
+	for (int i = 0; i < _steps; i++)world.step();
+	chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - begin;
+	return _steps > 0 ? elapsed.count() / _steps : 0;
+}
+
+void SolverBenchmark::run(ostream& out, const vector<int>& bodyCounts, const vector<int>& threadCounts)
+{
+	out << "bodies,threads,ms_per_step,speedup\n";
+	for (auto count = bodyCounts.begin(); count != bodyCounts.end(); count++)
+	{
+		SceneDescription scene;
+		MakeBenchmarkScene(*count, scene);
+		double base = 0;
+		for (auto threads = threadCounts.begin(); threads != threadCounts.end(); threads++)
+		{
+			double ms = measure(scene, *threads);
+			// single-threaded run is the base, or the first run if there is none
+			if (*threads == 1 || base == 0)base = ms;
+			out << *count << ',' << *threads << ',' << ms << ',' << (ms > 0 ? base / ms : 0) << '\n';
+			out.flush();
+		}
+	}
+}
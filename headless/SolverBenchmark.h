@@ -0,0 +1,55 @@
+#ifndef __SOLVER_BENCHMARK_H__
+#define __SOLVER_BENCHMARK_H__
+
+#include <ostream>
+#include <vector>
+#include "headless/SceneDescription.h"
+
+/**
+ * Build a benchmark scene, boxes stacked in columns on a static ground, gravity as GameLayer
+ * @param boxCount	the number of dynamic boxes
+ * @param scene		OUTPUT, scene description
+ */
+void MakeBenchmarkScene(int boxCount, SceneDescription& scene);
+
+/**
+ * Solver Benchmark
+ * Times physics steps of benchmark scenes for every body count and solver thread count,
+ * every world is threaded regardless of its load, sleeping is disabled so every body is solved.
+ * Result is CSV, one row per run:
+ *   bodies,threads,ms_per_step,speedup
+ * speedup is relative to the single-threaded run of the same body count.
+ */
+class SolverBenchmark
+{
+public:
+
+	/**
+	 * Constructor
+	 * @param steps		timed steps per run
+	 * @param warmup	untimed steps before timing, bodies settle into contact
+	 */
+	SolverBenchmark(int steps = 200, int warmup = 50);
+
+	/**
+	 * Run benchmark and write rows as soon as they are measured
+	 * @param out			output stream
+	 * @param bodyCounts	dynamic boxes of each scene
+	 * @param threadCounts	solver threads of each run, 1 is the single-threaded space
+	 */
+	void run(std::ostream& out, const std::vector<int>& bodyCounts, const std::vector<int>& threadCounts);
+
+	/**
+	 * Time steps of one scene
+	 * @param scene		scene description
+	 * @param threads	solver threads, 1 is the single-threaded space
+	 * @return			mean milliseconds per step
+	 */
+	double measure(const SceneDescription& scene, int threads);
+
+private:
+	int	_steps;		// timed steps per run
+	int	_warmup;	// untimed steps per run
+};
+
+#endif	/* __SOLVER_BENCHMARK_H__ */
@@ -0,0 +1,114 @@
+#include "TimeSeries.h"
+#include <cmath>
+#include <cstdint>
+
+using namespace std;
+
+#define TIME_SERIES_VERSION 1
+
+void TimeSeries::sample(const HeadlessWorld& world)
+{
+	bodyCount = world.getBodyCount();
+	times.push_back(world.getTime());
+	size_t base = values.size();
+	values.resize(base + bodyCount * 4);
+	for (int i = 0; i < bodyCount; i++)world.getState(i, &values[base + i * 4]);
+}
+
+void SimulateScene(const SceneDescription& scene, TimeSeries& series, int solverThreads)
+{
+	HeadlessWorld world;
+	world.setSolverThreads(solverThreads);
+	world.init(scene);
+
+	// sample when simulated time reaches the next sample time, as GameLayer does
+	double nextSample = 0;
+	long long steps = (long long)ceil(scene.duration / scene.timestep - 1e-6);
+	for (long long s = 0; ; s++)
+	{
+		if (world.getTime() + 1e-6 >= nextSample)
+		{
+			series.sample(world);
+			nextSample += scene.sample;
+		}
+		if (s == steps)break;
+		world.step();
+	}
+}
+
+bool SolveScene(const SceneDescription& scene, TimeSeries& series, float& validUntil)
+{
+	// bodies are described from a world at t=0, so they match the simulated ones
+	HeadlessWorld world;
+	world.init(scene);
+	vector<KinematicBody> bodies;
+	world.describe(bodies);
+	KinematicsSolver solver(scene.gravityX, scene.gravityY);
+	bool solved = solver.solve(bodies, scene.duration);
+	validUntil = solver.getValidUntil();
+
+	int count = world.getBodyCount();
+	vector<float> initial(count * 4);
+	for (int i = 0; i < count; i++)world.getState(i, &initial[i * 4]);
+
+	series.bodyCount = count;
+	int samples = (int)floor(scene.duration / scene.sample + 1e-6) + 1;
+	for (int s = 0; s < samples; s++)
+	{
+		double t = s * (double)scene.sample;
+		series.times.push_back(t);
+		for (int i = 0; i < count; i++)
+		{
+			float dx, dy, vx, vy;
+			solver.getMotion(i).displacement(t, dx, dy);
+			solver.getMotion(i).velocity(t, vx, vy);
+			series.values.push_back(initial[i * 4] + dx);
+			series.values.push_back(initial[i * 4 + 1] + dy);
+			series.values.push_back(vx);
+			series.values.push_back(vy);
+		}
+	}
+	return solved;
+}
+
+void WriteTimeSeriesCsv(ostream& out, const TimeSeries& series)
+{
+	out << "t,body,x,y,vx,vy,speed\n";
+	WriteTimeSeriesCsvRows(out, series, "");
+}
+
+void WriteTimeSeriesCsvRows(ostream& out, const TimeSeries& series, const string& prefix)
+{
+	for (size_t s = 0; s < series.times.size(); s++)
+	{
+		for (int i = 0; i < series.bodyCount; i++)
+		{
+			const float* v = &series.values[(s * series.bodyCount + i) * 4];
+			float vx = v[2] / WORLD_UNITS_PER_METRE, vy = v[3] / WORLD_UNITS_PER_METRE;
+			out << prefix << series.times[s] << ',' << i << ','
+				<< v[0] / WORLD_UNITS_PER_METRE << ',' << v[1] / WORLD_UNITS_PER_METRE << ','
+				<< vx << ',' << vy << ',' << sqrt(vx * vx + vy * vy) << '\n';
+		}
+	}
+}
+
+static void WriteUInt32(ostream& out, uint32_t value)
+{
+	unsigned char bytes[4];
+	for (int i = 0; i < 4; i++)bytes[i] = (unsigned char)(value >> (i * 8));
+	out.write((const char*)bytes, 4);
+}
+
+void WriteTimeSeriesBinary(ostream& out, const TimeSeries& series)
+{
+	// floats are written in host order, little endian on supported platforms
+	out.write("SPVT", 4);
+	WriteUInt32(out, TIME_SERIES_VERSION);
+	WriteUInt32(out, series.bodyCount);
+	WriteUInt32(out, (uint32_t)series.times.size());
+	for (size_t s = 0; s < series.times.size(); s++)
+	{
+		out.write((const char*)&series.times[s], sizeof(double));
+		out.write((const char*)&series.values[s * series.bodyCount * 4], series.bodyCount * 4 * sizeof(float));
+	}
+}
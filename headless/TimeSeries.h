@@ -0,0 +1,80 @@
+#ifndef __TIME_SERIES_H__
+#define __TIME_SERIES_H__
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "headless/HeadlessWorld.h"
+
+// world units per metre, ToolLayer inputs in m/s are scaled by 10
+#define WORLD_UNITS_PER_METRE 10.0f
+
+/**
+ * Time Series, sampled states of dynamic bodies
+ * Values are in world units, x, y, vx, vy per body per sample
+ */
+struct TimeSeries
+{
+	int					bodyCount;	// dynamic bodies per sample
+	std::vector<double>	times;		// sample times, in seconds
+	std::vector<float>	values;		// x, y, vx, vy of each body, sample by sample
+
+	// Constructor, empty
+	TimeSeries()
+	:bodyCount(0)
+	{
+	}
+
+	/**
+	 * Append current states of world as a sample
+	 * @param world	headless world
+	 */
+	void sample(const HeadlessWorld& world);
+};
+
+/**
+ * Simulate a scene and sample it, t=0 included
+ * @param scene		scene description
+ * @param series	OUTPUT, sampled states
+ * @param solverThreads	solver worker threads of large scenes, 0 for all cores, 1 is single-threaded
+ * @see HeadlessWorld::setSolverThreads
+ */
+void SimulateScene(const SceneDescription& scene, TimeSeries& series, int solverThreads = 1);
+
+/**
+ * Solve a scene in closed form and sample it, t=0 included, no physics is stepped
+ * @param scene		scene description
+ * @param series	OUTPUT, exact states, or states of closed form motions beyond where they hold
+ * @param validUntil	OUTPUT, time all motions are exact until
+ * @return true if every motion is exact over scene duration
+ * @see KinematicsSolver
+ */
+bool SolveScene(const SceneDescription& scene, TimeSeries& series, float& validUntil);
+
+/**
+ * Write time series as CSV, one row per body per sample, in metres and m/s:
+ *   t,body,x,y,vx,vy,speed
+ * @param out		output stream
+ * @param series	sampled states
+ */
+void WriteTimeSeriesCsv(std::ostream& out, const TimeSeries& series);
+
+/**
+ * Write time series as CSV rows without header
+ * @param out		output stream
+ * @param series	sampled states
+ * @param prefix	leading columns of every row, e.g. "3,0.5,"
+ * @see WriteTimeSeriesCsv
+ */
+void WriteTimeSeriesCsvRows(std::ostream& out, const TimeSeries& series, const std::string& prefix);
+
+/**
+ * Write time series as binary, little endian, in world units:
+ *   "SPVT", uint32 version, uint32 body count, uint32 sample count,
+ *   per sample: float64 t, then float32 x, y, vx, vy per body
+ * @param out		output stream, opened in binary mode
+ * @param series	sampled states
+ */
+void WriteTimeSeriesBinary(std::ostream& out, const TimeSeries& series);
+
+#endif	/* __TIME_SERIES_H__ */
@@ -0,0 +1,201 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include "headless/SceneDescription.h"
+#include "headless/TimeSeries.h"
+#include "headless/ParameterSweep.h"
+#include "headless/SolverBenchmark.h"
+#include "headless/HullBenchmark.h"
+#include "headless/DelaunayBenchmark.h"
+#include <thread>
+
+using namespace std;
+
+// accepted difference between simulated and closed form velocities, m/s and fraction of max speed
+#define ANALYTIC_TOLERANCE 0.05
+#define ANALYTIC_RELATIVE_TOLERANCE 0.01
+
+static void PrintUsage(const char* name)
+{
+	fprintf(stderr,
+		"usage: %s <scene> [options]\n"
+		"       %s --benchmark [--threads <n>] [-o <file>]\n"
+		"       %s --hull-benchmark [-o <file>]\n"
+		"       %s --delaunay-benchmark [-o <file>]\n"
+		"  -o <file>          output file, stdout if not given\n"
+		"  --binary           write binary time series instead of CSV\n"
+		"  --duration <s>     simulated time, overrides scene\n"
+		"  --sample <s>       sampling interval, overrides scene\n"
+		"  --sweep <axis>     sweep a scene input, repeatable, every combination is simulated\n"
+		"                     <vx|vy|fx|fy|friction>[<index>]=<first>:<last>:<step> or =<v0;v1;...>\n"
+		"  --threads <n>      max threads for sweeps and benchmark, all cores if not given\n"
+		"  --solver-threads <n>  solver threads of scenes with 500+ bodies, 0 for all cores, default 1\n"
+		"  --benchmark        time steps of 100 to 5000 stacked boxes for 1, 2, 4... solver threads\n"
+		"  --hull-benchmark   time convex hulls of 8 to 2000 points against the old Graham scan\n"
+		"  --delaunay-benchmark  time Delaunay triangulations of 128 to 16384 points, serial vs split onto 2 threads\n"
+		"  --analytic         write closed form states instead of simulating, fails if scene has none\n"
+		"  --check-analytic   simulate and compare velocities with closed form, fails if they differ\n",
+		name, name, name, name);
+}
+
+/**
+ * Headless batch simulation
+ * Simulates a scene description as fast as possible and writes per-body position/velocity time series
+ */
+int main(int argc, char** argv)
+{
+	const char* scenePath = nullptr;
+	const char* outputPath = nullptr;
+	bool binary = false;
+	bool analytic = false, checkAnalytic = false;
+	double duration = 0, sample = 0;
+	int threads = 0, solverThreads = 1;
+	bool benchmark = false, hullBenchmark = false, delaunayBenchmark = false;
+	vector<SweepAxis> axes;
+	string error;
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-o") && i + 1 < argc)outputPath = argv[++i];
+		else if (!strcmp(argv[i], "--binary"))binary = true;
+		else if (!strcmp(argv[i], "--analytic"))analytic = true;
+		else if (!strcmp(argv[i], "--check-analytic"))checkAnalytic = true;
+		else if (!strcmp(argv[i], "--duration") && i + 1 < argc)duration = atof(argv[++i]);
+		else if (!strcmp(argv[i], "--sample") && i + 1 < argc)sample = atof(argv[++i]);
+		else if (!strcmp(argv[i], "--threads") && i + 1 < argc)threads = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--solver-threads") && i + 1 < argc)solverThreads = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--benchmark"))benchmark = true;
+		else if (!strcmp(argv[i], "--hull-benchmark"))hullBenchmark = true;
+		else if (!strcmp(argv[i], "--delaunay-benchmark"))delaunayBenchmark = true;
+		else if (!strcmp(argv[i], "--sweep") && i + 1 < argc)
+		{
+			SweepAxis axis;
+			if (!axis.parse(argv[++i], error))
+			{
+				fprintf(stderr, "--sweep %s\n", error.c_str());
+				return 2;
+			}
+			axes.push_back(axis);
+		}
+		else if (argv[i][0] != '-' && !scenePath)scenePath = argv[i];
+		else
+		{
+			PrintUsage(argv[0]);
+			return 2;
+		}
+	}
+	if (!scenePath && !benchmark && !hullBenchmark && !delaunayBenchmark)
+	{
+		PrintUsage(argv[0]);
+		return 2;
+	}
+
+	ofstream file;
+	if (outputPath)
+	{
+		file.open(outputPath, binary ? ios::binary : ios::out);
+		if (!file)
+		{
+			fprintf(stderr, "can not open %s\n", outputPath);
+			return 1;
+		}
+	}
+	ostream& out = outputPath ? file : cout;
+
+	// step time of growing scenes vs solver threads
+	if (benchmark)
+	{
+		int maxThreads = threads > 0 ? threads : (int)std::thread::hardware_concurrency();
+		vector<int> threadCounts;
+		for (int n = 1; n < maxThreads; n *= 2)threadCounts.push_back(n);
+		threadCounts.push_back(maxThreads > 1 ? maxThreads : 1);
+		int bodyCounts[] = { 100, 250, 500, 1000, 2500, 5000 };
+		SolverBenchmark solverBenchmark;
+		solverBenchmark.run(out, vector<int>(bodyCounts, bodyCounts + 6), threadCounts);
+		return out.good() ? 0 : 1;
+	}
+
+	// convex hull time of stroke-sized and large point sets
+	if (hullBenchmark)
+	{
+		int sizes[] = { 8, 16, 32, 64, 128, 400, 2000 };
+		HullBenchmark benchmark;
+		benchmark.run(out, vector<int>(sizes, sizes + 7));
+		return out.good() ? 0 : 1;
+	}
+
+	// Delaunay time around the grain of the parallel engine, see DELAUNAY_PARALLEL_GRAIN
+	if (delaunayBenchmark)
+	{
+		int sizes[] = { 128, 256, 512, 1024, 2048, 4096, 16384 };
+		DelaunayBenchmark benchmark;
+		benchmark.run(out, vector<int>(sizes, sizes + 7));
+		return out.good() ? 0 : 1;
+	}
+
+	SceneDescription scene;
+	if (!scene.load(scenePath, error))
+	{
+		fprintf(stderr, "%s: %s\n", scenePath, error.c_str());
+		return 1;
+	}
+	if (duration > 0)scene.duration = (float)duration;
+	if (sample > 0)scene.sample = (float)sample;
+
+	// compare simulated velocities with closed form ones at the same sample times
+	if (checkAnalytic)
+	{
+		TimeSeries simulated, exact;
+		float validUntil;
+		if (!SolveScene(scene, exact, validUntil))
+		{
+			fprintf(stderr, "no closed form after t=%f\n", validUntil);
+			return 1;
+		}
+		SimulateScene(scene, simulated, solverThreads);
+		size_t samples = simulated.times.size() < exact.times.size() ? simulated.times.size() : exact.times.size();
+		bool passed = true;
+		for (int i = 0; i < exact.bodyCount; i++)
+		{
+			double maxError = 0, maxSpeed = 0;
+			for (size_t s = 0; s < samples; s++)
+			{
+				const float* a = &simulated.values[(s * exact.bodyCount + i) * 4];
+				const float* b = &exact.values[(s * exact.bodyCount + i) * 4];
+				maxError = fmax(maxError, hypot(a[2] - b[2], a[3] - b[3]) / WORLD_UNITS_PER_METRE);
+				maxSpeed = fmax(maxSpeed, hypot(b[2], b[3]) / WORLD_UNITS_PER_METRE);
+			}
+			bool ok = maxError <= ANALYTIC_TOLERANCE + ANALYTIC_RELATIVE_TOLERANCE * maxSpeed;
+			printf("body %d: max velocity error %f m/s, max speed %f m/s, %s\n", i, maxError, maxSpeed, ok ? "ok" : "FAILED");
+			passed = passed && ok;
+		}
+		return passed ? 0 : 1;
+	}
+
+	if (!axes.empty())
+	{
+		ParameterSweep sweep(scene, axes);
+		fprintf(stderr, "sweeping %d variants\n", sweep.getVariantCount());
+		sweep.run(threads);
+		if (binary)sweep.writeBinary(out);
+		else sweep.writeCsv(out);
+		return out.good() ? 0 : 1;
+	}
+
+	TimeSeries series;
+	if (analytic)
+	{
+		float validUntil;
+		if (!SolveScene(scene, series, validUntil))
+		{
+			fprintf(stderr, "no closed form after t=%f\n", validUntil);
+			return 1;
+		}
+	}
+	else SimulateScene(scene, series, solverThreads);
+	if (binary)WriteTimeSeriesBinary(out, series);
+	else WriteTimeSeriesCsv(out, series);
+	return out.good() ? 0 : 1;
+}
@@ -26,6 +26,11 @@ void CanvasLayer::onMouseDown(EventMouse* event)
 	{
 		_startDrawLocation = convertToNodeSpace(event->getLocationInView());
 		_isDrawing = true;
+
+		// start a new stroke
+		std::vector<Vec2> points;
+		_decimator.begin(_startDrawLocation, points);
+		_lastStoredLocation = _startDrawLocation;
 	}
 	cocos2d::log("X: %f, Y: %f\n", event->getLocationInView().x, event->getLocationInView().y);
 }
@@ -36,13 +41,35 @@ void CanvasLayer::onMouseMove(EventMouse* event)
 	{
 		auto currentLocation = convertToNodeSpace(event->getLocationInView());
 		_currentDrawNode->drawLine(_startDrawLocation, currentLocation, _currentDrawNode->getBrushColor());
-		_currentDrawNode->addToPath(_startDrawLocation, currentLocation);
 		_startDrawLocation = currentLocation;
+
+		// only points kept by decimator are stored in path
+		std::vector<Vec2> points;
+		_decimator.add(currentLocation, points);
+		addDecimatedPoints(points);
 	}
 }
 
 void CanvasLayer::onMouseUp(EventMouse* event)
 {
+	// flush the end of current stroke
+	if (_isDrawing)
+	{
+		std::vector<Vec2> points;
+		_decimator.end(points);
+		addDecimatedPoints(points);
+	}
+
 	// mark status is not drawing when mouse up
 	_isDrawing = false;
 }
+
+void CanvasLayer::addDecimatedPoints(std::vector<Vec2>& points)
+{
+	for (auto p = points.begin(); p != points.end(); p++)
+	{
+		_currentDrawNode->addToPath(_lastStoredLocation, *p);
+		_lastStoredLocation = *p;
+	}
+	points.clear();
+}
@@ -3,6 +3,7 @@
 
 #include "cocos2d.h"
 #include "DrawableSprite.h"
+#include "geometry/StrokeDecimator.h"
 
 /**
  * Canvas Layer for draw shapes
@@ -38,6 +39,17 @@ public:
 	 */
 	virtual void onMouseUp(cocos2d::EventMouse* event);
 	
+	/**
+	 * Set stroke simplify thresholds of captured strokes
+	 * @param tolerance		max distance from a dropped point to the simplified stroke
+	 * @param minDistance	min distance between two stored points
+	 * @see StrokeDecimator
+	 */
+	void setStrokeDecimation(float tolerance, float minDistance)
+	{
+		_decimator.setThresholds(tolerance, minDistance);
+	}
+
 	/**
 	 * Static factory to create CanvasLayer object
 	 */
@@ -45,12 +57,21 @@ public:
 
 protected:
 
+	/**
+	 * Add points emitted by stroke decimator to current draw node
+	 * @param points	emitted points, cleared after added
+	 */
+	void addDecimatedPoints(std::vector<cocos2d::Vec2>& points);
+
 	DrawableSprite* _currentDrawNode;				// current draw node
 	cocos2d::EventListenerMouse* _mouseListener;	// mouse event listener
 	cocos2d::Size _canvasSize;						// canvas size
 
 	bool _isDrawing;								// drawing status
 	cocos2d::Vec2 _startDrawLocation;				// start draw location
+
+	StrokeDecimator _decimator;						// simplify strokes while capturing
+	cocos2d::Vec2 _lastStoredLocation;				// last location stored in current draw node
 };
 
 /**
@@ -68,6 +89,8 @@ public:
 	virtual void onEnter()
 	{ 
 		CanvasLayer::onEnter(); 
+		// keep fine details for gesture templates
+		setStrokeDecimation(0.5f, 1.0f);
 		_currentDrawNode = DrawableSprite::create();
 		this->addChild(_currentDrawNode);
 	}
@@ -4,6 +4,7 @@
 #include "math.h"
 #include "resource/Resources.h"
 #include "resource/ToolHintConstants.h"
+#include "chipmunk/chipmunk.h"
 
 USING_NS_CC;
 using namespace DollarRecognizer;
@@ -16,6 +17,32 @@ namespace
 {
 	const int DRAG_BODYS_TAG = 0x80;
 	const Vec2 GRAVITY(0, -100);
+
+	// thickness of the thickest shape of a body, a body is at least as thick as any of its convex pieces
+	float BodyThickness(PhysicsBody* body)
+	{
+		float thickness = 0;
+		auto& shapes = body->getShapes();
+		for (auto s = shapes.begin(); s != shapes.end(); s++)
+		{
+			if (auto polygon = dynamic_cast<PhysicsShapePolygon*>(*s))
+			{
+				vector<float> points;
+				for (int k = 0; k < polygon->getPointsCount(); k++)
+				{
+					Vec2 p = polygon->getPoint(k);
+					points.push_back(p.x);
+					points.push_back(p.y);
+				}
+				if (!points.empty())thickness = fmaxf(thickness, PolygonThickness(&points[0], (int)points.size() / 2));
+			}
+			else if (auto circle = dynamic_cast<PhysicsShapeCircle*>(*s))
+			{
+				thickness = fmaxf(thickness, circle->getRadius() * 2);
+			}
+		}
+		return thickness;
+	}
 }
 
 CanvasScene::CanvasScene()
@@ -109,6 +136,7 @@ void CanvasScene::startSimulate()
 	_gameLayer->init_f_y = _toolLayer->init_f_y;
 	_gameLayer->initVelocityForPhysicsBody();
 	_gameLayer->initForceForPhysicsBody();
+	_gameLayer->initMaterialForPhysicsBody();
 	//_toolLayer->updateTextFieldState(false);
 	log("game layer simluation: %d, %d", _gameLayer->init_friction.size(), _toolLayer->init_friction.size());
 	_canvasLayer->startGameSimulation();
@@ -117,8 +145,6 @@ void CanvasScene::startSimulate()
 	if (this->_debugDraw){ _physicsWorld->setDebugDrawMask(PhysicsWorld::DEBUGDRAW_ALL); }
 	_gameLayer->setParent(nullptr);
 	this->addChild(_gameLayer);
-	// start clock
-	_gameLayer->_begin_move = clock();
 }
 
 void CanvasScene::stopSimulate()
@@ -161,8 +187,15 @@ bool GameCanvasLayer::init()
 	_geoRecognizer = GeometricRecognizerNode::create();
 	this->addChild(_geoRecognizer);
 
+	// recognized sketches are rendered by stroke mesh, at the same order of drawn nodes
+	_strokeMesh = StrokeMesh::create();
+	this->addChild(_strokeMesh, 10);
+
 	// initialize pre-command handler
 	_preCmdHandlers.init();
+
+	// sketches are turned into physics shapes, coarser strokes are enough
+	setStrokeDecimation(1.5f, 3.0f);
 	
 	return true;
 }
@@ -222,14 +255,19 @@ void GameCanvasLayer::onMouseDown(cocos2d::EventMouse* event)
 	// if joint mode is enabled
 	if (_jointMode)
 	{
-		for (auto p = _drawNodeResultMap.begin(); p != _drawNodeResultMap.end(); p++)
+		// only nodes whose content rectangle is near the location are checked
+		Vec2 location = event->getLocationInView();
+		vector<DrawableSprite*> candidates;
+		_drawNodeIndex.query(location.x - DRAW_NODE_HIT_TOLERANCE, location.y - DRAW_NODE_HIT_TOLERANCE,
+			location.x + DRAW_NODE_HIT_TOLERANCE, location.y + DRAW_NODE_HIT_TOLERANCE, candidates);
+		for (auto p = candidates.begin(); p != candidates.end(); p++)
 		{
-			auto& rs = p->second;
-			if (rs._priority == 5)
+			auto r = _drawNodeResultMap.find(*p);
+			if (r != _drawNodeResultMap.end() && r->second._priority == 5)
 			{
-				if (rs._drawNode->containsPoint(event->getLocationInView()))
+				if ((*p)->containsPoint(location))
 				{
-					joints.push_back(rs._drawNode);
+					joints.push_back(*p);
 					break;
 				}
 			}
@@ -277,6 +315,21 @@ void GameCanvasLayer::removeUnrecognizedSprite(DrawableSprite* target)
 	target->runAction(sequence);
 }
 
+void GameCanvasLayer::removeChild(Node* child, bool cleanup)
+{
+	// child may be released by removeChild, forget it first
+	auto ds = dynamic_cast<DrawableSprite*>(child);
+	if (ds)
+	{
+		_drawNodeIndex.remove(ds);
+		_strokeMesh->removeSketch(ds);
+		_sketchAtlas.remove(ds);
+		_drawNodeResultMap.erase(ds);
+		_drawNodeList.remove(ds);
+	}
+	CanvasLayer::removeChild(child, cleanup);
+}
+
 void GameCanvasLayer::recognize()
 {
 	if (_jointMode)
@@ -298,8 +351,18 @@ void GameCanvasLayer::recognize()
 	}
 	else
 	{
+		// index before handling, so that handlers removing it keep index in sync
+		IndexDrawNode(_drawNodeIndex, _currentDrawNode);
+		PreCommandData data = { &_drawNodeResultMap, &_drawNodeIndex };
 		CommandHandler cmdh = _preCmdHandlers.getCommandHandler(rs.getGeometricType());
-		if (!cmdh._Empty())cmdh(rs, _drawNodeList, this, &_drawNodeResultMap);
+		if (!cmdh._Empty())cmdh(rs, _drawNodeList, this, &data);
+
+		// move finalized sketch to stroke mesh, if it's not removed by handler
+		if (_drawNodeIndex.contains(_currentDrawNode))
+		{
+			_strokeMesh->addSketch(_currentDrawNode);
+			_currentDrawNode->setMeshed(true);
+		}
 
 		// dispatch success event
 		EventCustom event(EVENT_RECOGNIZE_SUCCESS);
@@ -311,7 +374,7 @@ void GameCanvasLayer::recognize()
 
 GameLayer* GameCanvasLayer::createGameLayer()
 {
-	return GameLayer::create(this->_drawNodeList, this->_drawNodeResultMap, this->getScene());
+	return GameLayer::create(this->_drawNodeList, this->_drawNodeResultMap, this->_drawNodeIndex, this->_sketchAtlas, this->getScene());
 }
 
 void GameCanvasLayer::redrawCurrentNode()
@@ -667,23 +730,28 @@ bool GameLayer::init()
 		if (!ds->empty() && rs->_priority >= 0){ lazyQueue.push(rs); }
 	}
 
+	// prepare physics shape data and rasterize sketches into atlas on worker threads,
+	// both are cached by sketch content version, only sketches changed since last simulation are processed,
+	// textures are uploaded once, handlers only create sprites & bodies on main thread
+	vector<DrawableSprite*> drawNodes;
+	for (auto p = _drawNodeResultMap.begin(); p != _drawNodeResultMap.end(); p++)drawNodes.push_back(p->first);
+	preparePhysicsShapeData(drawNodes);
+	_sketchAtlas.add(drawNodes);
+	_sketchAtlas.upload();
+
 	// fetch recognized sprite from priority queue according to sprite priority
 	// generate sprite with physics body with post-command handler
+	PostCommandData data = { &_genSpriteResultMap, &_drawNodeIndex, &_genSpriteIndex, &_sketchAtlas, &_contactQueue };
 	while (!lazyQueue.empty())
 	{
 		auto rs = lazyQueue.top();
 		lazyQueue.pop();
 		auto cmdh = _postCmdHandlers.getCommandHandler(rs->getGeometricType());
-		if (!cmdh._Empty()) cmdh(*rs, _drawNodeList, this, &_genSpriteResultMap);
+		if (!cmdh._Empty()) cmdh(*rs, _drawNodeList, this, &data);
 	}
 
 	_drawVelocityLayer->setVisible(true);
 
-	// add concat listener
-	auto contactListener = EventListenerPhysicsContact::create();
-	contactListener->onContactPreSolve = CC_CALLBACK_1(GameLayer::onPhysicsContactBegin, this);
-	_eventDispatcher->addEventListenerWithSceneGraphPriority(contactListener, this);
-
 	// add draw velocity layer
 	this->addChild(_drawVelocityLayer);
 	_drawVelocityLayer->setParent(this);
@@ -695,9 +763,9 @@ bool GameLayer::init()
 	return true;
 }
 
-GameLayer *GameLayer::create(list<DrawableSprite*>& drawNodeList, DrawSpriteResultMap& drawNodeResultMap, Scene* scene)
+GameLayer *GameLayer::create(list<DrawableSprite*>& drawNodeList, DrawSpriteResultMap& drawNodeResultMap, DrawNodeIndex& drawNodeIndex, SketchAtlas& sketchAtlas, Scene* scene)
 {
-	GameLayer *ret = new (std::nothrow) GameLayer(drawNodeList, drawNodeResultMap);
+	GameLayer *ret = new (std::nothrow) GameLayer(drawNodeList, drawNodeResultMap, drawNodeIndex, sketchAtlas);
 	ret->setParent(scene);
 	if (ret && ret->init())
 	{
@@ -711,9 +779,18 @@ GameLayer *GameLayer::create(list<DrawableSprite*>& drawNodeList, DrawSpriteResu
 	}
 }
 
-GameLayer::GameLayer(list<DrawableSprite*>& drawNodeList, DrawSpriteResultMap& drawNodeResultMap)
+GameLayer::GameLayer(list<DrawableSprite*>& drawNodeList, DrawSpriteResultMap& drawNodeResultMap, DrawNodeIndex& drawNodeIndex, SketchAtlas& sketchAtlas)
 	:_drawNodeList(drawNodeList)
 	, _drawNodeResultMap(drawNodeResultMap)
+	, _drawNodeIndex(drawNodeIndex)
+	, _sketchAtlas(sketchAtlas)
+	, _nextSampleTime(0)
+	, _replaying(false)
+	, _kinematics(GRAVITY.x, GRAVITY.y)
+	, _kinematicsUntil(0)
+	, _sleepIdleSpeed(SIMULATION_SLEEP_IDLE_SPEED)
+	, _sleepTime(SIMULATION_SLEEP_TIME)
+	, _sleepApplied(false)
 {}
 
 void GameLayer::onEnter()
@@ -727,6 +804,7 @@ void GameLayer::onEnter()
 	*/
 	_gamekeyboardListener = EventListenerKeyboard::create();
 	_gamekeyboardListener->onKeyPressed = [&](EventKeyboard::KeyCode keyCode, Event * event){
+		if (!_replaying)_recorder.addEvent(SIMULATION_EVENT_KEY_PRESSED, (int)keyCode);
 		if (EventKeyboard::KeyCode::KEY_F == keyCode)
 		{
 			this->freePhysicsWorld();
@@ -734,7 +812,25 @@ void GameLayer::onEnter()
 		else if (EventKeyboard::KeyCode::KEY_D == keyCode){
 			this->nofreePhysicsWorld();
 		}
-		else if (EventKeyboard::KeyCode::KEY_G == keyCode){
+		else if (EventKeyboard::KeyCode::KEY_R == keyCode){
+			this->resetPhysicsWorld();
+		}
+		else if (EventKeyboard::KeyCode::KEY_P == keyCode){
+			this->toggleReplay();
+		}
+		else if (EventKeyboard::KeyCode::KEY_LEFT_ARROW == keyCode){
+			this->seekReplay(_player.getStep() - (int)(1 / _simulationClock.getTimestep()));
+		}
+		else if (EventKeyboard::KeyCode::KEY_RIGHT_ARROW == keyCode){
+			this->seekReplay(_player.getStep() + (int)(1 / _simulationClock.getTimestep()));
+		}
+		else if (EventKeyboard::KeyCode::KEY_MINUS == keyCode){
+			_simulationClock.setTimeScale(_simulationClock.getTimeScale() / 2);
+		}
+		else if (EventKeyboard::KeyCode::KEY_EQUAL == keyCode){
+			_simulationClock.setTimeScale(_simulationClock.getTimeScale() * 2);
+		}
+		else if (EventKeyboard::KeyCode::KEY_G == keyCode && !_replaying){
 			auto gravity = this->getScene()->getPhysicsWorld()->getGravity();
 			if (gravity == Vec2(0, 0)){
 				this->getScene()->getPhysicsWorld()->setGravity(GRAVITY);
@@ -742,12 +838,79 @@ void GameLayer::onEnter()
 			else{
 				this->getScene()->getPhysicsWorld()->setGravity(Vec2(0, 0));
 			}
+			_recorder.addEvent(SIMULATION_EVENT_GRAVITY, gravity == Vec2(0, 0) ? 1 : 0);
+			_kinematicsUntil = fmin(_kinematicsUntil, _simulationClock.getTime());
 		}
 	};
+	_gamekeyboardListener->onKeyReleased = [&](EventKeyboard::KeyCode keyCode, Event * event){
+		if (!_replaying)_recorder.addEvent(SIMULATION_EVENT_KEY_RELEASED, (int)keyCode);
+	};
 	_eventDispatcher->addEventListenerWithSceneGraphPriority(_gamekeyboardListener, this);
-	this->schedule(schedule_selector(GameLayer::updateVelocityText), 0.04);
+	// the only contact listener, subscribers get contacts after each step
+	_contactQueue.listen(this);
 	this->getScene()->getPhysicsWorld()->setGravity(GRAVITY);
 	_postCmdHandlers.makeJoints(this->getScene()->getPhysicsWorld(), jointsList, _genSpriteResultMap);
+
+	// capture t=0 after initial velocities, forces and joints are set
+	_simulatedNodes.clear();
+	for (auto i = _genSpriteResultMap.begin(); i != _genSpriteResultMap.end(); i++)
+	{
+		if (i->second->getPhysicsBody())_simulatedNodes.push_back(i->second);
+	}
+	_initialSnapshot.capture(_simulatedNodes);
+	_thicknesses.clear();
+	for (auto n = _simulatedNodes.begin(); n != _simulatedNodes.end(); n++)_thicknesses.push_back(BodyThickness((*n)->getPhysicsBody()));
+	_recorder.start(_initialSnapshot, _simulationClock.getTimestep());
+	_replaying = false;
+	solveKinematics();
+
+	// physics world is stepped in update by simulation clock instead of frame delta
+	this->getScene()->getPhysicsWorld()->setAutoStep(false);
+	_simulationClock.start();
+	_nextSampleTime = VELOCITY_SAMPLE_INTERVAL;
+	_sleepApplied = false;
+	_sleepingBodies.clear();
+	this->scheduleUpdate();
+}
+
+void GameLayer::update(float delta)
+{
+	Layer::update(delta);
+	auto physicsWorld = this->getScene()->getPhysicsWorld();
+	int steps = _simulationClock.advance();
+	for (int i = 0; i < steps; i++)
+	{
+		double t;
+		if (_replaying)
+		{
+			// bodies follow recorded states, world is not stepped
+			if (!_player.next())
+			{
+				freePhysicsWorld();
+				break;
+			}
+			_player.getSnapshot().restore(_simulatedNodes, SNAPSHOT_TRANSFORM | SNAPSHOT_VELOCITY);
+			t = _player.getTime();
+		}
+		else
+		{
+			// world is stepped by hand, PhysicsWorld::setSubsteps has no effect, so clock substeps split the step here,
+			// fast bodies split it further, so they can't pass through a surface between substeps
+			int substeps = _simulationClock.getSubsteps() * getAdaptiveSubsteps();
+			for (int s = 0; s < substeps; s++)physicsWorld->step(_simulationClock.getTimestep() / substeps);
+			_simulationClock.step();
+			_contactQueue.drain();
+			if (!_sleepApplied)_sleepApplied = applySleepThresholds();
+			_stepSnapshot.capture(_simulatedNodes);
+			_recorder.addStep(_stepSnapshot);
+			t = _simulationClock.getTime();
+		}
+		if (t + 1e-6 >= _nextSampleTime)
+		{
+			updateVelocityText(t);
+			_nextSampleTime += VELOCITY_SAMPLE_INTERVAL;
+		}
+	}
 }
 
 void GameLayer::initVelocityForPhysicsBody(){
@@ -806,6 +969,23 @@ void GameLayer::initVelocityForPhysicsBody(){
 	}
 }
 
+void GameLayer::initMaterialForPhysicsBody(){
+	MaterialTable materials;
+	materials.setFriction(init_friction);
+	int index = 0;
+	for (auto i = _genSpriteResultMap.begin(); i != _genSpriteResultMap.end(); i++)
+	{
+		auto cur = i->second->getPhysicsBody();
+		BodyMaterial material = cur->isDynamic() ? materials.getDynamic(index++) : materials.getStatic();
+		auto& shapes = cur->getShapes();
+		for (auto s = shapes.begin(); s != shapes.end(); s++)
+		{
+			(*s)->setFriction(material.friction);
+			(*s)->setRestitution(material.restitution);
+		}
+	}
+}
+
 void GameLayer::initForceForPhysicsBody(){
 	int index = 0;
 	for (auto i = _genSpriteResultMap.begin(); i != _genSpriteResultMap.end(); i++)
@@ -862,75 +1042,172 @@ void GameLayer::initForceForPhysicsBody(){
 }
 void GameLayer::freePhysicsWorld(){
 	log("free world");
-	auto index = 0;
-	auto gravity = this->getScene()->getPhysicsWorld()->getGravity();
-
-	if (gravity != Vec2(0, 0)){
-		this->getScene()->getPhysicsWorld()->setGravity(Vec2(0, 0));
-		for (auto i = _genSpriteResultMap.begin(); i != _genSpriteResultMap.end(); i++)
-		{
-			auto sprite = i->second;
-			auto cur = sprite->getPhysicsBody();
-			Vec2 vec = cur->getVelocity();
-			this->currentLocationMap[index] = vec;
-			if (cur->isDynamic()){
-				cur->setVelocity(Vec2(0, 0));
-				cur->setAngularVelocity(0);
-				cur->resetForces();
-				index++;
-			}
-		}
-		this->begin_free_time = clock();
-	}
-	
+	if (!_simulationClock.isPaused() && !_replaying)_recorder.addEvent(SIMULATION_EVENT_PAUSE, 1);
+	_simulationClock.pause();
 }
 
 void GameLayer::nofreePhysicsWorld() {
 	log("unfree world");
-	auto gravity = this->getScene()->getPhysicsWorld()->getGravity();
-	if (gravity == Vec2(0, 0)){
-		this->getScene()->getPhysicsWorld()->setGravity(GRAVITY);
-		int index = 0;
-		for (auto i = _genSpriteResultMap.begin(); i != _genSpriteResultMap.end(); i++)
+	if (_simulationClock.isPaused() && !_replaying)_recorder.addEvent(SIMULATION_EVENT_PAUSE, 0);
+	_simulationClock.resume();
+}
+
+void GameLayer::resetPhysicsWorld() {
+	log("reset world");
+	this->getScene()->getPhysicsWorld()->setGravity(GRAVITY);
+	_initialSnapshot.restore(_simulatedNodes);
+	_simulationClock.start();
+	_nextSampleTime = VELOCITY_SAMPLE_INTERVAL;
+	this->_drawVelocityLayer->reset();
+	_sleepingBodies.clear();
+	_recorder.start(_initialSnapshot, _simulationClock.getTimestep());
+	_replaying = false;
+	_kinematicsUntil = KINEMATICS_DURATION;
+}
+
+void GameLayer::setSleepThresholds(float idleSpeed, float sleepTime) {
+	_sleepIdleSpeed = idleSpeed;
+	_sleepTime = sleepTime;
+	_sleepApplied = false;
+}
+
+bool GameLayer::applySleepThresholds() {
+	// cocos2d keeps chipmunk space of physics world, it's reached by a body added to it
+	for (auto n = _simulatedNodes.begin(); n != _simulatedNodes.end(); n++)
+	{
+		cpSpace* space = cpBodyGetSpace((*n)->getPhysicsBody()->getCPBody());
+		if (!space)continue;
+		cpSpaceSetIdleSpeedThreshold(space, _sleepIdleSpeed);
+		cpSpaceSetSleepTimeThreshold(space, _sleepTime);
+		return true;
+	}
+	return false;
+}
+
+int GameLayer::getAdaptiveSubsteps() {
+	int substeps = 1;
+	for (int i = 0; i < (int)_simulatedNodes.size(); i++)
+	{
+		auto body = _simulatedNodes[i]->getPhysicsBody();
+		if (!body->isDynamic() || cpBodyIsSleeping(body->getCPBody()))continue;
+		substeps = max(substeps, AdaptiveSubsteps(body->getVelocity().length(), _thicknesses[i], _simulationClock.getTimestep()));
+	}
+	return substeps;
+}
+
+void GameLayer::toggleReplay() {
+	if (_replaying)
+	{
+		log("stop replay");
+		resetPhysicsWorld();
+		return;
+	}
+	if (!_player.open(_recorder.getData()))return;
+	log("replay %d steps", _player.getStepCount());
+	_replaying = true;
+	seekReplay(0);
+}
+
+void GameLayer::seekReplay(int step) {
+	if (!_replaying || !_player.seek(step))return;
+	_player.getSnapshot().restore(_simulatedNodes, SNAPSHOT_TRANSFORM | SNAPSHOT_VELOCITY);
+	// v-t plot restarts at the seeked step
+	this->_drawVelocityLayer->reset();
+	_nextSampleTime = _player.getTime() + VELOCITY_SAMPLE_INTERVAL;
+}
+
+void GameLayer::solveKinematics()
+{
+	// bodies as GameLayer made them, friction is the one set by initMaterialForPhysicsBody
+	vector<KinematicBody> bodies;
+	for (int i = 0; i < (int)_simulatedNodes.size(); i++)
+	{
+		auto cur = _simulatedNodes[i]->getPhysicsBody();
+		KinematicBody b = {};
+		b.isStatic = !cur->isDynamic();
+		b.mass = cur->getMass();
+		b.friction = cur->getShapes().empty() ? 0 : cur->getShapes().front()->getFriction();
+		b.vx = _initialSnapshot[i].vx;
+		b.vy = _initialSnapshot[i].vy;
+		b.fx = _initialSnapshot[i].fx;
+		b.fy = _initialSnapshot[i].fy;
+		auto& shapes = cur->getShapes();
+		for (auto s = shapes.begin(); s != shapes.end(); s++)
 		{
-			auto sprite = i->second;
-			auto cur = sprite->getPhysicsBody();
-			Vec2 vec = this->currentLocationMap.find(index)->second;
-			if (cur->isDynamic()){
-				cur->setVelocity(vec);
-				index++;
+			if (auto polygon = dynamic_cast<PhysicsShapePolygon*>(*s))
+			{
+				vector<float> points;
+				for (int k = 0; k < polygon->getPointsCount(); k++)
+				{
+					Vec2 p = cur->local2World(polygon->getPoint(k));
+					points.push_back(p.x);
+					points.push_back(p.y);
+				}
+				b.polygons.push_back(points);
+			}
+			else if (auto circle = dynamic_cast<PhysicsShapeCircle*>(*s))
+			{
+				Vec2 center = cur->local2World(circle->getOffset());
+				b.isCircle = true;
+				b.cx = center.x;
+				b.cy = center.y;
+				b.radius = circle->getRadius();
 			}
 		}
-		initForceForPhysicsBody();
-		this->end_free_time = clock();
-		this->freeze_time = (double)(this->end_free_time - this->begin_free_time) / CLOCKS_PER_SEC;
-		this->_drawVelocityLayer->freeze_time += this->freeze_time;
-		log("game free time:%f", this->freeze_time);
+		bodies.push_back(b);
 	}
+	bool solved = _kinematics.solve(bodies, KINEMATICS_DURATION);
+	_kinematicsUntil = KINEMATICS_DURATION;
+	log("closed form motions: %s, exact until %f", solved ? "all" : "partial", _kinematics.getValidUntil());
 }
 
-void GameLayer::updateVelocityText(float t)
+void GameLayer::updateVelocityText(double t)
 {
-	clock_t now = clock();
-	auto duration = (double)(now - _begin_move) / CLOCKS_PER_SEC;
 	int index = 0;
+	bool drawn = false;
 	for (auto i = _genSpriteResultMap.begin(); i != _genSpriteResultMap.end(); i++)
 		{
 			auto sprite = i->second;
 			auto cur = sprite->getPhysicsBody();
-			Vec2 vec = cur->getVelocity();
-			if (cur->isDynamic()){
-				_drawVelocityLayer->drawVelocityLine(vec, duration, index);
+			if (!cur->isDynamic())continue;
+			if ((int)_sleepingBodies.size() <= index)_sleepingBodies.push_back(false);
+
+			// a sleeping body keeps its velocity, its line is extended once it wakes
+			bool sleeping = cpBodyIsSleeping(cur->getCPBody()) != cpFalse;
+			if (sleeping)
+			{
+				_sleepingBodies[index] = true;
 				index++;
-			}		
+				continue;
+			}
+			if (_sleepingBodies[index])_drawVelocityLayer->holdVelocityLine(t - VELOCITY_SAMPLE_INTERVAL, index);
+			_sleepingBodies[index] = false;
+
+			Vec2 vec = cur->getVelocity();
+			// exact velocity while closed form motion holds, sampled physics after
+			if (index < _kinematics.getMotionCount() && t < _kinematicsUntil)
+			{
+				auto& motion = _kinematics.getMotion(index);
+				if (motion.type != KINEMATICS_NONE && t <= motion.validUntil)motion.velocity(t, vec.x, vec.y);
+			}
+			_drawVelocityLayer->drawVelocityLine(vec, t, index);
+			drawn = true;
+			index++;
 		}
+
+	// labels are updated once per sample, velocity label only if some body is awake
+	_drawVelocityLayer->updateTLabel(t);
+	if (drawn)_drawVelocityLayer->updateVLabel();
 }
 
 void GameLayer::onExit()
 {
+	this->unscheduleUpdate();
+	this->getScene()->getPhysicsWorld()->setAutoStep(true);
 	_drawVelocityLayer->setVisible(false);
 	this->stopAllActions();
 	_eventDispatcher->removeEventListenersForTarget(this);
+	_contactQueue.clear();
 	Layer::onExit();
 
 }
@@ -940,23 +1217,6 @@ void GameLayer::recordVelocityCallBack(cocos2d::Ref* pSender)
 	log("nothing");
 }
 
-bool GameLayer::onPhysicsContactBegin(const cocos2d::PhysicsContact& contact){
-	log("enter game layer listener:===============");
-	auto a = contact.getShapeA()->getBody();
-	auto b = contact.getShapeB()->getBody();
-	if (init_friction.size() > 0){
-		double friction = init_friction[0];
-		log("raw friction:%f", friction);
-		contact.getShapeA()->setFriction(friction);
-		contact.getShapeB()->setFriction(friction);
-	}
-	else{
-		contact.getShapeA()->setFriction(0);
-		contact.getShapeB()->setFriction(0);
-	}
-	return true;
-}
-
 bool DrawVelocityLayer::init(){
 	if (!CanvasLayer::init())
 	{
@@ -1017,46 +1277,51 @@ void DrawVelocityLayer::onExit(){
 }
 
 void DrawVelocityLayer::drawVelocityLine(Vec2 velocity, double t, int index){
-	t = t - this->freeze_time;
 	auto absolute_velocity = sqrt(pow(velocity.x, 2) + pow(velocity.y, 2));
 	auto value = _startDrawLineMap.find(index);
 	cocos2d::Color4F lineColor;
-	auto gravity = this->getScene()->getPhysicsWorld()->getGravity();
-	if (gravity == Vec2(0, 0)){
-
+	if (index < this->colorTypeNum) {
+		lineColor = this->lineColorMap.find(index)->second;
 	}
 	else{
-		if (index < this->colorTypeNum) {
-			lineColor = this->lineColorMap.find(index)->second;
-		}
-		else{
-			auto color_index = index % this->colorTypeNum;
-			lineColor = this->lineColorMap.find(color_index)->second;
-		}
-		Vec2 currentLocation = Vec2(t * 10 + ZERO_POINT_X, absolute_velocity / 10 + ZERO_POINT_Y);
-		auto label = DoubleToString(t) + " (/s)";
-		this->_TLabel->setString(label);
-		if (value != _startDrawLineMap.end()){
-			auto startDrawLineLocation = _startDrawLineMap.find(index)->second;
-			currentDrawLine->drawLine(startDrawLineLocation, currentLocation, lineColor);
-			_startDrawLineMap.erase(value);
-		}
+		auto color_index = index % this->colorTypeNum;
+		lineColor = this->lineColorMap.find(color_index)->second;
+	}
+	Vec2 currentLocation = Vec2(t * 10 + ZERO_POINT_X, absolute_velocity / 10 + ZERO_POINT_Y);
+	if (value != _startDrawLineMap.end()){
+		auto startDrawLineLocation = _startDrawLineMap.find(index)->second;
+		currentDrawLine->drawLine(startDrawLineLocation, currentLocation, lineColor);
+		_startDrawLineMap.erase(value);
+	}
+	else{
+		int length = this->startDrawLocationList.size();
+		if (index < length)
+			currentDrawLine->drawLine(startDrawLocationList[index], currentLocation, lineColor);
 		else{
-			int length = this->startDrawLocationList.size();
-			if (index < length)
-				currentDrawLine->drawLine(startDrawLocationList[index], currentLocation, lineColor);
-			else{
-				currentDrawLine->drawLine(startDrawLocationList[length - 1], currentLocation, currentDrawLine->getBrushColor());
-			}
+			currentDrawLine->drawLine(startDrawLocationList[length - 1], currentLocation, currentDrawLine->getBrushColor());
 		}
-		_startDrawLineMap[index] = currentLocation;
-		updateVLabel();
-		log("absolute_velocity:%f, time: %f", absolute_velocity / 10, t);
 	}
+	_startDrawLineMap[index] = currentLocation;
+	log("absolute_velocity:%f, time: %f", absolute_velocity / 10, t);
 	
 	//log("start location:%f,%f ", _startDrawLineLocation.x, _startDrawLineLocation.y);
 }
 
+void DrawVelocityLayer::holdVelocityLine(double t, int index){
+	auto value = _startDrawLineMap.find(index);
+	if (value == _startDrawLineMap.end())return;
+	Vec2 currentLocation = Vec2(t * 10 + ZERO_POINT_X, value->second.y);
+	if (currentLocation.x <= value->second.x)return;
+	cocos2d::Color4F lineColor = this->lineColorMap.find(index % this->colorTypeNum)->second;
+	currentDrawLine->drawLine(value->second, currentLocation, lineColor);
+	value->second = currentLocation;
+}
+
+void DrawVelocityLayer::updateTLabel(double t){
+	auto label = DoubleToString(t) + " (/s)";
+	this->_TLabel->setString(label);
+}
+
 void DrawVelocityLayer::updateVLabel(){
 	int length = _startDrawLineMap.size();
 	string velocity_str = "";
@@ -1068,6 +1333,14 @@ void DrawVelocityLayer::updateVLabel(){
 	this->_VLabel->setString(velocity_str);
 	this->_VLabel->setPosition(Vec2(ZERO_POINT_X + 24 * length * 1.8, 300));
 }
+void DrawVelocityLayer::reset(){
+	currentDrawLine->clear();
+	_startDrawLineMap.clear();
+	_VLabel->setString("0 (m/s)");
+	_VLabel->setPosition(Vec2(ZERO_POINT_X + 60, 300));
+	_TLabel->setString("0 (/s)");
+}
+
 void DrawVelocityLayer::InitLineColorMap(){
 	this->lineColorMap[0] = Color4F(1, 1, 1, 1);
 	this->lineColorMap[1] = Color4F(0, 1, 0, 1);
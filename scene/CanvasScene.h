@@ -6,6 +6,14 @@
 #include "DrawableSprite.h"
 #include "geometry/recognizer/GeometricRecognizerNode.h"
 #include "geometry/handler/CommandHandler.h"
+#include "StrokeMesh.h"
+#include "geometry/PhysicsWorldSnapshot.h"
+#include "geometry/SimulationRecording.h"
+#include "geometry/KinematicsSolver.h"
+#include "geometry/MaterialTable.h"
+#include "geometry/ContactEventQueue.h"
+#include "util/SimulationClock.h"
+#include "util/AdaptiveSubsteps.h"
 #include "ui/CocosGUI.h"
 #include "time.h"
 class CanvasScene;
@@ -23,6 +31,8 @@ class DrawVelocityLayer;
 
 #define ZERO_POINT_X 15
 #define ZERO_POINT_Y 15
+#define VELOCITY_SAMPLE_INTERVAL 0.04	// v-t sampling interval, in simulated seconds
+#define KINEMATICS_DURATION 60.0f		// time span closed form motions are checked over, in simulated seconds
 /**
  * Canvas/Game Scene
  * @see cocos2d::Scene
@@ -139,6 +149,13 @@ public:
 	 */
 	void removeUnrecognizedSprite(DrawableSprite* target);
 
+	/**
+	 * Remove a child, override
+	 * A removed drawn node is also removed from node list, result map and spatial index
+	 * @see cocos2d::Node::removeChild
+	 */
+	virtual void removeChild(cocos2d::Node* child, bool cleanup = true);
+
 	/**
 	 * Start game simulation
 	 */
@@ -172,6 +189,9 @@ private:
 
 	std::list<DrawableSprite*>	_drawNodeList;		// current drawn nodes 
 	DrawSpriteResultMap			_drawNodeResultMap;	// DrawableSprite-RecognizedSprite map
+	DrawNodeIndex				_drawNodeIndex;		// spatial index over recognized drawn nodes
+	StrokeMesh*					_strokeMesh;		// a pointer to mesh of recognized drawn nodes
+	SketchAtlas					_sketchAtlas;		// textures of recognized drawn nodes, kept across simulations
 	GeometricRecognizerNode*	_geoRecognizer;		// a pointer to GeometricRecognizerNode
 	PreCommandHandlerFactory	_preCmdHandlers;	// pre-command handlers
 
@@ -322,10 +342,14 @@ public:
 	 * Constructor
 	 * @param	current drawn nodes 
 	 * @param	DrawableSprite-RecognizedSprite map
+	 * @param	spatial index over recognized drawn nodes
+	 * @param	textures of recognized drawn nodes
 	 * @see DrawableSprite
 	 * @see DrawSpriteResultMap
+	 * @see DrawNodeIndex
+	 * @see SketchAtlas
 	 */
-	GameLayer(std::list<DrawableSprite*>&, DrawSpriteResultMap&);
+	GameLayer(std::list<DrawableSprite*>&, DrawSpriteResultMap&, DrawNodeIndex&, SketchAtlas&);
 	/**
 	 * Call when ToolLayer inititialized, override
 	 * @see cocos2d::Node::init
@@ -344,18 +368,27 @@ public:
 	 */
 	virtual void onExit();
 
+	/**
+	 * Step physics world by fixed timesteps due on simulation clock, override
+	 * @see SimulationClock
+	 */
+	virtual void update(float delta);
+
 	//void onAcceleration(Acceleration* acc, Event* event);
 
-	bool onPhysicsContactBegin(const cocos2d::PhysicsContact& contact);
 
 	/**
 	 * Implement the "static create" method manually with non-empty parameters
 	 */
-	static GameLayer *GameLayer::create(list<DrawableSprite*>&, DrawSpriteResultMap&, cocos2d::Scene*);
+	static GameLayer *GameLayer::create(list<DrawableSprite*>&, DrawSpriteResultMap&, DrawNodeIndex&, SketchAtlas&, cocos2d::Scene*);
 
 	void recordVelocityCallBack(cocos2d::Ref* pSender);
 
-	void updateVelocityText(float t);
+	/**
+	 * Sample velocities of dynamic bodies into v-t plot
+	 * @param t	simulated time, in seconds
+	 */
+	void updateVelocityText(double t);
 
 	std::vector<double> init_v_x;
 	std::vector<double> init_v_y;
@@ -363,23 +396,93 @@ public:
 	std::vector<double> init_f_x;
 	std::vector<double> init_f_y;
 
+	/**
+	 * Pause simulation, bodies keep their states
+	 */
 	void freePhysicsWorld();
+
+	/**
+	 * Resume simulation
+	 */
 	void nofreePhysicsWorld();
 
+	/**
+	 * Set body sleeping thresholds of physics world, bodies at rest are neither integrated nor plotted until they wake
+	 * @param idleSpeed	bodies slower than this are idle, in world units per second
+	 * @param sleepTime	bodies idle for this long fall asleep, in simulated seconds, INFINITY disables sleeping
+	 */
+	void setSleepThresholds(float idleSpeed, float sleepTime);
+
+	/**
+	 * Reset simulation to t=0
+	 * Bodies are restored from the snapshot captured when simulation started,
+	 * no sprite, body or joint is created again
+	 */
+	void resetPhysicsWorld();
+
+	/**
+	 * Start or stop replaying the recorded simulation
+	 * Replay decodes recorded body states instead of simulating, stopping replay resets to t=0
+	 */
+	void toggleReplay();
+
+	/**
+	 * Jump to a replayed step, nothing is done if not replaying
+	 * @param step	target step
+	 */
+	void seekReplay(int step);
+
+	/**
+	 * Solve closed form motions of lesson scenarios from bodies at t=0
+	 * @see KinematicsSolver
+	 */
+	void solveKinematics();
+
 	void initVelocityForPhysicsBody();
 	void initForceForPhysicsBody();
-	clock_t  _begin_move;
-	std::map<int, cocos2d::Vec2> currentLocationMap;
-	double freeze_time = 0;
-	clock_t begin_free_time;
-	clock_t end_free_time;
 
+	/**
+	 * Set friction & restitution on every shape once, dynamic bodies by order from init_friction
+	 * @see MaterialTable
+	 */
+	void initMaterialForPhysicsBody();
+
+	/**
+	 * Apply sleeping thresholds to chipmunk space, bodies are added to space by the first step
+	 * @return true if thresholds are applied
+	 */
+	bool applySleepThresholds();
+
+	/**
+	 * Get substeps the next fixed step is split into, the most any awake dynamic body needs
+	 * @see AdaptiveSubsteps
+	 */
+	int getAdaptiveSubsteps();
 
 private:
 	std::list<DrawableSprite*>& _drawNodeList;			// current drawn nodes 
 	DrawSpriteResultMap&		_drawNodeResultMap;		// DrawableSprite-RecognizedSprite map
 	GenSpriteResultMap			_genSpriteResultMap;	// DrawableSprite-Sprite map, generated sprites, with physics body
+	DrawNodeIndex&				_drawNodeIndex;			// spatial index over recognized drawn nodes
+	GenSpriteIndex				_genSpriteIndex;		// spatial index over generated sprites
+	SketchAtlas&				_sketchAtlas;			// textures of generated sprites
 	PostCommandHandlerFactory	_postCmdHandlers;		// post-command handlers
+	std::vector<cocos2d::Node*>	_simulatedNodes;		// generated sprites with physics body, in snapshot order
+	PhysicsWorldSnapshot		_initialSnapshot;		// body states at t=0
+	SimulationClock				_simulationClock;		// fixed timestep clock driving physics world
+	ContactEventQueue			_contactQueue;			// contacts of a physics step, drained after the step
+	float						_sleepIdleSpeed;		// idle speed threshold of body sleeping
+	float						_sleepTime;				// sleep time threshold of body sleeping
+	bool						_sleepApplied;			// true if thresholds are applied to space
+	std::vector<bool>			_sleepingBodies;		// dynamic bodies asleep at the last v-t sample, by index
+	std::vector<float>			_thicknesses;			// thickness of simulated bodies, in snapshot order
+	double						_nextSampleTime;		// simulated time of next v-t sample
+	PhysicsWorldSnapshot		_stepSnapshot;			// body states of the last step, to be recorded
+	SimulationRecorder			_recorder;				// records body states & inputs of every step
+	SimulationPlayer			_player;				// decodes recorded steps when replaying
+	bool						_replaying;				// true if bodies follow the player instead of physics
+	KinematicsSolver			_kinematics;			// closed form motions of dynamic bodies, plotted while exact
+	double						_kinematicsUntil;		// closed form motions are not used from this time, e.g. gravity toggled
 	DrawVelocityLayer           * _drawVelocityLayer;
 	cocos2d::EventListenerKeyboard* _gamekeyboardListener;
 };
@@ -413,12 +516,24 @@ public:
 
 	void drawVelocityLine(cocos2d::Vec2 velocity, double t, int index);
 
+	/**
+	 * Extend v-t line of a body with its last velocity, e.g. body slept since last sample
+	 * @param t		simulated time line is extended to
+	 * @param index	dynamic body index
+	 */
+	void holdVelocityLine(double t, int index);
+
+	/**
+	 * Show simulated time of the last sample
+	 * @param t	simulated time, in seconds
+	 */
+	void updateTLabel(double t);
+
 	CREATE_FUNC(DrawVelocityLayer);
 
 	std::vector<cocos2d::Vec2> startDrawLocationList;
 
 	void InitLineColorMap();
-	double freeze_time = 0;
 
 	std::string DoubleToString(double value)
 	 {
@@ -430,6 +545,11 @@ public:
 	}
 
 	void updateVLabel();
+
+	/**
+	 * Clear drawn v-t lines and labels, back to t=0
+	 */
+	void reset();
 private:
 	double t;
 	bool isDrawingLine;
@@ -10,6 +10,9 @@ using namespace DollarRecognizer;
 #define NORMALIZE_VEC2_TO_POINT2D(vec2, scale) Point2D((vec2.x-_xMin)/(scale), (vec2.y-_yMin)/(scale))
 #define POINT2D_TO_VEC2(p2d) Vec2((p2d).x, (p2d).y)
 
+// the last assigned content version, shared by all sprites so that versions are never reused
+static unsigned int s_contentVersion = 0;
+
 DrawableSprite::DrawableSprite()
 :_xMin(VisibleRect::width())
 , _xMax(0)
@@ -17,33 +20,65 @@ DrawableSprite::DrawableSprite()
 , _yMax(0)
 , _reference(nullptr)
 , _brushColor(Color4F::WHITE)
+, _meshed(false)
+, _contentVersion(++s_contentVersion)
 {
-	_lineWidth = 3;
+	_lineWidth = DRAW_NODE_LINE_WIDTH;
 }
 
 void DrawableSprite::addToPath(Vec2 from, Vec2 to)
 {
-	// add two new point to current path
-	this->_path.push_back(from); this->_path.push_back(to);
+	// start a new stroke if the line is not connected to the last point
+	if (_strokes.empty() || _strokes.back() != from)
+	{
+		_strokes.beginStroke();
+		addPoint(from);
+	}
+	addPoint(to);
+}
+
+void DrawableSprite::addPoint(const Vec2& p)
+{
+	// add new point to current stroke
+	_strokes.addPoint(p);
+	touchContent();
 
-	// calculate new bary center with 2 new points
-	_baryCenter = (_baryCenter*(_path.size() / 2 - 1) + (from + to) / 2) / (_path.size() / 2);
+	// calculate new bary center with the new point
+	int n = _strokes.pointCount();
+	_baryCenter = (_baryCenter*(n - 1) + p) / n;
 
 	// calculate new content border rectangle
-	_xMin = MIN(MIN(from.x, to.x), _xMin);
-	_xMax = MAX(MAX(from.x, to.x), _xMax);
-	_yMin = MIN(MIN(from.y, to.y), _yMin);
-	_yMax = MAX(MAX(from.y, to.y), _yMax);
+	_xMin = MIN(p.x, _xMin);
+	_xMax = MAX(p.x, _xMax);
+	_yMin = MIN(p.y, _yMin);
+	_yMax = MAX(p.y, _yMax);
+}
+
+void DrawableSprite::touchContent()
+{
+	_contentVersion = ++s_contentVersion;
 }
 
 void DrawableSprite::redraw()
 {
-	for (auto p = _path.begin(); p != _path.end(); p+=2)
+	for (int i = 0; i < _strokes.strokeCount(); i++)
 	{
-		this->drawLine(*p, *(p + 1), _brushColor);
+		auto stroke = _strokes.stroke(i);
+		for (int j = 1; j < stroke.size; j++)
+		{
+			this->drawLine(stroke[j - 1], stroke[j], _brushColor);
+		}
 	}
 }
 
+void DrawableSprite::setMeshed(bool meshed)
+{
+	if (meshed == _meshed)return;
+	_meshed = meshed;
+	if (meshed)clear();
+	else redraw();
+}
+
 DrawableSprite* DrawableSprite::createWithMultiStrokeGesture(const MultiStrokeGesture& multiStrokes)
 {
 	// convert MultiStrokeGesture to path
@@ -77,44 +112,40 @@ DrawableSprite* DrawableSprite::createWithMultiStrokeGesture(const MultiStrokeGe
 
 MultiStrokeGesture& DrawableSprite::getMultiStrokeGesture(MultiStrokeGesture& multiStrokes)
 {
-	// convert path to MultiStrokeGesture
-	// check current point is connect to next point in the path
-	// true if point in current stroke, false make a new stroke
-	Vec2 prev = *(_path.begin());
-	Path2D path;
-	path.push_back(NORMALIZE_VEC2_TO_POINT2D(prev, SCALE));
-	for (auto p = _path.begin(); p != _path.end(); p += 2)
+	// convert strokes to MultiStrokeGesture
+	for (int i = 0; i < _strokes.strokeCount(); i++)
 	{
-		Vec2 start = *p, end = *(p + 1);
-		if (start == prev)
-		{
-			path.push_back(NORMALIZE_VEC2_TO_POINT2D(prev, SCALE));
-		}
-		else
+		auto stroke = _strokes.stroke(i);
+		Path2D path;
+		path.reserve(stroke.size);
+		for (int j = 0; j < stroke.size; j++)
 		{
-			path.push_back(NORMALIZE_VEC2_TO_POINT2D(prev, SCALE));
-			multiStrokes.push_back(path);
-			path.clear();
-			path.push_back(NORMALIZE_VEC2_TO_POINT2D(start, SCALE));
+			path.push_back(NORMALIZE_VEC2_TO_POINT2D(stroke[j], SCALE));
 		}
-
-		prev = end;
+		multiStrokes.push_back(path);
 	}
-	multiStrokes.push_back(path);
 	return multiStrokes;
 }
 
 RecognitionResult DrawableSprite::recognize()
 {
-	if (!this->_path.empty())
+	if (!this->_strokes.empty())
 	{
-		MultiStrokeGesture multiStrokes;
-		getMultiStrokeGesture(multiStrokes);
-		auto path_length = multiStrokes[0].size();
-		log("path size: %d", path_length);
+		// gate on length instead of point count, strokes are decimated while captured,
+		// a long straight line may be stored as a few points
+		float path_length = _strokes.stroke(0).length();
+		log("path length: %f", path_length);
 		RecognitionResult result;
-		if (path_length> 10){
-			result = _geoRecognizer->Multirecognize(multiStrokes, "normal");
+		if (path_length > DRAW_NODE_MIN_STROKE_LENGTH){
+			// strokes are stored in drawing order, normalize all points into one path
+			const auto& points = _strokes.points();
+			Path2D combined;
+			combined.reserve(points.size());
+			for (int i = 0; i < points.size(); i++)
+			{
+				combined.push_back(NORMALIZE_VEC2_TO_POINT2D(points[i], SCALE));
+			}
+			result = _geoRecognizer->Multirecognize(combined, _strokes.strokeCount(), "normal");
 			log("Recognized gesture: %s, Score: %f", result.name.c_str(), result.score);
 		}
 		else{
@@ -129,23 +160,33 @@ Texture2D* DrawableSprite::createTexture()
 {
 	// use RenderTexture to generate Texture2D instance
 	auto _target = RenderTexture::create(VisibleRect::width(), VisibleRect::height(), Texture2D::PixelFormat::RGBA8888);
+	// a meshed path is drawn only while rendering
+	if (_meshed)redraw();
 	_target->begin();
 	this->visit();
 	_target->end();
+	if (_meshed)clear();
 	return _target->getSprite()->getTexture();
 }
 
 bool DrawableSprite::containsPoint(const Vec2& point)
 {
-	bool hasMin = false, hasMax = false;
+	// reject points out of content rectangle, expanded by hit tolerance
+	if (_strokes.empty()
+		|| point.x < _xMin - DRAW_NODE_HIT_TOLERANCE || point.x > _xMax + DRAW_NODE_HIT_TOLERANCE
+		|| point.y < _yMin - DRAW_NODE_HIT_TOLERANCE || point.y > _yMax + DRAW_NODE_HIT_TOLERANCE)
+		return false;
 
-	// compare (x, y) with all points in path
-	// true if find min =< (x, y) <= max, false otherwise
-	for (auto p = _path.begin(); p != _path.end(); p ++)
+	// rebuild segment grid if points or strokes were added since last build,
+	// strokes are not joined, the gap between two strokes is not a segment
+	const auto& points = _strokes.points();
+	if (_segmentGrid.pointCount() != points.size() || _segmentGrid.lineCount() != _strokes.strokeCount())
 	{
-		hasMin |= p->x <= point.x&&p->y <= point.y;
-		hasMax |= p->x >= point.x&&p->y >= point.y;
-		if (hasMin&&hasMax)return true;
+		_segmentGrid.build(points.xs.data(), points.ys.data(), points.size(),
+			_strokes.offsets().data(), _strokes.strokeCount(), DRAW_NODE_CLOSE_DISTANCE);
 	}
-	return false;
+
+	// true if the point is enclosed by a closed stroke, or close enough to any stroke
+	return _segmentGrid.pointInPolygon(point.x, point.y)
+		|| _segmentGrid.minDistance(point.x, point.y, DRAW_NODE_HIT_TOLERANCE) <= DRAW_NODE_HIT_TOLERANCE;
 }
\ No newline at end of file
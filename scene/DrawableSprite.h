@@ -3,6 +3,18 @@
 
 #include "cocos2d.h"
 #include "gesture/GeometricRecognizer.h"
+#include "scene/StrokeStore.h"
+#include "geometry/SegmentGrid.h"
+#include "geometry/PhysicsShapeData.h"
+
+// max distance from a point to the path, to be regarded as contained
+#define DRAW_NODE_HIT_TOLERANCE 10.0f
+// a stroke whose ends are closer than this is closed, it encloses points
+#define DRAW_NODE_CLOSE_DISTANCE 30.0f
+// line width of drawn path
+#define DRAW_NODE_LINE_WIDTH 3
+// first stroke shorter than this is regarded as a tap, it's not recognized
+#define DRAW_NODE_MIN_STROKE_LENGTH 20.0f
 
 /**
  * Drawable Sprite
@@ -43,6 +55,7 @@ public:
 
 	/**
 	 * Add a line to path
+	 * If the line does not start at the last point, a new stroke is started
 	 * @param from	a point the line from
 	 * @param to	a point the line to
 	 */
@@ -68,11 +81,22 @@ public:
 
 	/**
 	 * Get Shape Path
-	 * The centroid of the rectangle container
+	 * Points of all strokes, in drawing order
+	 * @return a copy of points
 	 */
-	const std::vector<cocos2d::Vec2>& getPath() const
+	std::vector<cocos2d::Vec2> getPath() const
 	{
-		return _path;
+		return _strokes.toVector();
+	}
+
+	/**
+	 * Get Strokes
+	 * @return stroke storage of current path, no points are copied
+	 * @see StrokeStore
+	 */
+	const StrokeStore& getStrokes() const
+	{
+		return _strokes;
 	}
 
 	/**
@@ -116,7 +140,7 @@ public:
 	 */
 	bool empty() const
 	{
-		return this->_path.empty();
+		return this->_strokes.empty();
 	}
 
 	/**
@@ -127,6 +151,7 @@ public:
 	void setBrushColor(const cocos2d::Color4F& newColor)
 	{
 		this->_brushColor = newColor;
+		this->touchContent();
 	}
 
 	/**
@@ -139,8 +164,64 @@ public:
 		return this->_brushColor;
 	}
 
+	/**
+	 * Set Physics Shape Data
+	 * @param data	shape data computed from current path
+	 * @see computePhysicsShapeData
+	 */
+	void setShapeData(const PhysicsShapeData& data)
+	{
+		this->_shapeData = data;
+	}
+
+	/**
+	 * Get Physics Shape Data
+	 * @return shape data, check hasShapeData before use
+	 */
+	const PhysicsShapeData& getShapeData() const
+	{
+		return this->_shapeData;
+	}
+
+	/**
+	 * Check if physics shape data is computed from current path
+	 * @return true if shape data is up to date, false otherwise
+	 */
+	bool hasShapeData() const
+	{
+		return this->_shapeData.version == this->_contentVersion;
+	}
+
+	/**
+	 * Get Content Version
+	 * It changes only when path or brush color changes, and is never shared by two contents,
+	 * so data generated from a sprite can be cached by it
+	 * @return content version
+	 */
+	unsigned int getContentVersion() const
+	{
+		return this->_contentVersion;
+	}
+
+	/**
+	 * Set if path is rendered by a stroke mesh
+	 * Lines drawn by this sprite are cleared when meshed, and drawn again when not
+	 * @param meshed	true if path is rendered by a stroke mesh
+	 * @see StrokeMesh
+	 */
+	void setMeshed(bool meshed);
+
+	/**
+	 * Check if path is rendered by a stroke mesh
+	 */
+	bool isMeshed() const
+	{
+		return this->_meshed;
+	}
+
 	/**
 	 * If this sprite contains the specified point
+	 * A point is contained if it is enclosed by a closed stroke, or it is close to a stroke within a hit tolerance
 	 * @param point	point to be checked
 	 * @return true if this sprite contains the specified point, false otherwise
 	 */
@@ -160,12 +241,27 @@ public:
 
 private:
 
+	/**
+	 * Add a point to current stroke, and update bary center & content rectangle
+	 * @param p	point to be added
+	 */
+	void addPoint(const cocos2d::Vec2& p);
+
+	/**
+	 * Mark content changed, a new content version is assigned
+	 */
+	void touchContent();
+
 	DollarRecognizer::GeometricRecognizer*	_geoRecognizer;				// pointer to GeometricRecognizer instance
 	cocos2d::Vec2							_baryCenter;				// bary center of current shape
-	std::vector<cocos2d::Vec2>				_path;						// store shape path
+	StrokeStore								_strokes;					// store shape path, stroke by stroke
+	SegmentGrid								_segmentGrid;				// path segments by y band, built lazily for hit testing
 	float									_xMin, _xMax, _yMin, _yMax;	// content rectangle achors
 	cocos2d::Color4F						_brushColor;				// brush color used to draw shapes
 	DrawableSprite*							_reference;					// not used
+	bool									_meshed;					// true if path is rendered by a stroke mesh
+	PhysicsShapeData						_shapeData;					// physics shape data computed from path
+	unsigned int							_contentVersion;			// content version, changes with path & brush color
 };
 
 #endif	/* __DRAWABLE_SPRITE_H__ */
\ No newline at end of file
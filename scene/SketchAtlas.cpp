@@ -0,0 +1,242 @@
+#include "SketchAtlas.h"
+#include "geometry/StrokeRasterizer.h"
+#include "util/ParallelFor.h"
+
+USING_NS_CC;
+using namespace std;
+
+// transparent border around a sketch, enough for half line width and the antialiased edge
+#define SKETCH_PADDING (DRAW_NODE_LINE_WIDTH / 2.0f + 1.0f)
+// empty pixels between regions, so that linear filtering does not sample neighbours
+#define SKETCH_GUTTER 1
+
+SketchAtlas::SketchAtlas()
+:_usedArea(0)
+, _deadArea(0)
+{
+}
+
+SketchAtlas::~SketchAtlas()
+{
+	clear();
+}
+
+bool SketchAtlas::add(DrawableSprite* drawNode)
+{
+	if (drawNode->empty())return false;
+	add(vector<DrawableSprite*>(1, drawNode));
+	return true;
+}
+
+void SketchAtlas::add(const vector<DrawableSprite*>& drawNodes)
+{
+	// sketches to be rasterized, new ones or changed since rasterized
+	vector<DrawableSprite*> changed;
+	for (auto p = drawNodes.begin(); p != drawNodes.end(); p++)
+	{
+		if ((*p)->empty())continue;
+		auto r = _regions.find(*p);
+		if (r == _regions.end() || r->second.version != (*p)->getContentVersion())changed.push_back(*p);
+	}
+	if (changed.empty())return;
+
+	// too much unused space, pack all sketches again
+	if (_deadArea > _usedArea)compact(changed);
+
+	// allocate on calling thread, pages do not grow while rasterizing
+	vector<pair<DrawableSprite*, Region> > pending;
+	for (auto p = changed.begin(); p != changed.end(); p++)
+	{
+		pending.push_back(pair<DrawableSprite*, Region>(*p, allocate(*p)));
+	}
+
+	// regions do not overlap, so they are written concurrently
+	ParallelFor(0, pending.size(), [&](int i)
+	{
+		rasterize(pending[i].first, pending[i].second);
+	});
+}
+
+void SketchAtlas::remove(DrawableSprite* drawNode)
+{
+	auto r = _regions.find(drawNode);
+	if (r == _regions.end())return;
+	_usedArea -= r->second.width * r->second.height;
+	_deadArea += r->second.width * r->second.height;
+	_regions.erase(r);
+}
+
+SketchAtlas::Region SketchAtlas::allocate(DrawableSprite* drawNode)
+{
+	// region covers content rectangle and padding, allocate whole pixels
+	Rect content = drawNode->contentRect();
+	float w = content.size.width + SKETCH_PADDING * 2;
+	float h = content.size.height + SKETCH_PADDING * 2;
+	int iw = (int)ceilf(w), ih = (int)ceilf(h);
+
+	Region region;
+	auto r = _regions.find(drawNode);
+	if (r != _regions.end() && r->second.width >= iw && r->second.height >= ih)
+	{
+		// the old region is large enough, clear it and draw again in place
+		region = r->second;
+		Page& page = _pages[region.page];
+		int x = (int)region.rect.origin.x, y = (int)region.rect.origin.y;
+		for (int j = 0; j < region.height; j++)
+		{
+			memset(page.pixels.data() + ((y + j) * page.width + x) * 4, 0, region.width * 4);
+		}
+	}
+	else
+	{
+		// the old region is no longer used
+		if (r != _regions.end())
+		{
+			_usedArea -= r->second.width * r->second.height;
+			_deadArea += r->second.width * r->second.height;
+		}
+		region = allocate(iw, ih);
+		region.width = iw;
+		region.height = ih;
+		_usedArea += iw * ih;
+	}
+	region.rect.size = Size(w, h);
+	region.version = drawNode->getContentVersion();
+	_regions[drawNode] = region;
+	_pages[region.page].dirty = true;
+	return region;
+}
+
+void SketchAtlas::compact(vector<DrawableSprite*>& drawNodes)
+{
+	// all sketches in atlas have to be rasterized again
+	for (auto r = _regions.begin(); r != _regions.end(); r++)
+	{
+		if (find(drawNodes.begin(), drawNodes.end(), r->first) == drawNodes.end())drawNodes.push_back(r->first);
+	}
+
+	// sprites created from old pages retain their textures
+	clear();
+}
+
+void SketchAtlas::rasterize(DrawableSprite* drawNode, const Region& region)
+{
+	// rasterize strokes, the bottom-left corner of region is mapped to the padded content corner
+	Rect content = drawNode->contentRect();
+	int w = (int)ceilf(region.rect.size.width), h = (int)ceilf(region.rect.size.height);
+	Page& page = _pages[region.page];
+	int x = (int)region.rect.origin.x, y = (int)region.rect.origin.y;
+	unsigned char* pixels = page.pixels.data() + (y * page.width + x) * 4;
+	Color4B color(drawNode->getBrushColor());
+	unsigned char rgba[4] = { color.r, color.g, color.b, color.a };
+	const StrokeStore& strokes = drawNode->getStrokes();
+	for (int i = 0; i < strokes.strokeCount(); i++)
+	{
+		StrokeView stroke = strokes.stroke(i);
+		RasterizePolyline(stroke.xs, stroke.ys, stroke.size,
+			content.getMinX() - SKETCH_PADDING, content.getMinY() - SKETCH_PADDING,
+			DRAW_NODE_LINE_WIDTH, rgba, pixels, page.width * 4, w, h);
+	}
+}
+
+void SketchAtlas::upload()
+{
+	for (auto p = _pages.begin(); p != _pages.end(); p++)
+	{
+		if (!p->dirty)continue;
+
+		// update texture in place if page size is not changed
+		if (p->texture && p->texture->getPixelsWide() == p->width && p->texture->getPixelsHigh() == p->height)
+		{
+			p->texture->updateWithData(p->pixels.data(), 0, 0, p->width, p->height);
+			p->dirty = false;
+			continue;
+		}
+
+		// otherwise, create a new texture
+		CC_SAFE_RELEASE_NULL(p->texture);
+		p->texture = new (std::nothrow) Texture2D();
+		if (p->texture && !p->texture->initWithData(p->pixels.data(), p->pixels.size(),
+			Texture2D::PixelFormat::RGBA8888, p->width, p->height, Size(p->width, p->height)))
+		{
+			CC_SAFE_RELEASE_NULL(p->texture);
+		}
+		p->dirty = false;
+	}
+}
+
+Texture2D* SketchAtlas::getTexture(DrawableSprite* drawNode, Rect& rect) const
+{
+	auto p = _regions.find(drawNode);
+	if (p == _regions.end())return nullptr;
+	rect = p->second.rect;
+	return _pages[p->second.page].texture;
+}
+
+void SketchAtlas::clear()
+{
+	for (auto p = _pages.begin(); p != _pages.end(); p++)
+	{
+		CC_SAFE_RELEASE_NULL(p->texture);
+	}
+	_pages.clear();
+	_regions.clear();
+	_usedArea = 0;
+	_deadArea = 0;
+}
+
+SketchAtlas::Region SketchAtlas::allocate(int w, int h)
+{
+	Region region;
+	int gw = w + SKETCH_GUTTER, gh = h + SKETCH_GUTTER;
+
+	// best fit: the shortest existing shelf with enough space
+	int bestPage = -1, bestShelf = -1;
+	for (int i = 0; i < (int)_pages.size(); i++)
+	{
+		Page& page = _pages[i];
+		for (int j = 0; j < (int)page.shelves.size(); j++)
+		{
+			Shelf& s = page.shelves[j];
+			if (s.height >= gh && s.cursor + gw <= page.width
+				&& (bestShelf < 0 || s.height < _pages[bestPage].shelves[bestShelf].height))
+			{
+				bestPage = i;
+				bestShelf = j;
+			}
+		}
+	}
+
+	// otherwise, open a new shelf on a page with enough height left, or on a new page
+	if (bestShelf < 0)
+	{
+		for (int i = 0; i < (int)_pages.size() && bestPage < 0; i++)
+		{
+			if (_pages[i].width >= gw && _pages[i].height + gh <= SKETCH_ATLAS_PAGE_HEIGHT)bestPage = i;
+		}
+		if (bestPage < 0)
+		{
+			Page page;
+			page.width = MAX(SKETCH_ATLAS_PAGE_WIDTH, gw);
+			page.height = 0;
+			page.texture = nullptr;
+			page.dirty = false;
+			_pages.push_back(page);
+			bestPage = _pages.size() - 1;
+		}
+
+		// a page grows by the new shelf, new rows are transparent
+		Page& page = _pages[bestPage];
+		Shelf s = { page.height, gh, 0 };
+		page.shelves.push_back(s);
+		page.height += gh;
+		page.pixels.resize(page.width * page.height * 4, 0);
+		bestShelf = page.shelves.size() - 1;
+	}
+
+	Shelf& s = _pages[bestPage].shelves[bestShelf];
+	region.page = bestPage;
+	region.rect = Rect(s.cursor, s.y, w, h);
+	s.cursor += gw;
+	return region;
+}
@@ -0,0 +1,117 @@
+#ifndef __SKETCH_ATLAS_H__
+#define __SKETCH_ATLAS_H__
+
+#include "cocos2d.h"
+#include "scene/DrawableSprite.h"
+
+#define SKETCH_ATLAS_PAGE_WIDTH 1024
+#define SKETCH_ATLAS_PAGE_HEIGHT 2048
+
+/**
+ * Sketch Atlas
+ * Sketches are rasterized on CPU into tight regions of shared texture pages, packed shelf by shelf.
+ * A page only grows as tall as its used shelves, so texture memory scales with sketch area.
+ * Region rows go along +y of the sketch, so a sprite created from a region is flipped in Y,
+ * the same as a sprite created with DrawableSprite::createTexture.
+ * Regions are cached by sketch content version, only changed sketches are rasterized again,
+ * space of removed or moved regions is reclaimed when it exceeds the space in use.
+ */
+class SketchAtlas
+{
+public:
+
+	// Constructor
+	SketchAtlas();
+
+	// Destructor, release textures
+	~SketchAtlas();
+
+	/**
+	 * Rasterize a sketch into a free region, nothing is done if it's in atlas with the same content version
+	 * Textures are not updated until upload is called
+	 * @param drawNode	sketch to be rasterized
+	 * @return true if the sketch is in atlas, false if it's empty
+	 */
+	bool add(DrawableSprite* drawNode);
+
+	/**
+	 * Rasterize sketches into free regions, sketches in atlas with the same content version are skipped
+	 * Regions are allocated first, then sketches are rasterized on worker threads
+	 * @param drawNodes	sketches to be rasterized
+	 */
+	void add(const std::vector<DrawableSprite*>& drawNodes);
+
+	/**
+	 * Remove a sketch, its region becomes unused space
+	 * @param drawNode	sketch to be removed
+	 */
+	void remove(DrawableSprite* drawNode);
+
+	/**
+	 * Upload pages changed since last upload to textures
+	 */
+	void upload();
+
+	/**
+	 * Get texture & texture rectangle of a sketch
+	 * @param drawNode	sketch added to atlas
+	 * @param rect		OUTPUT, region of sketch in texture, in pixels
+	 * @return texture of the page holding the sketch, nullptr if it's not in atlas or not uploaded
+	 */
+	cocos2d::Texture2D* getTexture(DrawableSprite* drawNode, cocos2d::Rect& rect) const;
+
+	/**
+	 * Remove all sketches and release textures
+	 */
+	void clear();
+
+private:
+
+	// a row of regions with the same height limit
+	struct Shelf
+	{
+		int y;			// bottom row of shelf
+		int height;		// shelf height
+		int cursor;		// x of the next free column
+	};
+
+	// a texture page
+	struct Page
+	{
+		int							width;		// page width
+		int							height;		// used height, sum of shelf heights
+		std::vector<unsigned char>	pixels;		// RGBA8888 pixels, width * height
+		std::vector<Shelf>			shelves;	// shelves from bottom to top
+		cocos2d::Texture2D*			texture;	// uploaded texture
+		bool						dirty;		// true if pixels changed since last upload
+	};
+
+	// a sketch region in atlas
+	struct Region
+	{
+		int				page;		// page index
+		cocos2d::Rect	rect;		// region in page, in pixels
+		int				width;		// allocated width, in pixels
+		int				height;		// allocated height, in pixels
+		unsigned int	version;	// content version of the rasterized sketch
+	};
+
+	// allocate a w*h region, new shelf or page is created if there is no space
+	Region allocate(int w, int h);
+
+	// allocate a region for a sketch, the old region is reused if it's large enough
+	Region allocate(DrawableSprite* drawNode);
+
+	// drop all pages, sketches in atlas are allocated again
+	void compact(std::vector<DrawableSprite*>& drawNodes);
+
+	// rasterize a sketch into its region, regions of different sketches can be rasterized concurrently
+	void rasterize(DrawableSprite* drawNode, const Region& region);
+
+	std::vector<Page>						_pages;		// texture pages
+	std::map<DrawableSprite*, Region>		_regions;	// sketch-region map
+	int										_usedArea;	// area of regions in use, in pixels
+	int										_deadArea;	// area of regions no longer used, in pixels
+};
+
+#endif	/* __SKETCH_ATLAS_H__ */
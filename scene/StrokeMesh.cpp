@@ -0,0 +1,61 @@
+#include "StrokeMesh.h"
+#include "geometry/StrokeTessellator.h"
+#include <algorithm>
+
+USING_NS_CC;
+using namespace std;
+
+void StrokeMesh::addSketch(DrawableSprite* drawNode)
+{
+	if (drawNode->empty() || containsSketch(drawNode))return;
+
+	Range range;
+	range.sketch = drawNode;
+	range.first = _vertices.size();
+	range.color = drawNode->getBrushColor();
+	const StrokeStore& strokes = drawNode->getStrokes();
+	for (int i = 0; i < strokes.strokeCount(); i++)
+	{
+		StrokeView stroke = strokes.stroke(i);
+		TessellatePolyline(stroke.xs, stroke.ys, stroke.size, DRAW_NODE_LINE_WIDTH / 2.0f, _vertices);
+	}
+	range.count = _vertices.size() - range.first;
+	_ranges.push_back(range);
+
+	// append only the new triangles
+	emit(range);
+}
+
+bool StrokeMesh::removeSketch(DrawableSprite* drawNode)
+{
+	auto p = findRange(drawNode);
+	if (p == _ranges.end())return false;
+
+	// drop its vertices, ranges after it move forward
+	Range removed = *p;
+	int index = p - _ranges.cbegin();
+	_vertices.erase(_vertices.begin() + removed.first, _vertices.begin() + removed.first + removed.count);
+	_ranges.erase(_ranges.begin() + index);
+	for (int i = index; i < (int)_ranges.size(); i++)_ranges[i].first -= removed.count;
+
+	// draw buffer holds ranges by vertex order, 2 floats per vertex, it's cut where the removed
+	// range began, and triangles after it are emitted again, no path is tessellated again
+	_bufferCount = removed.first / 2;
+	_dirty = true;
+	for (int i = index; i < (int)_ranges.size(); i++)emit(_ranges[i]);
+	return true;
+}
+
+vector<StrokeMesh::Range>::const_iterator StrokeMesh::findRange(DrawableSprite* drawNode) const
+{
+	return find_if(_ranges.begin(), _ranges.end(), [drawNode](const Range& r){ return r.sketch == drawNode; });
+}
+
+void StrokeMesh::emit(const Range& range)
+{
+	const float* v = _vertices.data() + range.first;
+	for (int i = 0; i + 6 <= range.count; i += 6)
+	{
+		drawTriangle(Vec2(v[i], v[i + 1]), Vec2(v[i + 2], v[i + 3]), Vec2(v[i + 4], v[i + 5]), range.color);
+	}
+}
@@ -0,0 +1,66 @@
+#ifndef __STROKE_MESH_H__
+#define __STROKE_MESH_H__
+
+#include "cocos2d.h"
+#include "scene/DrawableSprite.h"
+
+/**
+ * Stroke Mesh
+ * Finalized sketches of a canvas tessellated into one triangle buffer, rendered in a single draw call.
+ * Each stroke is a joined triangle strip, colors are stored per vertex, so sketches of any color share the buffer.
+ * Sketches are appended incrementally, removing one keeps the tessellated triangles of others,
+ * only triangles after it are emitted again, so sketches keep their stacking order.
+ * @see cocos2d::DrawNode
+ */
+class StrokeMesh : public cocos2d::DrawNode
+{
+public:
+
+	/**
+	 * Tessellate path of a sketch and append it to mesh, nothing is done if it's already in mesh
+	 * @param drawNode	sketch to be appended
+	 */
+	void addSketch(DrawableSprite* drawNode);
+
+	/**
+	 * Remove a sketch from mesh
+	 * @param drawNode	sketch to be removed
+	 * @return true if the sketch was in mesh, false otherwise
+	 */
+	bool removeSketch(DrawableSprite* drawNode);
+
+	/**
+	 * Check if a sketch is in mesh
+	 */
+	bool containsSketch(DrawableSprite* drawNode) const
+	{
+		return findRange(drawNode) != _ranges.end();
+	}
+
+	/**
+	 * Static factory to create StrokeMesh object with non-parameters
+	 */
+	CREATE_FUNC(StrokeMesh);
+
+private:
+
+	// triangles of a sketch in vertex buffer
+	struct Range
+	{
+		DrawableSprite*		sketch;	// sketch the triangles belong to
+		int					first;	// index of the first float
+		int					count;	// the number of floats
+		cocos2d::Color4F	color;	// brush color
+	};
+
+	// find range of a sketch
+	std::vector<Range>::const_iterator findRange(DrawableSprite* drawNode) const;
+
+	// emit triangles of a range to draw buffer
+	void emit(const Range& range);
+
+	std::vector<float>						_vertices;	// x, y of triangle vertices of all sketches
+	std::vector<Range>						_ranges;	// ranges of sketches, by vertex order
+};
+
+#endif	/* __STROKE_MESH_H__ */
@@ -0,0 +1,14 @@
+#include "StrokeStore.h"
+
+USING_NS_CC;
+
+std::vector<Vec2> StrokeStore::toVector() const
+{
+	std::vector<Vec2> result;
+	result.reserve(_points.size());
+	for (int i = 0; i < _points.size(); i++)
+	{
+		result.push_back(_points[i]);
+	}
+	return result;
+}
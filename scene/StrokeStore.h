@@ -0,0 +1,169 @@
+#ifndef __STROKE_STORE_H__
+#define __STROKE_STORE_H__
+
+#include "cocos2d.h"
+#include "geometry/GeometricKernelAdapter.h"
+
+/**
+ * Stroke View
+ * A read-only view of one stroke inside StrokeStore, no points are copied
+ */
+struct StrokeView
+{
+	const float* xs;	// x coordinates of stroke points
+	const float* ys;	// y coordinates of stroke points
+	int size;			// the number of points in stroke
+
+	cocos2d::Vec2 operator[](int i) const
+	{
+		return cocos2d::Vec2(xs[i], ys[i]);
+	}
+
+	cocos2d::Vec2 front() const
+	{
+		return cocos2d::Vec2(xs[0], ys[0]);
+	}
+
+	cocos2d::Vec2 back() const
+	{
+		return cocos2d::Vec2(xs[size - 1], ys[size - 1]);
+	}
+
+	bool empty() const
+	{
+		return size == 0;
+	}
+
+	/**
+	 * Get arc length of stroke, it doesn't depend on how densely points are stored
+	 * @return the sum of segment lengths, 0 if stroke has less than 2 points
+	 */
+	float length() const
+	{
+		float sum = 0;
+		for (int i = 1; i < size; i++)sum += sqrtf((xs[i] - xs[i - 1])*(xs[i] - xs[i - 1]) + (ys[i] - ys[i - 1])*(ys[i] - ys[i - 1]));
+		return sum;
+	}
+};
+
+/**
+ * Stroke Store
+ * Points of all strokes are stored once in a contiguous SoA buffer,
+ * with a table of offsets where each stroke begins
+ * @see GeometricKernel::PointBuffer
+ */
+class StrokeStore
+{
+public:
+
+	/**
+	 * Start a new stroke, following points are added to it
+	 */
+	void beginStroke()
+	{
+		if (_offsets.empty() || _offsets.back() != _points.size())_offsets.push_back(_points.size());
+	}
+
+	/**
+	 * Add a point to current stroke
+	 * @param p	point to be added
+	 */
+	void addPoint(const cocos2d::Vec2& p)
+	{
+		if (_offsets.empty())_offsets.push_back(0);
+		_points.push_back(p);
+	}
+
+	/**
+	 * Add a line segment
+	 * If the line does not start at the last point, a new stroke is started
+	 * @param from	a point the line from
+	 * @param to	a point the line to
+	 */
+	void addSegment(const cocos2d::Vec2& from, const cocos2d::Vec2& to)
+	{
+		if (_points.empty() || back() != from)
+		{
+			beginStroke();
+			addPoint(from);
+		}
+		addPoint(to);
+	}
+
+	/**
+	 * Get the number of strokes
+	 */
+	int strokeCount() const
+	{
+		return (int)_offsets.size();
+	}
+
+	/**
+	 * Get the number of points in all strokes
+	 */
+	int pointCount() const
+	{
+		return _points.size();
+	}
+
+	/**
+	 * Get stroke by index
+	 * @param i	stroke index
+	 * @return	a view of stroke points
+	 */
+	StrokeView stroke(int i) const
+	{
+		int begin = _offsets[i];
+		int end = i + 1 < (int)_offsets.size() ? _offsets[i + 1] : _points.size();
+		StrokeView view = { _points.xs.data() + begin, _points.ys.data() + begin, end - begin };
+		return view;
+	}
+
+	/**
+	 * Get index of the first point of each stroke
+	 */
+	const std::vector<int>& offsets() const
+	{
+		return _offsets;
+	}
+
+	/**
+	 * Get points of all strokes
+	 * @return SoA point buffer
+	 */
+	const GeometricKernel::PointBuffer& points() const
+	{
+		return _points;
+	}
+
+	/**
+	 * Get the last added point
+	 */
+	cocos2d::Vec2 back() const
+	{
+		return _points[_points.size() - 1];
+	}
+
+	bool empty() const
+	{
+		return _points.empty();
+	}
+
+	void clear()
+	{
+		_points.clear();
+		_offsets.clear();
+	}
+
+	/**
+	 * Copy points of all strokes, in drawing order
+	 * @return points
+	 */
+	std::vector<cocos2d::Vec2> toVector() const;
+
+private:
+	GeometricKernel::PointBuffer	_points;	// points of all strokes
+	std::vector<int>				_offsets;	// index of the first point of each stroke
+};
+
+#endif	/* __STROKE_STORE_H__ */
@@ -0,0 +1,99 @@
+#include "geometry/GeometricDecomposition.h"
+#include <cstdio>
+#include <cmath>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Convex Decomposition Test
+ * A concave outline must become several convex pieces covering it, a convex one a single piece,
+ * so sketch bodies built by makePhysicsBodyAsConvexPieces don't collide as their hull.
+ * The interleaved coordinate version is tested, ConvexDecomposition on Vec2 only forwards to it.
+ */
+
+static int failures = 0;
+
+static void Check(bool ok, const char* shape, const char* what)
+{
+	if (ok)return;
+	printf("FAILED: %s: %s\n", shape, what);
+	failures++;
+}
+
+// signed area of points picked by indices, positive if anti-clockwise
+static float SignedArea(const vector<float>& xy, const int* indices, int count)
+{
+	float area = 0;
+	for (int i = 0; i < count; i++)
+	{
+		int a = indices[i], b = indices[(i + 1) % count];
+		area += xy[a * 2] * xy[b * 2 + 1] - xy[b * 2] * xy[a * 2 + 1];
+	}
+	return area / 2;
+}
+
+static void CheckPieces(const char* shape, const vector<float>& outline, int minPieces, int maxPieces)
+{
+	int count = outline.size() / 2;
+	vector<int> indices, offsets;
+	Check(ConvexDecompositionXY(&outline[0], count, indices, offsets), shape, "decomposed");
+	int pieces = (int)offsets.size() - 1;
+	Check(pieces >= minPieces && pieces <= maxPieces, shape, "number of pieces");
+
+	// pieces are clockwise, convex, within vertex budget, and cover the outline
+	vector<int> all(count);
+	for (int i = 0; i < count; i++)all[i] = i;
+	float area = 0;
+	for (int p = 0; p < pieces; p++)
+	{
+		const int* piece = &indices[offsets[p]];
+		int n = offsets[p + 1] - offsets[p];
+		Check(n >= 3 && n <= 8, shape, "piece vertices");
+		Check(SignedArea(outline, piece, n) < 0, shape, "piece is clockwise");
+		bool convex = true;
+		for (int i = 0; i < n; i++)
+		{
+			int a = piece[i], b = piece[(i + 1) % n], c = piece[(i + 2) % n];
+			float turn = (outline[b * 2] - outline[a * 2]) * (outline[c * 2 + 1] - outline[b * 2 + 1])
+				- (outline[b * 2 + 1] - outline[a * 2 + 1]) * (outline[c * 2] - outline[b * 2]);
+			convex = convex && turn <= 0;
+		}
+		Check(convex, shape, "piece is convex");
+		area -= SignedArea(outline, piece, n);
+	}
+	float total = SignedArea(outline, &all[0], count);
+	Check(fabsf(area - total) < 1e-3f * total, shape, "pieces cover outline");
+}
+
+int main()
+{
+	// anti-clockwise outlines, as makeOutlineShape outputs them
+	float square[] = { 0, 0, 100, 0, 100, 100, 0, 100 };
+	CheckPieces("square", vector<float>(square, square + 8), 1, 1);
+
+	float l[] = { 0, 0, 100, 0, 100, 30, 30, 30, 30, 100, 0, 100 };
+	CheckPieces("L shape", vector<float>(l, l + 12), 2, 2);
+
+	float u[] = { 0, 0, 120, 0, 120, 100, 90, 100, 90, 30, 30, 30, 30, 100, 0, 100 };
+	CheckPieces("U shape", vector<float>(u, u + 16), 3, 3);
+
+	// a star is concave at every inner point
+	vector<float> star;
+	for (int i = 0; i < 10; i++)
+	{
+		float a = 6.2831853f * i / 10, r = (i % 2) ? 40.0f : 100.0f;
+		star.push_back(r * cosf(a));
+		star.push_back(r * sinf(a));
+	}
+	CheckPieces("star", star, 2, 8);
+
+	// a stroke too short to be an outline can't be decomposed, caller falls back to convex hull
+	float line[] = { 0, 0, 100, 100 };
+	vector<int> indices, offsets;
+	Check(!ConvexDecompositionXY(line, 2, indices, offsets), "line", "not decomposed");
+
+	if (failures)printf("%d checks failed\n", failures);
+	else printf("all checks passed\n");
+	return failures ? 1 : 0;
+}
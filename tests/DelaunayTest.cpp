@@ -0,0 +1,142 @@
+#include "geometry/delaunay/DivideConquer-Delaunay.h"
+#include "geometry/GeometricHull.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Delaunay Test
+ * Point sets large enough to be split onto worker threads are triangulated by the parallel engine,
+ * the seams must merge to one Delaunay triangulation of the convex hull.
+ * Coordinates are integers below 4096, so the predicates below are exact in doubles.
+ */
+
+#define DELAUNAY_TEST_THREADS 4
+
+static int failures = 0;
+
+static void Check(bool ok, const char* points, const char* what)
+{
+	if (ok)return;
+	printf("FAILED: %s: %s\n", points, what);
+	failures++;
+}
+
+// twice the signed area of triangle a, b, c, positive if anti-clockwise
+static double Orient(const vector<float>& xy, int a, int b, int c)
+{
+	double abx = xy[b * 2] - xy[a * 2], aby = xy[b * 2 + 1] - xy[a * 2 + 1];
+	double acx = xy[c * 2] - xy[a * 2], acy = xy[c * 2 + 1] - xy[a * 2 + 1];
+	return abx*acy - acx*aby;
+}
+
+// positive if point d lies strictly inside the circumcircle of anti-clockwise triangle a, b, c
+static double InCircle(const vector<float>& xy, int a, int b, int c, int d)
+{
+	double adx = xy[a * 2] - xy[d * 2], ady = xy[a * 2 + 1] - xy[d * 2 + 1];
+	double bdx = xy[b * 2] - xy[d * 2], bdy = xy[b * 2 + 1] - xy[d * 2 + 1];
+	double cdx = xy[c * 2] - xy[d * 2], cdy = xy[c * 2 + 1] - xy[d * 2 + 1];
+	return (adx*adx + ady*ady) * (bdx*cdy - cdx*bdy)
+		- (bdx*bdx + bdy*bdy) * (adx*cdy - cdx*ady)
+		+ (cdx*cdx + cdy*cdy) * (adx*bdy - bdx*ady);
+}
+
+static void CheckTriangulation(const char* points, vector<float>& xy)
+{
+	int count = xy.size() / 2;
+	Check(count > 2 * DELAUNAY_PARALLEL_GRAIN, points, "large enough to split");
+
+	int numIndices = 0;
+	WORD* indices = BuildTriangleIndexListParallel(&xy[0], 1.0f, count, 2, 1, &numIndices, DELAUNAY_TEST_THREADS);
+	Check(indices && numIndices > 0 && numIndices % 3 == 0, points, "triangulated");
+	if (!indices)return;
+
+	bool valid = true, clockwise = true, empty = true;
+	double area = 0;
+	for (int t = 0; t < numIndices && valid; t += 3)
+	{
+		int a = indices[t], b = indices[t + 1], c = indices[t + 2];
+		valid = a < count && b < count && c < count;
+		if (!valid)break;
+		double orient = Orient(xy, a, b, c);
+		clockwise = clockwise && orient < 0;
+		area -= orient / 2;
+
+		// b and c swapped, InCircle wants anti-clockwise triangles
+		for (int p = 0; p < count && empty; p++)
+		{
+			if (p == a || p == b || p == c)continue;
+			empty = InCircle(xy, a, c, b, p) <= 0;
+		}
+	}
+	Check(valid, points, "indices in range");
+	Check(clockwise, points, "every triangle is clockwise");
+	Check(empty, points, "circumcircles are empty");
+
+	// triangles cover the convex hull, hull points are clockwise
+	vector<int> hull(count);
+	int numHull = ConvexHullXY(&xy[0], count, &hull[0]);
+	double hullArea = 0;
+	for (int i = 0; i < numHull; i++)
+	{
+		int a = hull[i], b = hull[(i + 1) % numHull];
+		hullArea -= ((double)xy[a * 2] * xy[b * 2 + 1] - (double)xy[b * 2] * xy[a * 2 + 1]) / 2;
+	}
+	Check(area == hullArea, points, "triangles cover the hull");
+
+	// the same triangulation is found without splitting, up to the choice of cocircular diagonals
+	int serialIndices = 0;
+	WORD* serial = BuildTriangleIndexListParallel(&xy[0], 1.0f, count, 2, 1, &serialIndices, 1);
+	Check(serialIndices == numIndices, points, "same triangle count as serial");
+	free(serial);
+	free(indices);
+}
+
+int main()
+{
+	mt19937 rng(1);
+
+	// uniform random points, duplicates are merged
+	vector<float> random;
+	uniform_int_distribution<int> coordinate(0, 2000);
+	for (int i = 0; i < 2000; i++)
+	{
+		random.push_back((float)coordinate(rng));
+		random.push_back((float)coordinate(rng));
+	}
+	CheckTriangulation("random", random);
+
+	// every grid cell has 4 cocircular corners, either diagonal is Delaunay
+	vector<float> grid;
+	for (int y = 0; y < 40; y++)
+	{
+		for (int x = 0; x < 40; x++)
+		{
+			grid.push_back(x * 50.0f);
+			grid.push_back(y * 50.0f);
+		}
+	}
+	CheckTriangulation("grid", grid);
+
+	// dense clusters with empty space between them, as stippled outlines
+	vector<float> clustered;
+	normal_distribution<float> spread(0, 30);
+	for (int c = 0; c < 6; c++)
+	{
+		float cx = 300.0f + 700 * (c % 3), cy = 400.0f + 1000 * (c / 3);
+		for (int i = 0; i < 250; i++)
+		{
+			clustered.push_back(floorf(cx + spread(rng) + 0.5f));
+			clustered.push_back(floorf(cy + spread(rng) + 0.5f));
+		}
+	}
+	CheckTriangulation("clustered", clustered);
+
+	if (failures)printf("%d checks failed\n", failures);
+	else printf("all checks passed\n");
+	return failures ? 1 : 0;
+}
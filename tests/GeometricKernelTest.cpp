@@ -0,0 +1,214 @@
+#include "geometry/GeometricKernel.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cfloat>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Geometric Kernel Test
+ * Every kernel is compared with a plain scalar reference on sizes around the SIMD width,
+ * so both the vector loop and the remainder lanes are covered.
+ * The same source is built for every instruction set the compiler supports, see CMakeLists.txt.
+ */
+
+// relative tolerance, vector lanes sum in a different order than the scalar reference
+#define KERNEL_TEST_TOLERANCE 1e-5f
+// returned when the CPU can't run the instruction set this test was built for
+#define KERNEL_TEST_SKIPPED 77
+
+static int failures = 0;
+
+static void Check(bool ok, const char* kernel, int count, const char* what)
+{
+	if (ok)return;
+	printf("FAILED: %s, count %d: %s\n", kernel, count, what);
+	failures++;
+}
+
+static bool Near(float a, float b)
+{
+	if (a == b)return true;
+	return fabsf(a - b) <= KERNEL_TEST_TOLERANCE * fmaxf(1.0f, fmaxf(fabsf(a), fabsf(b)));
+}
+
+namespace Reference
+{
+	float PerpendicularDistance(float x, float y, float bx, float by, float ex, float ey)
+	{
+		float dx = ex - bx, dy = ey - by;
+		float len = sqrtf(dx*dx + dy*dy);
+		if (len == 0)return sqrtf((x - bx)*(x - bx) + (y - by)*(y - by));
+		return fabsf(dx*(y - by) - dy*(x - bx)) / len;
+	}
+
+	float SignedArea(const float* xs, const float* ys, int count)
+	{
+		if (count < 3)return 0;
+		double area = 0;
+		for (int i = 0; i < count; i++)
+		{
+			int j = (i + 1) % count;
+			area += (double)xs[i] * ys[j] - (double)xs[j] * ys[i];
+		}
+		return (float)(area / 2);
+	}
+
+	bool PointInPolygon(const float* xs, const float* ys, int count, float px, float py)
+	{
+		bool inside = false;
+		for (int i = 0, j = count - 1; i < count; j = i++)
+		{
+			if ((ys[i] > py) != (ys[j] > py) && px < xs[i] + (py - ys[i]) * (xs[j] - xs[i]) / (ys[j] - ys[i]))inside = !inside;
+		}
+		return count >= 3 && inside;
+	}
+
+	float SegmentDistance(float px, float py, float ax, float ay, float bx, float by)
+	{
+		float dx = bx - ax, dy = by - ay, qx = px - ax, qy = py - ay;
+		float len2 = dx*dx + dy*dy;
+		float t = len2 > FLT_MIN ? (qx*dx + qy*dy) / len2 : 0;
+		t = t < 0 ? 0 : (t > 1 ? 1 : t);
+		return sqrtf((qx - t*dx)*(qx - t*dx) + (qy - t*dy)*(qy - t*dy));
+	}
+}
+
+// a star shaped polygon, so points are neither sorted nor convex
+static void MakePoints(int count, vector<float>& xs, vector<float>& ys)
+{
+	xs.resize(count);
+	ys.resize(count);
+	for (int i = 0; i < count; i++)
+	{
+		float a = 6.2831853f * i / (count > 0 ? count : 1);
+		float r = (i % 2) ? 40.0f : 100.0f + (float)(rand() % 1000) / 100;
+		xs[i] = 200 + r * cosf(a);
+		ys[i] = 150 + r * sinf(a);
+	}
+}
+
+static void TestDistances(int count, const float* xs, const float* ys)
+{
+	vector<float> out(count + 1, -1.0f);
+	const float lines[2][4] = { { 10, 20, 300, 250 }, { 50, 60, 50, 60 } };
+	for (int l = 0; l < 2; l++)
+	{
+		const float* e = lines[l];
+		GeometricKernel::PerpendicularDistances(xs, ys, count, e[0], e[1], e[2], e[3], out.data());
+		bool ok = out[count] == -1.0f;
+		for (int i = 0; i < count; i++)ok = ok && Near(out[i], Reference::PerpendicularDistance(xs[i], ys[i], e[0], e[1], e[2], e[3]));
+		Check(ok, "PerpendicularDistances", count, l ? "degenerated line" : "line");
+
+		float dmax = -1, best = 0;
+		int idx = GeometricKernel::MaxPerpendicularDistance(xs, ys, count, e[0], e[1], e[2], e[3], &dmax);
+		int expected = -1;
+		for (int i = 0; i < count; i++)
+		{
+			float d = Reference::PerpendicularDistance(xs[i], ys[i], e[0], e[1], e[2], e[3]);
+			if (d > best || expected < 0)
+			{
+				best = d;
+				expected = i;
+			}
+		}
+		Check(idx == expected, "MaxPerpendicularDistance", count, l ? "index, degenerated line" : "index");
+		Check(Near(dmax, best), "MaxPerpendicularDistance", count, "distance");
+	}
+
+	GeometricKernel::Distances(xs, ys, count, 120, 80, out.data());
+	bool ok = out[count] == -1.0f;
+	for (int i = 0; i < count; i++)ok = ok && Near(out[i], sqrtf((xs[i] - 120)*(xs[i] - 120) + (ys[i] - 80)*(ys[i] - 80)));
+	Check(ok, "Distances", count, "distances");
+
+	float dmin, dmax;
+	GeometricKernel::DistanceRange(xs, ys, count, 120, 80, &dmin, &dmax);
+	float lo = FLT_MAX, hi = 0;
+	for (int i = 0; i < count; i++)
+	{
+		float d = sqrtf((xs[i] - 120)*(xs[i] - 120) + (ys[i] - 80)*(ys[i] - 80));
+		lo = fminf(lo, d);
+		hi = fmaxf(hi, d);
+	}
+	Check(Near(dmin, lo) && Near(dmax, hi), "DistanceRange", count, "range");
+
+	GeometricKernel::Orientations(xs, ys, count, 10, 20, 300, 250, out.data());
+	ok = out[count] == -1.0f;
+	for (int i = 0; i < count; i++)ok = ok && Near(out[i], 290 * (ys[i] - 20) - 230 * (xs[i] - 10));
+	Check(ok, "Orientations", count, "orientations");
+}
+
+static void TestAggregates(int count, const float* xs, const float* ys)
+{
+	// bounding box & centroid need at least one point
+	if (count > 0)
+	{
+		float x0, y0, x1, y1;
+		GeometricKernel::BoundingBox(xs, ys, count, &x0, &y0, &x1, &y1);
+		float rx0 = xs[0], ry0 = ys[0], rx1 = xs[0], ry1 = ys[0];
+		for (int i = 1; i < count; i++)
+		{
+			rx0 = fminf(rx0, xs[i]); rx1 = fmaxf(rx1, xs[i]);
+			ry0 = fminf(ry0, ys[i]); ry1 = fmaxf(ry1, ys[i]);
+		}
+		Check(x0 == rx0 && y0 == ry0 && x1 == rx1 && y1 == ry1, "BoundingBox", count, "box");
+
+		float cx, cy;
+		double sx = 0, sy = 0;
+		GeometricKernel::Centroid(xs, ys, count, &cx, &cy);
+		for (int i = 0; i < count; i++)
+		{
+			sx += xs[i];
+			sy += ys[i];
+		}
+		Check(Near(cx, (float)(sx / count)) && Near(cy, (float)(sy / count)), "Centroid", count, "centroid");
+	}
+
+	Check(Near(GeometricKernel::SignedArea(xs, ys, count), Reference::SignedArea(xs, ys, count)), "SignedArea", count, "area");
+
+	// inside the inner ring, between the rings, and far outside
+	const float probes[3][2] = { { 200, 150 }, { 270, 155 }, { 1000, 1000 } };
+	for (int p = 0; p < 3; p++)
+	{
+		float px = probes[p][0], py = probes[p][1];
+		Check(GeometricKernel::PointInPolygon(xs, ys, count, px, py) == Reference::PointInPolygon(xs, ys, count, px, py),
+			"PointInPolygon", count, "inside");
+
+		float best = FLT_MAX;
+		if (count == 1)best = sqrtf((xs[0] - px)*(xs[0] - px) + (ys[0] - py)*(ys[0] - py));
+		for (int i = 0; i + 1 < count; i++)best = fminf(best, Reference::SegmentDistance(px, py, xs[i], ys[i], xs[i + 1], ys[i + 1]));
+		Check(Near(GeometricKernel::MinDistanceToPolyline(xs, ys, count, px, py), best), "MinDistanceToPolyline", count, "distance");
+	}
+}
+
+int main()
+{
+#if defined(GEOMETRIC_KERNEL_AVX2) && (defined(__GNUC__) || defined(__clang__))
+	if (!__builtin_cpu_supports("avx2"))
+	{
+		printf("skipped, CPU has no AVX2\n");
+		return KERNEL_TEST_SKIPPED;
+	}
+#endif
+	printf("simd width %d\n", (int)GeometricKernel::simd::WIDTH);
+
+	// empty, single point, around one and several vector widths
+	const int sizes[] = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 33 };
+	srand(1);
+	for (int s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); s++)
+	{
+		vector<float> xs, ys;
+		MakePoints(sizes[s], xs, ys);
+		// one spare element, kernels must not touch points past count
+		xs.push_back(NAN);
+		ys.push_back(NAN);
+		TestDistances(sizes[s], xs.data(), ys.data());
+		TestAggregates(sizes[s], xs.data(), ys.data());
+	}
+
+	if (failures)printf("%d checks failed\n", failures);
+	else printf("all checks passed\n");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,168 @@
+#include "geometry/KinematicsSolver.h"
+#include <cstdio>
+#include <cmath>
+#include <cfloat>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Kinematics Solver Test
+ * The lesson scenarios are solved against their textbook closed forms, a block on a plane,
+ * a block on an incline and free motion in vacuum, and motions end where bodies meet.
+ * Gravity is 100 world units/s^2, static bodies have friction 1 like MaterialTable.
+ */
+
+#define KINEMATICS_TEST_TOLERANCE 1e-3f
+#define KINEMATICS_TEST_GRAVITY 100.0f
+
+static int failures = 0;
+
+static void Check(bool ok, const char* scenario, const char* what)
+{
+	if (ok)return;
+	printf("FAILED: %s: %s\n", scenario, what);
+	failures++;
+}
+
+static bool Near(float a, float b)
+{
+	return fabsf(a - b) <= KINEMATICS_TEST_TOLERANCE * fmaxf(1.0f, fmaxf(fabsf(a), fabsf(b)));
+}
+
+static KinematicBody MakeBody(bool isStatic, const float* points, int count)
+{
+	KinematicBody body = {};
+	body.isStatic = isStatic;
+	body.polygons.push_back(vector<float>(points, points + count * 2));
+	body.mass = isStatic ? 0 : 1;
+	body.friction = 1;
+	return body;
+}
+
+static KinematicBody MakeBox(float x, float y, float size)
+{
+	float points[] = { x, y, x + size, y, x + size, y + size, x, y + size };
+	return MakeBody(false, points, 4);
+}
+
+// v(t) = v0 - ug*t until the block stops, then 0
+static void TestPlane()
+{
+	const float ground[] = { 0, 0, 800, 0, 800, 20, 0, 20 };
+	const float v0 = 50, friction = 0.3f;
+	vector<KinematicBody> bodies;
+	bodies.push_back(MakeBody(true, ground, 4));
+	bodies.push_back(MakeBox(100, 20, 20));
+	bodies[1].vx = v0;
+	bodies[1].friction = friction;
+
+	KinematicsSolver solver(0, -KINEMATICS_TEST_GRAVITY);
+	Check(solver.solve(bodies, 3), "plane", "solved");
+	Check(solver.getMotionCount() == 1, "plane", "one motion");
+	const KinematicMotion& m = solver.getMotion(0);
+	Check(m.type == KINEMATICS_PLANE, "plane", "sliding on plane");
+	float stop = v0 / (friction * KINEMATICS_TEST_GRAVITY);
+	Check(Near(m.t1, stop), "plane", "stops at v0/ug");
+	for (float t = 0; t <= 3; t += 0.25f)
+	{
+		float vx, vy, dx, dy;
+		m.velocity(t, vx, vy);
+		m.displacement(t, dx, dy);
+		float expected = t < stop ? v0 - friction * KINEMATICS_TEST_GRAVITY * t : 0;
+		float distance = t < stop ? v0 * t - friction * KINEMATICS_TEST_GRAVITY * t * t / 2 : v0 * stop / 2;
+		Check(Near(vx, expected) && Near(vy, 0), "plane", "velocity");
+		Check(Near(dx, distance) && Near(dy, 0), "plane", "displacement");
+	}
+}
+
+// a = g(sin - u cos) down the slope, a block held by friction stays still
+static void TestIncline()
+{
+	// slope of a 3-4-5 triangle, sin = 0.6, cos = 0.8
+	const float wedge[] = { 0, 0, 400, 0, 0, 300 };
+	const float sine = 0.6f, cosine = 0.8f;
+	const float frictions[] = { 0.25f, 1.0f };
+	for (int f = 0; f < 2; f++)
+	{
+		// square lying on the slope, 200 units down from the top
+		float tx = cosine, ty = -sine, nx = sine, ny = cosine;
+		float px = 200 * tx, py = 300 + 200 * ty;
+		float block[] = { px, py, px + 20 * tx, py + 20 * ty, px + 20 * (tx + nx), py + 20 * (ty + ny), px + 20 * nx, py + 20 * ny };
+		vector<KinematicBody> bodies;
+		bodies.push_back(MakeBody(true, wedge, 3));
+		bodies.push_back(MakeBody(false, block, 4));
+		bodies[1].friction = frictions[f];
+
+		KinematicsSolver solver(0, -KINEMATICS_TEST_GRAVITY);
+		Check(solver.solve(bodies, 1), "incline", "solved");
+		const KinematicMotion& m = solver.getMotion(0);
+		Check(m.type == KINEMATICS_INCLINE, "incline", "sliding on incline");
+		Check(Near(m.tx, tx) && Near(m.ty, ty), "incline", "surface points downhill");
+		float a = KINEMATICS_TEST_GRAVITY * (sine - frictions[f] * cosine);
+		if (a < 0)a = 0;
+		Check(Near(m.a1, a), "incline", "acceleration");
+		float vx, vy;
+		m.velocity(1, vx, vy);
+		Check(Near(vx, a * tx) && Near(vy, a * ty), "incline", "velocity");
+	}
+}
+
+// constant acceleration g + F/m, nothing touched
+static void TestVacuum()
+{
+	vector<KinematicBody> bodies;
+	bodies.push_back(MakeBox(0, 0, 20));
+	bodies[0].mass = 2;
+	bodies[0].vx = 3;
+	bodies[0].vy = 4;
+	bodies[0].fx = 10;
+
+	KinematicsSolver solver(0, -KINEMATICS_TEST_GRAVITY);
+	Check(solver.solve(bodies, 2), "vacuum", "solved");
+	const KinematicMotion& m = solver.getMotion(0);
+	Check(m.type == KINEMATICS_VACUUM, "vacuum", "free motion");
+	Check(Near(m.ax, 5) && Near(m.ay, -KINEMATICS_TEST_GRAVITY), "vacuum", "acceleration");
+	float vx, vy, dx, dy;
+	m.velocity(2, vx, vy);
+	m.displacement(2, dx, dy);
+	Check(Near(vx, 13) && Near(vy, 4 - 2 * KINEMATICS_TEST_GRAVITY), "vacuum", "velocity");
+	Check(Near(dx, 16) && Near(dy, 8 - 2 * KINEMATICS_TEST_GRAVITY), "vacuum", "displacement");
+	Check(Near(solver.getValidUntil(), 2), "vacuum", "valid over duration");
+}
+
+// two blocks closing an 80 unit gap at 200 units/s meet at 0.4s
+static void TestValidUntil()
+{
+	vector<KinematicBody> bodies;
+	bodies.push_back(MakeBox(0, 0, 20));
+	bodies.push_back(MakeBox(100, 0, 20));
+	bodies[0].vx = 100;
+	bodies[1].vx = -100;
+
+	KinematicsSolver solver(0, 0);
+	Check(!solver.solve(bodies, 1), "meet", "not exact over duration");
+	float validUntil = solver.getValidUntil();
+	Check(validUntil >= 0.38f && validUntil <= 0.42f, "meet", "valid until bodies meet");
+	Check(Near(solver.getMotion(0).validUntil, solver.getMotion(1).validUntil), "meet", "both motions end");
+
+	// a body without closed form makes every motion inexact
+	const float ground[] = { -500, -5, 500, -5, 500, 0, -500, 0 };
+	bodies.push_back(MakeBody(true, ground, 4));
+	bodies[0].vy = -100;
+	Check(!solver.solve(bodies, 1), "meet", "hitting ground has no closed form");
+	Check(solver.getMotion(0).type == KINEMATICS_NONE, "meet", "no closed form");
+	Check(solver.getValidUntil() == 0, "meet", "nothing is exact");
+}
+
+int main()
+{
+	TestPlane();
+	TestIncline();
+	TestVacuum();
+	TestValidUntil();
+
+	if (failures)printf("%d checks failed\n", failures);
+	else printf("all checks passed\n");
+	return failures ? 1 : 0;
+}
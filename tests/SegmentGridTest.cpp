@@ -0,0 +1,44 @@
+#include "geometry/SegmentGrid.h"
+#include <cstdio>
+#include <cmath>
+#include <cfloat>
+
+/**
+ * Segment Grid Test
+ * Hit tests of a multi-stroke sketch, the jump from one stroke to the next must not be a segment,
+ * only closed strokes enclose points.
+ */
+
+static int failures = 0;
+
+static void Check(bool ok, const char* what)
+{
+	if (ok)return;
+	printf("FAILED: %s\n", what);
+	failures++;
+}
+
+int main()
+{
+	// two open lines, a closed square with a small gap, and a tap
+	const float xs[] = { 0, 50, 100, 0, 50, 100, 200, 300, 300, 200, 205, 400 };
+	const float ys[] = { 0, 0, 0, 100, 100, 100, 0, 0, 100, 100, 5, 400 };
+	const int offsets[] = { 0, 3, 6, 11 };
+	SegmentGrid grid;
+	grid.build(xs, ys, 12, offsets, 4, 30);
+	Check(grid.pointCount() == 12 && grid.lineCount() == 4, "counts");
+
+	// the jump from (100, 0) to (0, 100) crosses (50, 50)
+	Check(grid.minDistance(50, 50, 10) == FLT_MAX, "no segment between strokes");
+	Check(!grid.pointInPolygon(50, 50), "open strokes enclose nothing");
+	Check(fabsf(grid.minDistance(50, 5, 10) - 5) < 1e-4f, "distance to open stroke");
+
+	Check(grid.pointInPolygon(250, 50), "closed stroke encloses");
+	Check(!grid.pointInPolygon(150, 50), "between strokes is outside");
+	Check(grid.minDistance(202, 3, 1) == FLT_MAX, "closing segment is not measured");
+	Check(fabsf(grid.minDistance(403, 400, 10) - 3) < 1e-4f, "single point stroke");
+
+	if (failures)printf("%d checks failed\n", failures);
+	else printf("all checks passed\n");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,56 @@
+#ifndef __ADAPTIVE_SUBSTEPS_H__
+#define __ADAPTIVE_SUBSTEPS_H__
+
+#include <cfloat>
+#include <cmath>
+
+#define SUBSTEP_MAX_DISPLACEMENT 0.25f	// max displacement per substep, fraction of body thickness
+#define SUBSTEP_MIN_THICKNESS 1.0f		// thinner bodies are treated as this thick, in world units
+#define MAX_ADAPTIVE_SUBSTEPS 16
+
+/**
+ * Get thickness of a polygon, the smallest width over its edge normals
+ * It's exact for a convex polygon, never thinner than the convex hull otherwise
+ * @param xy	vertices x0,y0,x1,y1...
+ * @param count	the number of vertices
+ * @return		thickness, 0 if there are less than 3 vertices
+ */
+inline float PolygonThickness(const float* xy, int count)
+{
+	if (count < 3)return 0;
+	float thickness = FLT_MAX;
+	for (int i = 0; i < count; i++)
+	{
+		int j = (i + 1) % count;
+		float nx = xy[i * 2 + 1] - xy[j * 2 + 1], ny = xy[j * 2] - xy[i * 2];
+		float length = sqrtf(nx * nx + ny * ny);
+		if (length <= 0)continue;
+		float lo = FLT_MAX, hi = -FLT_MAX;
+		for (int k = 0; k < count; k++)
+		{
+			float d = (xy[k * 2] * nx + xy[k * 2 + 1] * ny) / length;
+			lo = fminf(lo, d);
+			hi = fmaxf(hi, d);
+		}
+		thickness = fminf(thickness, hi - lo);
+	}
+	return thickness == FLT_MAX ? 0 : thickness;
+}
+
+/**
+ * Get substeps a body needs, so it moves less than a fraction of its thickness per substep
+ * and can not pass through a surface between two substeps
+ * @param speed		body speed, in world units per second
+ * @param thickness	body thickness, in world units
+ * @param timestep	fixed timestep, in seconds
+ * @return			substeps in [1, MAX_ADAPTIVE_SUBSTEPS]
+ */
+inline int AdaptiveSubsteps(float speed, float thickness, float timestep)
+{
+	float limit = SUBSTEP_MAX_DISPLACEMENT * fmaxf(thickness, SUBSTEP_MIN_THICKNESS);
+	float substeps = ceilf(speed * timestep / limit);
+	if (!(substeps > 1))return 1;
+	return substeps < MAX_ADAPTIVE_SUBSTEPS ? (int)substeps : MAX_ADAPTIVE_SUBSTEPS;
+}
+
+#endif	/* __ADAPTIVE_SUBSTEPS_H__ */
@@ -0,0 +1,46 @@
+#ifndef __PARALLEL_FOR_H__
+#define __PARALLEL_FOR_H__
+
+#include <thread>
+#include <atomic>
+#include <vector>
+
+/**
+ * Run body(i) for every i in [begin, end) on worker threads
+ * Indices are handed out one by one from a shared counter, so uneven work is balanced.
+ * The calling thread works as well, and returns when all indices are done.
+ * body must be safe to call concurrently for different indices.
+ * @param begin			the first index
+ * @param end			one past the last index
+ * @param body			function called with an int index
+ * @param numThreads	max number of threads including the caller, 0 for hardware concurrency
+ */
+template <typename Body>
+void ParallelFor(int begin, int end, Body body, int numThreads = 0)
+{
+	int count = end - begin;
+	if (count <= 0)return;
+	if (numThreads <= 0)numThreads = (int)std::thread::hardware_concurrency();
+	if (numThreads > count)numThreads = count;
+
+	// not worth a thread
+	if (numThreads <= 1)
+	{
+		for (int i = begin; i < end; i++)body(i);
+		return;
+	}
+
+	std::atomic<int> next(begin);
+	auto work = [&]()
+	{
+		for (int i = next++; i < end; i = next++)body(i);
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve(numThreads - 1);
+	for (int t = 1; t < numThreads; t++)workers.push_back(std::thread(work));
+	work();
+	for (auto t = workers.begin(); t != workers.end(); t++)t->join();
+}
+
+#endif	/* __PARALLEL_FOR_H__ */
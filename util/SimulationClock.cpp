@@ -0,0 +1,68 @@
+#include "SimulationClock.h"
+
+using namespace std;
+
+SimulationClock::SimulationClock(float timestep, int substeps)
+:_timestep(timestep)
+, _substeps(substeps < 1 ? 1 : substeps)
+, _timeScale(1)
+, _paused(false)
+, _accumulator(0)
+, _steps(0)
+, _last(Clock::now())
+{
+}
+
+void SimulationClock::start()
+{
+	_accumulator = 0;
+	_steps = 0;
+	_last = Clock::now();
+}
+
+void SimulationClock::accumulate()
+{
+	auto now = Clock::now();
+	if (!_paused)_accumulator += chrono::duration<double>(now - _last).count() * _timeScale;
+	_last = now;
+}
+
+int SimulationClock::advance()
+{
+	accumulate();
+	int steps = (int)(_accumulator / _timestep);
+	if (steps > SIMULATION_MAX_STEPS_PER_FRAME)
+	{
+		steps = SIMULATION_MAX_STEPS_PER_FRAME;
+		_accumulator = 0;
+	}
+	else
+	{
+		_accumulator -= steps * (double)_timestep;
+	}
+	return steps;
+}
+
+void SimulationClock::pause()
+{
+	if (_paused)return;
+	// keep time elapsed before pause, simulated on resume
+	accumulate();
+	_paused = true;
+}
+
+void SimulationClock::resume()
+{
+	if (!_paused)return;
+	_paused = false;
+	_last = Clock::now();
+}
+
+void SimulationClock::setTimeScale(float scale)
+{
+	// accumulate elapsed time with the old scale first
+	accumulate();
+	if (scale < SIMULATION_MIN_TIME_SCALE)scale = SIMULATION_MIN_TIME_SCALE;
+	if (scale > SIMULATION_MAX_TIME_SCALE)scale = SIMULATION_MAX_TIME_SCALE;
+	_timeScale = scale;
+}
@@ -0,0 +1,148 @@
+#ifndef __SIMULATION_CLOCK_H__
+#define __SIMULATION_CLOCK_H__
+
+#include <chrono>
+
+#define SIMULATION_TIMESTEP 0.01f
+#define SIMULATION_SUBSTEPS 1
+#define SIMULATION_MAX_STEPS_PER_FRAME 12
+#define SIMULATION_MIN_TIME_SCALE 0.125f
+#define SIMULATION_MAX_TIME_SCALE 8.0f
+#define SIMULATION_SLEEP_IDLE_SPEED 1.0f	// bodies slower than this are idle, in world units per second
+#define SIMULATION_SLEEP_TIME 0.5f			// bodies idle for this long fall asleep, in simulated seconds
+
+/**
+ * Simulation Clock
+ * Wall time is measured with steady_clock, scaled, and accumulated into whole fixed timesteps,
+ * physics is stepped by the timestep only, so results do not depend on frame rate or load.
+ * Simulated time is the number of steps times the timestep, time spent paused is never accumulated.
+ */
+class SimulationClock
+{
+public:
+
+	/**
+	 * Constructor
+	 * @param timestep	fixed physics timestep, in seconds
+	 * @param substeps	physics substeps per timestep
+	 */
+	SimulationClock(float timestep = SIMULATION_TIMESTEP, int substeps = SIMULATION_SUBSTEPS);
+
+	/**
+	 * Restart at t=0, the clock keeps its paused state, timestep, substeps and time scale
+	 */
+	void start();
+
+	/**
+	 * Accumulate wall time elapsed since last call
+	 * At most SIMULATION_MAX_STEPS_PER_FRAME steps are returned, the rest of backlog is dropped,
+	 * so a long stall slows simulation down instead of stalling the next frames too
+	 * @return number of fixed steps to be simulated now
+	 */
+	int advance();
+
+	/**
+	 * Mark a step as simulated, simulated time goes forward by one timestep
+	 */
+	void step()
+	{
+		_steps++;
+	}
+
+	/**
+	 * Pause, wall time is not accumulated until resumed
+	 */
+	void pause();
+
+	/**
+	 * Resume, wall time is accumulated from now on
+	 */
+	void resume();
+
+	/**
+	 * Check if clock is paused
+	 */
+	bool isPaused() const
+	{
+		return _paused;
+	}
+
+	/**
+	 * Set time scale, 1 for real time, < 1 for slow motion, > 1 for fast forward
+	 * @param scale	time scale, clamped to [SIMULATION_MIN_TIME_SCALE, SIMULATION_MAX_TIME_SCALE]
+	 */
+	void setTimeScale(float scale);
+
+	/**
+	 * Get time scale
+	 */
+	float getTimeScale() const
+	{
+		return _timeScale;
+	}
+
+	/**
+	 * Set physics substeps per timestep, GameLayer splits every fixed step into this many world steps
+	 * @param substeps	substeps, at least 1
+	 */
+	void setSubsteps(int substeps)
+	{
+		_substeps = substeps < 1 ? 1 : substeps;
+	}
+
+	/**
+	 * Get physics substeps per timestep
+	 */
+	int getSubsteps() const
+	{
+		return _substeps;
+	}
+
+	/**
+	 * Get fixed physics timestep, in seconds
+	 */
+	float getTimestep() const
+	{
+		return _timestep;
+	}
+
+	/**
+	 * Get simulated time, in seconds
+	 */
+	double getTime() const
+	{
+		return _steps * (double)_timestep;
+	}
+
+	/**
+	 * Get number of simulated steps
+	 */
+	long long getSteps() const
+	{
+		return _steps;
+	}
+
+	/**
+	 * Get fraction of a timestep left in accumulator, for interpolation between steps
+	 */
+	float getAlpha() const
+	{
+		return (float)(_accumulator / _timestep);
+	}
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	// add scaled wall time elapsed since last call to accumulator, nothing is added if paused
+	void accumulate();
+
+	float				_timestep;		// fixed physics timestep, in seconds
+	int					_substeps;		// physics substeps per timestep
+	float				_timeScale;		// simulated seconds per wall second
+	bool				_paused;		// true if wall time is not accumulated
+	double				_accumulator;	// scaled wall time not simulated yet, in seconds
+	long long			_steps;			// simulated steps since start
+	Clock::time_point	_last;			// wall time of last advance/resume
+};
+
+#endif	/* __SIMULATION_CLOCK_H__ */